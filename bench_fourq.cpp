@@ -0,0 +1,585 @@
+#include "benchmark/benchmark.h"
+#include "fourq.hpp"
+#include "fourq_async_verifier.hpp"
+#include "fourq_batch_engine.hpp"
+#include "fourq_kex.hpp"
+#include "fourq_keystore.hpp"
+#include "fourq_random.hpp"
+#include "fourq_sha512.hpp"
+#include "fourq_soa.hpp"
+#include <array>
+#include <cstdio>
+#include <future>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 性能基准（Google Benchmark）。输出 ns/op 与 items_per_second（ops/s），
+// JSON 结果：fastecc_bench --benchmark_out=bench.json --benchmark_out_format=json
+// （或 cmake --build <dir> --target fastecc_bench_json）
+
+namespace {
+
+using Curve::FourQ::EccDataType;
+using Curve::FourQ::Point;
+using Curve::FourQ::Scalar;
+
+Scalar RandomScalar() {
+    EccDataType raw;
+    ::random_bytes(raw.data(), 32);
+    return Scalar(raw);
+}
+
+std::vector<uint8_t> RandomMessage(size_t len) {
+    std::vector<uint8_t> msg(len);
+    ::random_bytes(msg.data(), (unsigned int)len);
+    return msg;
+}
+
+// 线程扩展测试的上限：硬件线程数（至少 1）
+int MaxThreads() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : (int)n;
+}
+
+// --- Scalar ---
+
+void BM_ScalarAdd(benchmark::State& state) {
+    Scalar a = RandomScalar(), b = RandomScalar();
+    for (auto _ : state) {
+        a = a + b;
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarAdd);
+
+void BM_ScalarMul(benchmark::State& state) {
+    Scalar a = RandomScalar(), b = RandomScalar();
+    for (auto _ : state) {
+        a = a * b;
+        benchmark::DoNotOptimize(a);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarMul);
+
+void BM_ScalarDiv(benchmark::State& state) {
+    Scalar a = RandomScalar(), b = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(a / b);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarDiv);
+
+void BM_ScalarInvert(benchmark::State& state) {
+    Scalar a = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Scalar::invert(a));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarInvert);
+
+// 32 字节随机数：0 = FourQlib random_bytes（每次读 /dev/urandom），1 = 每线程 ChaCha20 缓冲
+void BM_RandomBytes(benchmark::State& state) {
+    std::array<uint8_t, 32> out{};
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            ::random_bytes(out.data(), (unsigned int)out.size());
+        } else {
+            Curve::FourQ::randomBytes(out);
+        }
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * (int64_t)out.size());
+}
+BENCHMARK(BM_RandomBytes)->DenseRange(0, 1);
+
+void BM_ScalarRandom(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Scalar::random());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarRandom);
+
+// --- Point ---
+
+void BM_PointAdd(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    Point q = Point::mulBase(RandomScalar());
+    for (auto _ : state) {
+        p += q;
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointAdd);
+
+void BM_PointSub(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    Point q = Point::mulBase(RandomScalar());
+    for (auto _ : state) {
+        p -= q;
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointSub);
+
+void BM_PointNegate(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Point::negate(p));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointNegate);
+
+void BM_PointDbl(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    for (auto _ : state) {
+        p.dbl();
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointDbl);
+
+// 缓存加数：0 = R2 形式（eccadd），1 = 仿射形式（混合加法 eccmadd）
+void BM_PointAddCached(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    Point q = Point::mulBase(RandomScalar()) + Point::mulBase(RandomScalar()); // Z != 1
+    Curve::FourQ::AddendCache c = state.range(0) ? Curve::FourQ::AddendCache::affine(q) : Curve::FourQ::AddendCache(q);
+    for (auto _ : state) {
+        p += c;
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointAddCached)->Arg(0)->Arg(1);
+
+void BM_PointMul(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    Scalar k = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(k * p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointMul);
+
+void BM_PointMulBase(benchmark::State& state) {
+    Scalar k = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Point::mulBase(k));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointMulBase);
+
+void BM_PointMulAdd(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    Scalar a = RandomScalar(), b = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p.MulAdd(a, b));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointMulAdd);
+
+void BM_PointGetRaw(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar()) + Point::mulBase(RandomScalar()); // 射影坐标，Z != 1
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(p.getRaw());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointGetRaw);
+
+void BM_PointFromString(benchmark::State& state) {
+    std::string hex = Point::mulBase(RandomScalar()).toString();
+    Point p;
+    for (auto _ : state) {
+        p.fromString(hex);
+        benchmark::DoNotOptimize(p);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointFromString);
+
+void BM_PointToHex(benchmark::State& state) {
+    Point p = Point::mulBase(RandomScalar());
+    char hex[Curve::FourQ::kHexLength];
+    for (auto _ : state) {
+        p.toHex(hex);
+        benchmark::DoNotOptimize(hex);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PointToHex);
+
+void BM_ScalarHexRoundTrip(benchmark::State& state) {
+    Scalar k = RandomScalar();
+    char hex[Curve::FourQ::kHexLength];
+    for (auto _ : state) {
+        k.toHex(hex);
+        k.fromHex(std::string_view(hex, sizeof(hex)));
+        benchmark::DoNotOptimize(k);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ScalarHexRoundTrip);
+
+void BM_PointMultiMul(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    Curve::FourQ::Scalars ks;
+    Curve::FourQ::Points ps;
+    for (size_t i = 0; i < n; i++) {
+        ks.push_back(RandomScalar());
+        ps.push_back(Point::mulBase(RandomScalar()));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Point::MultiMul(ks, ps));
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)n);
+}
+BENCHMARK(BM_PointMultiMul)->RangeMultiplier(4)->Range(4, 1024);
+
+// 并行 MultiMul（Executor::threads），参数：项数、线程数（1 = 串行路径）
+void BM_PointMultiMulParallel(benchmark::State& state) {
+    const size_t n = (size_t)state.range(0);
+    Curve::FourQ::Scalars ks(n);
+    Curve::FourQ::Points ps(n);
+    Point acc = Point::mulBase(RandomScalar());
+    for (size_t i = 0; i < n; i++) {
+        ks[i] = RandomScalar();
+        ps[i] = acc; // 逐个相加生成，避免 n 次 mulBase
+        acc += Point::getBase();
+    }
+    const Curve::FourQ::Executor executor = Curve::FourQ::Executor::threads((unsigned)state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Point::MultiMul(ks, ps, executor));
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)n);
+}
+BENCHMARK(BM_PointMultiMulParallel)
+    ->ArgsProduct({{1 << 14, 1 << 17}, benchmark::CreateRange(1, MaxThreads(), 2)})
+    ->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// SoA 批量：构造（共享一次求逆）与导出编码（无需求逆）
+void BM_PointBatchAssign(benchmark::State& state) {
+    Curve::FourQ::Points ps;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        ps.push_back(Point::mulBase(RandomScalar()) + Point::mulBase(RandomScalar()));
+    }
+    Curve::FourQ::PointBatch batch;
+    for (auto _ : state) {
+        batch.assign(ps);
+        benchmark::DoNotOptimize(batch.limb(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointBatchAssign)->RangeMultiplier(8)->Range(64, 4096);
+
+void BM_PointBatchEncodeAll(benchmark::State& state) {
+    Curve::FourQ::Points ps;
+    for (int64_t i = 0; i < state.range(0); i++) {
+        ps.push_back(Point::mulBase(RandomScalar()));
+    }
+    Curve::FourQ::PointBatch batch(ps);
+    std::vector<EccDataType> raw(ps.size());
+    for (auto _ : state) {
+        batch.encodeAll(raw);
+        benchmark::DoNotOptimize(raw.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PointBatchEncodeAll)->RangeMultiplier(8)->Range(64, 4096);
+
+// 参数：0 = Scalar，1 = AVX2，2 = AVX-512 IFMA（本机不支持则跳过）
+void BM_AddAll(benchmark::State& state) {
+    const auto backend = static_cast<Curve::FourQ::LaneBackend>(state.range(0));
+    const Curve::FourQ::LaneBackend original = Curve::FourQ::laneBackend();
+    if (!Curve::FourQ::setLaneBackend(backend)) {
+        state.SkipWithError("lane backend not supported on this machine");
+        return;
+    }
+    state.SetLabel(Curve::FourQ::laneBackendName());
+    Curve::FourQ::Points acc, addends;
+    for (int i = 0; i < 1024; i++) {
+        acc.push_back(Point::mulBase(RandomScalar()) + Point::mulBase(RandomScalar()));
+        addends.push_back(Point::mulBase(RandomScalar()));
+    }
+    const Curve::FourQ::PointBatch batch(addends);
+    for (auto _ : state) {
+        Curve::FourQ::addAll(acc, batch);
+        benchmark::DoNotOptimize(acc.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)acc.size());
+    Curve::FourQ::setLaneBackend(original);
+}
+BENCHMARK(BM_AddAll)->DenseRange(0, 2);
+
+void BM_DoubleAll(benchmark::State& state) {
+    const auto backend = static_cast<Curve::FourQ::LaneBackend>(state.range(0));
+    const Curve::FourQ::LaneBackend original = Curve::FourQ::laneBackend();
+    if (!Curve::FourQ::setLaneBackend(backend)) {
+        state.SkipWithError("lane backend not supported on this machine");
+        return;
+    }
+    state.SetLabel(Curve::FourQ::laneBackendName());
+    Curve::FourQ::Points pts;
+    for (int i = 0; i < 1024; i++) {
+        pts.push_back(Point::mulBase(RandomScalar()) + Point::mulBase(RandomScalar()));
+    }
+    for (auto _ : state) {
+        Curve::FourQ::doubleAll(pts);
+        benchmark::DoNotOptimize(pts.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)pts.size());
+    Curve::FourQ::setLaneBackend(original);
+}
+BENCHMARK(BM_DoubleAll)->DenseRange(0, 2);
+
+void BM_PreparedPointMul(benchmark::State& state) {
+    Curve::FourQ::PreparedPoint pp(Point::mulBase(RandomScalar()));
+    Scalar k = RandomScalar();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(pp.mul(k));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PreparedPointMul);
+
+// 一个临时密钥对 256 个对端（已在缓存中）求共享密钥，单位：每个对端。
+// 参数：0 = 手写的 Point(raw) * k 再编码，1 = sharedSecret(raw)（每次解码），2 = 经 DecodeCache 的 sharedSecretBatch
+void BM_KeyExchangeSharedSecret(benchmark::State& state) {
+    const size_t n = 256;
+    const Scalar sk = RandomScalar();
+    const Curve::FourQ::KeyExchange eph(sk);
+    std::vector<EccDataType> peers(n), secrets(n);
+    for (auto& p : peers) {
+        p = Point::mulBase(RandomScalar()).getRaw();
+    }
+    Curve::FourQ::DecodeCache cache(2 * n);
+    eph.sharedSecretBatch(cache, peers, secrets);
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < n; i++) {
+                secrets[i] = (sk * Point(peers[i])).getRaw();
+            }
+        } else if (state.range(0) == 1) {
+            for (size_t i = 0; i < n; i++) {
+                eph.sharedSecret(peers[i], secrets[i]);
+            }
+        } else {
+            eph.sharedSecretBatch(cache, peers, secrets);
+        }
+        benchmark::DoNotOptimize(secrets.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)n);
+}
+BENCHMARK(BM_KeyExchangeSharedSecret)->DenseRange(0, 2);
+
+// 冷启动加载 16384 个公钥，单线程，单位：每个公钥。
+// 参数：0 = 逐个 Point(hex)（十六进制解码 + decode + 校验），1..3 = 打开密钥库（校验全部摘要）并 loadAll，
+// 格式依次为 Compressed、Affine、Precomputed
+void BM_KeyStoreLoad(benchmark::State& state) {
+    const size_t n = 16384;
+    std::vector<Point> points(n);
+    Point acc = Point::mulBase(RandomScalar());
+    for (auto& p : points) {
+        p = acc;
+        acc += Point::getBase();
+    }
+    std::vector<std::string> hex;
+    const std::string path = "fastecc_bench_keystore.bin";
+    if (state.range(0) == 0) {
+        for (auto& p : points) {
+            hex.push_back(p.toString());
+        }
+    } else {
+        Curve::FourQ::KeyStore::write(path, points, (Curve::FourQ::KeyStoreFormat)state.range(0));
+    }
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (size_t i = 0; i < n; i++) {
+                points[i] = Point(hex[i]);
+            }
+        } else {
+            const Curve::FourQ::KeyStore store(path, Curve::FourQ::KeyStoreVerify::Digest, 1);
+            store.loadAll(points, 1);
+        }
+        benchmark::DoNotOptimize(points.data());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * (int64_t)n);
+}
+BENCHMARK(BM_KeyStoreLoad)->DenseRange(0, 3)->Unit(benchmark::kMillisecond);
+
+// 256 条 R || A || M（M 为 32 B）；参数：0 = Portable，1 = AVX2，2 = AVX-512（本机不支持则跳过）
+void BM_Sha512HashMany(benchmark::State& state) {
+    const auto backend = static_cast<Curve::FourQ::Sha512Backend>(state.range(0));
+    const Curve::FourQ::Sha512Backend original = Curve::FourQ::sha512Backend();
+    if (!Curve::FourQ::setSha512Backend(backend)) {
+        state.SkipWithError("SHA-512 backend not supported on this machine");
+        return;
+    }
+    state.SetLabel(Curve::FourQ::sha512BackendName());
+    std::vector<uint8_t> data = RandomMessage(256 * 96);
+    std::vector<Curve::FourQ::Sha512::Message> msgs;
+    for (size_t i = 0; i < 256; i++) {
+        const uint8_t* p = data.data() + 96 * i;
+        msgs.push_back({std::span<const uint8_t>(p, 32), std::span<const uint8_t>(p + 32, 32), std::span<const uint8_t>(p + 64, 32)});
+    }
+    std::vector<Curve::FourQ::Sha512::Digest> out(msgs.size());
+    for (auto _ : state) {
+        Curve::FourQ::Sha512::hashMany(msgs, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * (int64_t)msgs.size());
+    Curve::FourQ::setSha512Backend(original);
+}
+BENCHMARK(BM_Sha512HashMany)->DenseRange(0, 2);
+
+// --- SchnorrQ（消息长度 32 B 到 1 MB）---
+
+void BM_SchnorrQSign(benchmark::State& state) {
+    Scalar sk = RandomScalar();
+    std::vector<uint8_t> msg = RandomMessage((size_t)state.range(0));
+    std::array<uint8_t, 64> sig;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msg), sig));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SchnorrQSign)->RangeMultiplier(8)->Range(32, 1 << 20);
+
+void BM_SchnorrQVerify(benchmark::State& state) {
+    Scalar sk = RandomScalar();
+    Point pk = Point::mulBase(sk);
+    std::vector<uint8_t> msg = RandomMessage((size_t)state.range(0));
+    std::array<uint8_t, 64> sig;
+    Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msg), sig);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Curve::FourQ::SchnorrQVerify(pk, std::span<const uint8_t>(msg), sig));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SchnorrQVerify)->RangeMultiplier(8)->Range(32, 1 << 20);
+
+// 预展开的私钥：省去每次签名的 mulBase 与编码
+void BM_SigningKeySign(benchmark::State& state) {
+    Curve::FourQ::SigningKey key(RandomScalar());
+    std::vector<uint8_t> msg = RandomMessage((size_t)state.range(0));
+    std::array<uint8_t, 64> sig;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(key.sign(std::span<const uint8_t>(msg), sig));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SigningKeySign)->RangeMultiplier(8)->Range(32, 1 << 20);
+
+// 线程扩展：每个线程独立签名/验签，items_per_second 为总吞吐
+void BM_SchnorrQSignThreads(benchmark::State& state) {
+    Scalar sk = RandomScalar();
+    std::vector<uint8_t> msg = RandomMessage(32);
+    std::array<uint8_t, 64> sig;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msg), sig));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SchnorrQSignThreads)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+void BM_SchnorrQVerifyThreads(benchmark::State& state) {
+    Scalar sk = RandomScalar();
+    Point pk = Point::mulBase(sk);
+    std::vector<uint8_t> msg = RandomMessage(32);
+    std::array<uint8_t, 64> sig;
+    Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msg), sig);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Curve::FourQ::SchnorrQVerify(pk, std::span<const uint8_t>(msg), sig));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SchnorrQVerifyThreads)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+// 批量验签：单线程 SchnorrQVerifyBatch 与 SchnorrQBatchEngine 的线程扩展（每批 1024 个、64 个不同公钥）
+struct VerifyBatchFixture {
+    std::vector<std::vector<uint8_t>> msgs;
+    std::vector<Point> pubkeys;
+    std::vector<std::span<const uint8_t>> spans;
+    std::vector<std::array<uint8_t, 64>> sigs;
+    std::vector<Curve::FourQ::SchnorrQBatchEngine::VerifyJob> jobs;
+
+    explicit VerifyBatchFixture(size_t n) {
+        std::vector<Scalar> sks;
+        for (size_t k = 0; k < 64; k++) {
+            sks.push_back(RandomScalar());
+        }
+        msgs.resize(n);
+        sigs.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            msgs[i] = RandomMessage(32);
+            const Scalar& sk = sks[i % sks.size()];
+            Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msgs[i]), sigs[i]);
+            pubkeys.push_back(Point::mulBase(sk));
+        }
+        for (size_t i = 0; i < n; i++) {
+            spans.emplace_back(msgs[i]);
+            jobs.push_back({pubkeys[i].getRaw(), spans[i], sigs[i]});
+        }
+    }
+};
+
+void BM_SchnorrQVerifyBatch(benchmark::State& state) {
+    VerifyBatchFixture f((size_t)state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Curve::FourQ::SchnorrQVerifyBatch(f.pubkeys, f.spans, f.sigs));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SchnorrQVerifyBatch)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_SchnorrQBatchEngineVerify(benchmark::State& state) {
+    VerifyBatchFixture f(1024);
+    Curve::FourQ::SchnorrQBatchEngine engine((unsigned)state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.verify(f.jobs));
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_SchnorrQBatchEngineVerify)->RangeMultiplier(2)->Range(1, MaxThreads())->UseRealTime();
+
+// 异步微批验签：1024 个 submit() 后等待全部结果，参数为 maxBatch（1 即逐个验证）
+void BM_AsyncVerifier(benchmark::State& state) {
+    VerifyBatchFixture f(1024);
+    Curve::FourQ::AsyncVerifier::Options options;
+    options.maxBatch = (size_t)state.range(0);
+    Curve::FourQ::AsyncVerifier verifier(options);
+    std::vector<std::future<bool>> results(f.jobs.size());
+    for (auto _ : state) {
+        for (size_t i = 0; i < f.jobs.size(); i++) {
+            results[i] = verifier.submit(f.jobs[i].pubkey, f.jobs[i].msg, f.jobs[i].sig);
+        }
+        for (std::future<bool>& r : results) {
+            benchmark::DoNotOptimize(r.get());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_AsyncVerifier)->Arg(1)->Arg(16)->Arg(64)->UseRealTime();
+
+} // anonymous namespace
+
+BENCHMARK_MAIN();
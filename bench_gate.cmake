@@ -0,0 +1,119 @@
+# Throughput regression gate for fastecc_bench (run by the fastecc_bench_gate target).
+#
+#   cmake -DBASELINE=<json> -DCURRENT=<json> [-DTOLERANCE=<percent>] -P bench_gate.cmake
+#
+# Both files are Google Benchmark JSON output written with --benchmark_repetitions and
+# --benchmark_report_aggregates_only. The median real time of every benchmark in CURRENT
+# is compared with the same benchmark in BASELINE; the script fails if any of them is
+# more than TOLERANCE percent (default 10) slower. Benchmarks missing from the baseline
+# are reported and skipped.
+
+cmake_minimum_required(VERSION 3.19) # string(JSON)
+
+if(NOT DEFINED BASELINE OR NOT DEFINED CURRENT)
+    message(FATAL_ERROR "bench_gate.cmake: pass -DBASELINE=<json> -DCURRENT=<json>")
+endif()
+if(NOT DEFINED TOLERANCE)
+    set(TOLERANCE 10)
+endif()
+if(NOT EXISTS "${BASELINE}")
+    message(FATAL_ERROR "bench_gate.cmake: no baseline at ${BASELINE}; build fastecc_bench_baseline first")
+endif()
+
+# CMake math is integer only: "1.2345e+05" -> 123450000 (the value in thousandths)
+function(fastecc_milli value out)
+    if(NOT value MATCHES "^([0-9]+)(\\.([0-9]*))?([eE]([+-]?)([0-9]+))?$")
+        message(FATAL_ERROR "bench_gate.cmake: cannot parse time '${value}'")
+    endif()
+    set(digits "${CMAKE_MATCH_1}${CMAKE_MATCH_3}")
+    string(LENGTH "${CMAKE_MATCH_3}" fraction)
+    set(exponent 0)
+    if(CMAKE_MATCH_6)
+        set(exponent "${CMAKE_MATCH_6}")
+        if(CMAKE_MATCH_5 STREQUAL "-")
+            math(EXPR exponent "-${exponent}")
+        endif()
+    endif()
+    math(EXPR shift "${exponent} - ${fraction} + 3")
+    if(shift GREATER_EQUAL 0)
+        while(shift GREATER 0)
+            string(APPEND digits "0")
+            math(EXPR shift "${shift} - 1")
+        endwhile()
+    else()
+        math(EXPR drop "-${shift}")
+        string(LENGTH "${digits}" length)
+        if(drop GREATER_EQUAL length)
+            set(digits "0")
+        else()
+            math(EXPR keep "${length} - ${drop}")
+            string(SUBSTRING "${digits}" 0 ${keep} digits)
+        endif()
+    endif()
+    string(REGEX REPLACE "^0+([0-9])" "\\1" digits "${digits}")
+    set(${out} "${digits}" PARENT_SCOPE)
+endfunction()
+
+# Sets <prefix>_NAMES and <prefix>_<name> (median real time in thousandths of its unit)
+function(fastecc_read_medians file prefix)
+    file(READ "${file}" json)
+    string(JSON count LENGTH "${json}" benchmarks)
+    set(names "")
+    if(count GREATER 0)
+        math(EXPR last "${count} - 1")
+        foreach(i RANGE ${last})
+            string(JSON type ERROR_VARIABLE err GET "${json}" benchmarks ${i} aggregate_name)
+            if(err OR NOT type STREQUAL "median")
+                continue()
+            endif()
+            string(JSON name GET "${json}" benchmarks ${i} run_name)
+            string(JSON time GET "${json}" benchmarks ${i} real_time)
+            string(JSON unit GET "${json}" benchmarks ${i} time_unit)
+            fastecc_milli("${time}" milli)
+            list(APPEND names "${name}")
+            set(${prefix}_${name} "${milli}" PARENT_SCOPE)
+            set(${prefix}_UNIT_${name} "${unit}" PARENT_SCOPE)
+        endforeach()
+    endif()
+    if(NOT names)
+        message(FATAL_ERROR "bench_gate.cmake: no median aggregates in ${file} (run with --benchmark_repetitions)")
+    endif()
+    set(${prefix}_NAMES "${names}" PARENT_SCOPE)
+endfunction()
+
+fastecc_read_medians("${BASELINE}" base)
+fastecc_read_medians("${CURRENT}" cur)
+
+set(failed "")
+foreach(name IN LISTS cur_NAMES)
+    if(NOT DEFINED base_${name})
+        message(STATUS "${name}: not in the baseline, skipped")
+        continue()
+    endif()
+    if(NOT base_UNIT_${name} STREQUAL cur_UNIT_${name})
+        message(FATAL_ERROR "bench_gate.cmake: ${name} is in ${base_UNIT_${name}} in the baseline but ${cur_UNIT_${name}} now")
+    endif()
+    set(base "${base_${name}}")
+    set(cur "${cur_${name}}")
+    math(EXPR limit "${base} + ${base} * ${TOLERANCE} / 100")
+    if(base GREATER 0)
+        math(EXPR change "(${cur} - ${base}) * 100 / ${base}")
+    else()
+        set(change 0)
+    endif()
+    math(EXPR base_shown "${base} / 1000")
+    math(EXPR cur_shown "${cur} / 1000")
+    set(line "${name}: ${base_shown} -> ${cur_shown} ${cur_UNIT_${name}} (${change}%)")
+    if(cur GREATER limit)
+        message(STATUS "${line}  REGRESSION")
+        list(APPEND failed "${name}")
+    else()
+        message(STATUS "${line}")
+    endif()
+endforeach()
+
+if(failed)
+    list(JOIN failed ", " failed)
+    message(FATAL_ERROR "bench_gate.cmake: slower than the baseline by more than ${TOLERANCE}%: ${failed}")
+endif()
+message(STATUS "bench_gate.cmake: no benchmark regressed by more than ${TOLERANCE}%")
@@ -1,5 +1,11 @@
 #include "fourq.hpp"
+#include "fourq_comb.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_random.hpp"
+#include "fourq_schnorrq.hpp"
+#include "fourq_sha512.hpp"
 
+#include <algorithm> // For std::min
 #include <cstring>  // For memset, memcpy, memcmp
 #include <stdexcept> // For std::runtime_error, std::invalid_argument
 #include <string>    // For std::to_string in error messages
@@ -24,82 +30,227 @@ extern "C" {
 // --- Internal Helper Implementation ---
 namespace { // Anonymous namespace for internal linkage
 
-// _M64 Union for byte/word conversion (Consider endianness-safe alternatives if needed)
-typedef union
+using Curve::FourQ::fourq_scalar_t;
+using namespace Curve::FourQ::detail; // Const-correct shims from fourq_internal.hpp
+
+// FourQ's encode() stores through (digit_t*) casts, so it must be given digit_t
+// storage rather than a plain byte array like EccDataType
+void encode_point(point_t P, uint8_t* out)
 {
-  uint64_t u64;
-  struct
-  {
-	uint8_t b0, b1, b2, b3, b4, b5, b6, b7;
-  } u8;
-} _M64;
-
-// Byte reversal helper
-// Note: Original function modified the output buffer directly and returned it.
-// This version keeps that behavior. Ensure 'out' has sufficient space (32 bytes).
-uint8_t* reverse_bytes(uint8_t* out, const uint8_t* in)
+	FASTECC_STAT_SCOPE(Encode);
+	digit_t encoded[NWORDS_ORDER];
+	encode(P, reinterpret_cast<unsigned char*>(encoded));
+	std::memcpy(out, encoded, ECC_KEY_LENGTH);
+}
+
+bool fp_is_zero(const felm_t a)
 {
-	for (int i = 0; i < 32; i++) {
-		out[i] = in[31 - i];
+	for (unsigned i = 0; i < NWORDS_FIELD; i++) {
+		if (a[i] != 0) {
+			return fp_is_p(a);
+		}
 	}
-	return out;
+	return true;
+}
+
+bool fp2_is_zero(const f2elm_t a)
+{
+	return fp_is_zero(a[0]) && fp_is_zero(a[1]);
+}
+
+bool fp2_is_one(const f2elm_t a)
+{
+	if (a[0][0] != 1) {
+		return false;
+	}
+	for (unsigned i = 1; i < NWORDS_FIELD; i++) {
+		if (a[0][i] != 0) {
+			return false;
+		}
+	}
+	return fp_is_zero(a[1]);
 }
 
+// a*d - b*c == 0 in GF(p^2)
+bool cross_equal(const f2elm_t a, const f2elm_t d, const f2elm_t b, const f2elm_t c)
+{
+	f2elm_t ad, bc;
+	fp2mul(a, d, ad);
+	fp2mul(b, c, bc);
+	fp2sub1271(ad, bc, ad);
+	return fp2_is_zero(ad);
+}
+
+// P = P - Q, negating Q's R2 form
+void eccsub(const point_extproj* Q, point_extproj* P)
+{
+	point_extproj_precomp_t Q_precomp;
+	r1_to_r2(Q, Q_precomp);
+	negate_r2(Q_precomp, Q_precomp);
+	eccadd(Q_precomp, P);
+}
+
+std::span<const point_extproj> as_extproj(std::span<const Curve::FourQ::Point> points)
+{
+	return {reinterpret_cast<const point_extproj*>(points.data()), points.size()};
+}
+
+bool scalar_is_zero(const fourq_scalar_t& a)
+{
+	for (const auto& word : a) {
+		if (word != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// One uniform scalar in [1, order): 246-bit candidates (order > 2^245, so ~65% accepted)
+// until one is below the order and nonzero
+void random_scalar(fourq_scalar_t& out)
+{
+	static_assert(sizeof(fourq_scalar_t) == 32);
+	uint8_t raw[32];
+	for (;;) {
+		if (!Curve::FourQ::randomBytes(raw)) {
+			throw std::runtime_error("Random number generation failed");
+		}
+		std::memcpy(out.data(), raw, sizeof(raw));
+		out[3] &= ((uint64_t)1 << 54) - 1;
+		bool below = false;
+		for (int i = 3; i >= 0; i--) {
+			if (out[i] != curve_order[i]) {
+				below = out[i] < curve_order[i];
+				break;
+			}
+		}
+		if (below && !scalar_is_zero(out)) {
+			break;
+		}
+	}
+	clear_words(raw, (digit_t)(sizeof(raw) / sizeof(unsigned int)));
+}
+
+// In-place inversion of n scalars in Montgomery form with one Montgomery_inversion_mod_order:
+// with prefix products c_i = a_0*...*a_i, 1/a_i = c_{i-1} * (1/c_i). All inputs nonzero.
+void batch_invert_montgomery(fourq_scalar_t* a, size_t n)
+{
+	if (n == 0) {
+		return;
+	}
+	Curve::FourQ::detail::Scratch scratch;
+	auto prefix = scratch.vector<fourq_scalar_t>(n);
+	prefix[0] = a[0];
+	for (size_t i = 1; i < n; i++) {
+		Montgomery_multiply_mod_order(prefix[i - 1].data(), a[i].data(), prefix[i].data());
+	}
+
+	fourq_scalar_t inv, t;
+	Montgomery_inversion_mod_order(prefix[n - 1].data(), inv.data()); // inv = 1/c_{n-1}
+	for (size_t i = n - 1; i > 0; i--) {
+		Montgomery_multiply_mod_order(inv.data(), prefix[i - 1].data(), t.data()); // 1/a_i
+		Montgomery_multiply_mod_order(inv.data(), a[i].data(), inv.data());        // 1/c_{i-1}
+		a[i] = t;
+	}
+	a[0] = inv;
+}
+
+struct Fp2 {
+	f2elm_t v;
+};
+
 } // anonymous namespace
 
 
 namespace Curve {
 namespace FourQ {
 
+namespace detail {
+
+void to_affine(const point_extproj* P, point_affine* Q)
+{
+	if (fp2_is_one(P->z)) {
+		fp2copy(P->x, Q->x);
+		fp2copy(P->y, Q->y);
+	} else {
+		FASTECC_STAT_SCOPE(Normalize);
+		point_extproj_t P_copy; // eccnorm inverts Z in place
+		std::memcpy(P_copy, P, sizeof(point_extproj_t));
+		eccnorm(P_copy, Q);
+	}
+	fp2_canonical(Q->x);
+	fp2_canonical(Q->y);
+}
+
+// With prefix products c_i = Z_0*...*Z_i, 1/Z_i = c_{i-1} * (1/c_i). Points with Z == 1
+// are copied.
+void batch_to_affine(std::span<const point_extproj> P, point_affine* Q)
+{
+	const size_t n = P.size();
+	FASTECC_STAT_SCOPE_N(BatchNormalize, n);
+	Scratch scratch;
+	auto prefix = scratch.vector<Fp2>(n);
+	f2elm_t acc, t;
+	fp2zero1271(acc);
+	acc[0][0] = 1;
+	for (size_t i = 0; i < n; i++) {
+		if (!fp2_is_one(P[i].z)) {
+			fp2mul(acc, P[i].z, t);
+			fp2copy1271(t, acc);
+		}
+		fp2copy1271(acc, prefix[i].v);
+	}
+
+	fp2inv1271(acc); // acc = 1/c_{n-1}
+	for (size_t i = n; i-- > 0;) {
+		if (fp2_is_one(P[i].z)) {
+			fp2copy(P[i].x, Q[i].x);
+			fp2copy(P[i].y, Q[i].y);
+		} else {
+			f2elm_t zinv;
+			if (i > 0) {
+				fp2mul1271(acc, prefix[i - 1].v, zinv);
+			} else {
+				fp2copy1271(acc, zinv);
+			}
+			fp2mul(acc, P[i].z, t); // acc = 1/c_{i-1}
+			fp2copy1271(t, acc);
+			fp2mul(P[i].x, zinv, Q[i].x);
+			fp2mul(P[i].y, zinv, Q[i].y);
+		}
+		fp2_canonical(Q[i].x);
+		fp2_canonical(Q[i].y);
+	}
+}
+
+} // namespace detail
+
+
 // --- Scalar Member Function Implementations ---
 
+// Scalars are serialized little-endian, word by word, independent of host byte order
 EccDataType Scalar::toBytes(const fourq_scalar_t& w) const {
-	int i;
-	_M64 m;
 	EccDataType Y;
-	// Assuming NWORDS_ORDER is 4, so ECC_KEY_LENGTH is 32
-	for (i = 0; i < static_cast<int>(NWORDS_ORDER); ++i) {
-		m.u64 = w[i];
-		Y[i * 8 + 0] = m.u8.b0;
-		Y[i * 8 + 1] = m.u8.b1;
-		Y[i * 8 + 2] = m.u8.b2;
-		Y[i * 8 + 3] = m.u8.b3;
-		Y[i * 8 + 4] = m.u8.b4;
-		Y[i * 8 + 5] = m.u8.b5;
-		Y[i * 8 + 6] = m.u8.b6;
-		Y[i * 8 + 7] = m.u8.b7;
+	for (size_t i = 0; i < NWORDS_ORDER; ++i) {
+		for (size_t j = 0; j < sizeof(digit_t); ++j) {
+			Y[i * sizeof(digit_t) + j] = static_cast<uint8_t>(w[i] >> (8 * j));
+		}
 	}
 	return Y;
 }
 
 fourq_scalar_t Scalar::toWords(const EccDataType& b) const {
-	int i;
-	_M64 m;
 	fourq_scalar_t Y;
-	for (i = 0; i < static_cast<int>(NWORDS_ORDER); i++) {
-		m.u8.b0 = b[i * 8 + 0];
-		m.u8.b1 = b[i * 8 + 1];
-		m.u8.b2 = b[i * 8 + 2];
-		m.u8.b3 = b[i * 8 + 3];
-		m.u8.b4 = b[i * 8 + 4];
-		m.u8.b5 = b[i * 8 + 5];
-		m.u8.b6 = b[i * 8 + 6];
-		m.u8.b7 = b[i * 8 + 7];
-		Y[i] = m.u64;
+	for (size_t i = 0; i < NWORDS_ORDER; ++i) {
+		digit_t word = 0;
+		for (size_t j = 0; j < sizeof(digit_t); ++j) {
+			word |= static_cast<digit_t>(b[i * sizeof(digit_t) + j]) << (8 * j);
+		}
+		Y[i] = word;
 	}
 	return Y;
 }
 
-Scalar::Scalar(uint32_t val) {
-	_b.fill(0);
-	_b[0] = val; // Assumes little-endian storage in digit_t array
-	// Apply modulo order if val could exceed it? FourQ ops usually handle this.
-}
-
-Scalar::Scalar(const Scalar& br) {
-	_b = br._b; // Use std::array's copy assignment
-}
-
 Scalar::Scalar(const std::string& ins) {
 	// Delegate to fromString method
 	fromString(ins);
@@ -117,22 +268,31 @@ EccDataType Scalar::getRaw() const {
 }
 
 std::string Scalar::toString() const {
-	//EccDataType brev; // Not reversing bytes for scalar based on tests
-	auto btmp = getRaw();
-	// reverse_bytes(brev.data(), btmp.data());
-	// return bytes_to_hex_string(brev);
-	return bytes_to_hex_string(btmp);
+	std::string out(kHexLength, '\0');
+	toHex(out.data());
+	return out;
 }
 
 void Scalar::fromString(const std::string& ins) {
-	if (ins.size() != 2 * ECC_KEY_LENGTH) {
+	fromHex(ins);
+}
+
+void Scalar::toHex(char* out) const {
+	// Not reversing bytes for scalar based on tests
+	auto btmp = getRaw();
+	hex_encode(btmp, std::span<char>(out, kHexLength));
+}
+
+void Scalar::fromHex(std::string_view ins) {
+	if (ins.size() != kHexLength) {
 		 // Use std::to_string which requires <string>
-		throw std::runtime_error("Invalid input scalar length: expected " + std::to_string(2 * ECC_KEY_LENGTH) + ", got " + std::to_string(ins.size()));
+		throw std::runtime_error("Invalid input scalar length: expected " + std::to_string(kHexLength) + ", got " + std::to_string(ins.size()));
 	}
 
 	EccDataType btmp;
-	// Use the utility from utils.hpp, it throws on error
-	hex_string_to_bytes(ins, btmp);
+	if (!hex_decode(ins, btmp)) {
+		throw std::invalid_argument("Invalid hex character in scalar string");
+	}
 
 	// Assuming no byte reversal needed for scalar based on tests
 	auto tmp = toWords(btmp);
@@ -164,13 +324,6 @@ Scalar& Scalar::Sanitize() {
 	return *this;
 }
 
-Scalar& Scalar::operator=(const Scalar& b) {
-	if (this != &b) { // Handle self-assignment
-		_b = b._b;
-	}
-	return *this;
-}
-
 Scalar& Scalar::operator=(const std::string& ins) {
 	fromString(ins); // Reuse fromString logic
 	return *this;
@@ -179,31 +332,32 @@ Scalar& Scalar::operator=(const std::string& ins) {
 
 // --- Scalar Friend Operator Implementations ---
 
-Scalar operator+(const Scalar& lh, const Scalar& rh) {
+Scalar Scalar::addMod(const Scalar& lh, const Scalar& rh) {
 	Scalar ret;
 	add_mod_order(lh._b.data(), rh._b.data(), ret._b.data());
 	return ret;
 }
 
-Scalar operator-(const Scalar& lh, const Scalar& rh) {
+Scalar Scalar::subMod(const Scalar& lh, const Scalar& rh) {
 	Scalar ret;
 	subtract_mod_order(lh._b.data(), rh._b.data(), ret._b.data());
 	return ret;
 }
 
-Scalar operator*(const Scalar& lh, const Scalar& rh) {
+Scalar Scalar::mulMod(const Scalar& lh, const Scalar& rh) {
+	// Montgomery product of the plain values is a*b/R; to_Montgomery (times R^2/R) then
+	// gives a*b, two multiplications instead of converting both operands in and out
 	Scalar ret;
-	fourq_scalar_t lt, rt;
-
-	// Convert operands to Montgomery form
-	to_Montgomery(lh._b.data(), lt.data());
-	to_Montgomery(rh._b.data(), rt.data());
-
-	// Perform Montgomery multiplication
-	Montgomery_multiply_mod_order(lt.data(), rt.data(), ret._b.data());
+	fourq_scalar_t t;
+	Montgomery_multiply_mod_order(lh._b.data(), rh._b.data(), t.data());
+	to_Montgomery(t.data(), ret._b.data());
+	return ret;
+}
 
-	// Convert result back from Montgomery form
-	from_Montgomery(ret._b.data(), ret._b.data());
+Scalar Scalar::reduceWords(const fourq_scalar_t& w) {
+	Scalar ret;
+	fourq_scalar_t tmp = w;
+	modulo_order(tmp.data(), ret._b.data());
 	return ret;
 }
 
@@ -250,48 +404,109 @@ Scalar Scalar::invert(const Scalar& b) {
 	return ret;
 }
 
-Scalar Scalar::negate(const Scalar& b) {
-	if (b.isZero()) {
-		return Scalar(); // Negation of zero is zero
+void Scalar::invertBatch(std::span<Scalar> values) {
+	for (const auto& v : values) {
+		if (v.isZero()) {
+			throw std::runtime_error("Cannot invert zero scalar");
+		}
 	}
+	detail::Scratch scratch;
+	auto mont = scratch.vector<fourq_scalar_t>(values.size());
+	for (size_t i = 0; i < values.size(); i++) {
+		to_Montgomery(values[i]._b.data(), mont[i].data());
+	}
+	batch_invert_montgomery(mont.data(), mont.size());
+	for (size_t i = 0; i < values.size(); i++) {
+		from_Montgomery(mont[i].data(), values[i]._b.data());
+	}
+}
+
+Scalar Scalar::random() {
 	Scalar ret;
-	// Calculate (order - b) mod order
-	subtract_mod_order(curve_order, b._b.data(), ret._b.data());
-	// The result of subtract_mod_order should already be reduced.
-	// An extra modulo_order might be redundant but safe.
-	// modulo_order(ret._b.data(), ret._b.data()); // Optional safeguard
+	random_scalar(ret._b);
 	return ret;
 }
 
-Scalar Scalar::getZero() {
-	// Default constructor creates zero
-	return Scalar();
+void Scalar::randomBatch(std::span<Scalar> out) {
+	for (auto& s : out) {
+		random_scalar(s._b);
+	}
 }
 
 
-// --- Point Member Function Implementations ---
+// --- MontScalar Implementations ---
+
+fourq_scalar_t MontScalar::toMontgomery(const Scalar& s) {
+	fourq_scalar_t m;
+	to_Montgomery(s._b.data(), m.data());
+	return m;
+}
+
+Scalar MontScalar::toScalar() const {
+	Scalar ret;
+	from_Montgomery(_m.data(), ret._b.data());
+	return ret;
+}
+
+bool MontScalar::isZero() const {
+	return scalar_is_zero(_m);
+}
+
+MontScalar& MontScalar::operator+=(const MontScalar& b) {
+	// a*R + b*R = (a+b)*R, so addition is the same as on plain scalars
+	add_mod_order(_m.data(), b._m.data(), _m.data());
+	return *this;
+}
 
-Point::Point() {
-	// Initialize with the identity point (affine 0, 1)
-	point_t zero_affine;
-	fp2zero1271(zero_affine->x); // x = 0
-	fp2zero1271(zero_affine->y); // y = 0
-	zero_affine->y[0][0] = 1;    // Set y = 1
-	point_setup(zero_affine, _pe); // Setup internal representation
+MontScalar& MontScalar::operator-=(const MontScalar& b) {
+	subtract_mod_order(_m.data(), b._m.data(), _m.data());
+	return *this;
 }
 
+MontScalar& MontScalar::operator*=(const MontScalar& b) {
+	// (a*R)(b*R)/R = (a*b)*R
+	Montgomery_multiply_mod_order(_m.data(), b._m.data(), _m.data());
+	return *this;
+}
 
-Point::Point(const Point& that) {
-	// Copy the array content
-	memcpy(_pe, that._pe, sizeof(point_extproj_t));
+MontScalar operator+(const MontScalar& lh, const MontScalar& rh) {
+	MontScalar ret = lh;
+	ret += rh;
+	return ret;
 }
 
-Point::Point(Point&& that) noexcept { // Add noexcept
-	// "Move" for a fixed-size array member is just a copy.
-	memcpy(_pe, that._pe, sizeof(point_extproj_t));
-	// No need to nullify that._pe as it's not a pointer.
+MontScalar operator-(const MontScalar& lh, const MontScalar& rh) {
+	MontScalar ret = lh;
+	ret -= rh;
+	return ret;
 }
 
+MontScalar operator*(const MontScalar& lh, const MontScalar& rh) {
+	MontScalar ret = lh;
+	ret *= rh;
+	return ret;
+}
+
+MontScalar MontScalar::invert(const MontScalar& b) {
+	if (b.isZero()) {
+		throw std::runtime_error("Cannot invert zero scalar");
+	}
+	MontScalar ret;
+	Montgomery_inversion_mod_order(b._m.data(), ret._m.data());
+	return ret;
+}
+
+void MontScalar::invertBatch(std::span<MontScalar> values) {
+	for (const auto& v : values) {
+		if (v.isZero()) {
+			throw std::runtime_error("Cannot invert zero scalar");
+		}
+	}
+	batch_invert_montgomery(reinterpret_cast<fourq_scalar_t*>(values.data()), values.size());
+}
+
+
+// --- Point Member Function Implementations ---
 
 Point::Point(const std::string& str) {
 	// Delegate to fromString method. Ensure _pe is initialized before fromString modifies it.
@@ -300,6 +515,7 @@ Point::Point(const std::string& str) {
 }
 
 Point::Point(const EccDataType& val) {
+	FASTECC_STAT_SCOPE(Decode);
 	point_t pa;
 	// Decode the bytes into an affine point representation
 	if (decode(val.data(), pa) != ECCRYPTO_SUCCESS) { // Check return code
@@ -317,41 +533,46 @@ Point::Point(const EccDataType& val) {
 // Destructor not needed for array member _pe
 
 EccDataType Point::getRaw() const {
-	// No null check needed for array member
 	EccDataType rd;
 	point_t pa;
-	// Normalize a copy to avoid modifying const object state and casting away const
-	Point p_copy = *this;
-	eccnorm(p_copy._pe, pa);
+	to_affine(_pe, pa);
 
 	// Encode the affine point into bytes - encode returns void
-	encode(pa, rd.data());
+	encode_point(pa, rd.data());
 	return rd;
 }
 
 std::string Point::toString() const {
-	EccDataType brev;
-	EccDataType raw = getRaw(); // Handles normalization and encoding
-	// Apply byte reversal as per original logic for points
-	reverse_bytes(brev.data(), raw.data());
-	return bytes_to_hex_string(brev);
+	std::string out(kHexLength, '\0');
+	toHex(out.data());
+	return out;
 }
 
 void Point::fromString(const std::string& str) {
-	if (str.length() != 2 * ECC_KEY_LENGTH) {
-		throw std::invalid_argument("Invalid input point length: expected " + std::to_string(2 * ECC_KEY_LENGTH) + ", got " + std::to_string(str.length()));
+	fromHex(str);
+}
+
+void Point::toHex(char* out) const {
+	EccDataType raw = getRaw(); // Handles normalization and encoding
+	// Byte reversal as per original logic for points, done while encoding
+	hex_encode(raw, std::span<char>(out, kHexLength), true);
+}
+
+void Point::fromHex(std::string_view str) {
+	if (str.length() != kHexLength) {
+		throw std::invalid_argument("Invalid input point length: expected " + std::to_string(kHexLength) + ", got " + std::to_string(str.length()));
 	}
 
 	point_t pa;
-	EccDataType brev, btmp;
-
-	// Convert hex string to bytes, throws on error
-	hex_string_to_bytes(str, btmp);
+	EccDataType brev;
 
-	// Apply byte reversal for points
-	reverse_bytes(brev.data(), btmp.data());
+	// Hex to bytes with the byte reversal for points
+	if (!hex_decode(str, brev, true)) {
+		throw std::invalid_argument("Invalid hex character in point string");
+	}
 
 	// Decode bytes into affine point
+	FASTECC_STAT_SCOPE(Decode);
 	if (decode(brev.data(), pa) != ECCRYPTO_SUCCESS) {
 		throw std::runtime_error("Point decoding failed");
 	}
@@ -367,72 +588,76 @@ void Point::fromString(const std::string& str) {
 
 
 bool Point::isZero() const {
-	// No null check needed
+	// The identity (0, 1) in projective form: X == 0 and Y == Z
+	f2elm_t t;
+	fp2sub(_pe->y, _pe->z, t);
+	return fp2_is_zero(_pe->x) && fp2_is_zero(t);
+}
 
-	point_t normalized_point;
-	// Use a copy since eccnorm might modify the input (or needs non-const)
-	Point p_copy = *this;
-	eccnorm(p_copy._pe, normalized_point); // Pass the copy's _pe
+Point& Point::normalize() {
+	if (!isNormalized()) {
+		point_t pa;
+		to_affine(_pe, pa);
+		point_setup(pa, _pe);
+	}
+	return *this;
+}
 
-	// Get the canonical zero point (identity) in affine form (0, 1)
-	point_t normalized_canonical_zero;
-	fp2zero1271(normalized_canonical_zero->x); // x = 0
-	fp2zero1271(normalized_canonical_zero->y); // y = 0
-	normalized_canonical_zero->y[0][0] = 1;    // Set y = 1
+bool Point::isNormalized() const {
+	return fp2_is_one(_pe->z);
+}
 
-	// Compare affine coordinates using memcmp on underlying data
-	bool x_equal = (memcmp(normalized_point[0].x, normalized_canonical_zero[0].x, sizeof(f2elm_t)) == 0);
-	bool y_equal = (memcmp(normalized_point[0].y, normalized_canonical_zero[0].y, sizeof(f2elm_t)) == 0);
 
-	return x_equal && y_equal;
-	// Old memcmp method:
-	// return (memcmp(&normalized_point, &normalized_canonical_zero, sizeof(point_t)) == 0);
+Point& Point::operator+=(const Point& that) {
+	// R1_to_R2 + eccadd; reads 'that' in place, also when &that == this
+	add_r1(that._pe, _pe);
+	return *this;
 }
 
-
-Point& Point::operator=(const Point& b) {
-	if (this != &b) {
-		// Copy the array content
-		memcpy(_pe, b._pe, sizeof(point_extproj_t));
-	}
+Point& Point::operator-=(const Point& that) {
+	// P -= Q  <=>  P += (-Q), negating Q's R2 form instead of forming -Q
+	eccsub(that._pe, _pe);
 	return *this;
 }
 
-Point& Point::operator=(Point&& b) noexcept { // Ensure signature matches declaration
-	 if (this != &b) {
-		// "Move" is just a copy for array member
-		memcpy(_pe, b._pe, sizeof(point_extproj_t));
-	 }
-	 return *this;
+Point& Point::operator+=(const AddendCache& that) {
+	if (that._mixed) {
+		add_affine(&that._affine, _pe);
+	} else {
+		add_r2(&that._r2, _pe);
+	}
+	return *this;
 }
 
-Point& Point::operator+=(const Point& that) {
-	// No null check needed
-	// Precompute for addition as required by eccadd
-	point_extproj_precomp_t pthat_precomp;
-	// R1_to_R2 needs non-const point_extproj*, use a copy of 'that' if needed
-	Point that_copy = that;
-	R1_to_R2(that_copy._pe, pthat_precomp); // Pass copy
-	eccadd(pthat_precomp, _pe); // Pass _pe
+Point& Point::operator-=(const AddendCache& that) {
+	// Adds -Q, negating the cached form
+	if (that._mixed) {
+		point_precomp_t neg;
+		negate_affine(&that._affine, neg);
+		eccmadd(neg, _pe);
+	} else {
+		point_extproj_precomp_t neg;
+		negate_r2(&that._r2, neg);
+		eccadd(neg, _pe);
+	}
 	return *this;
 }
 
-Point& Point::operator-=(const Point& that) {
-	// P -= Q  <=>  P += (-Q)
-	*this += Point::negate(that);
+Point& Point::dbl() {
+	eccdouble(_pe);
 	return *this;
 }
 
 Point& Point::operator*=(const Scalar& b) {
+	FASTECC_STAT_SCOPE(Mul);
 	// No null check needed
 	point_t P_affine, Q_affine;
 
-	// Normalize the current point (_pe) to affine P_affine
-	eccnorm(_pe, P_affine); // Pass _pe
+	// Affine input for ecc_mul (no inversion if already normalized)
+	to_affine(_pe, P_affine);
 
 	// Perform scalar multiplication: Q_affine = b * P_affine
-	// ecc_mul expects digit_t*, need to cast away const from b._b.data()
-	if (!ecc_mul(P_affine, const_cast<digit_t*>(b._b.data()), Q_affine, false)) { // Use non-fixed base mul
+	if (!ecc_mul(P_affine, scalar_words(b._b), Q_affine, false)) { // Use non-fixed base mul
 		throw std::runtime_error("ecc_mul failed during Point::operator*=");
 	}
 
@@ -442,17 +667,16 @@ Point& Point::operator*=(const Scalar& b) {
 }
 
 Point Point::MulAdd(const Scalar& mG, const Scalar& mP) const {
+	 FASTECC_STAT_SCOPE(MulDouble);
 	 // No null check needed
 	 Point ret; // Result point
 	 point_t pthis_affine, pr_affine; // Affine representations
 
-	 // Normalize a copy of 'this' point to affine
-	 Point p_copy = *this;
-	 eccnorm(p_copy._pe, pthis_affine); // Use copy's _pe
+	 // Affine form of 'this' (no inversion if already normalized)
+	 to_affine(_pe, pthis_affine);
 
 	 // Perform double scalar multiplication: pr = mG*G + mP*pthis
-	 // ecc_mul_double expects digit_t*, need to cast away const
-	 if (!ecc_mul_double(const_cast<digit_t*>(mG._b.data()), pthis_affine, const_cast<digit_t*>(mP._b.data()), pr_affine)) {
+	 if (!ecc_mul_double(scalar_words(mG._b), pthis_affine, scalar_words(mP._b), pr_affine)) {
 		 throw std::runtime_error("ecc_mul_double failed in Point::MulAdd");
 	 }
 
@@ -465,8 +689,9 @@ Point Point::MulAdd(const Scalar& mG, const Scalar& mP) const {
 // --- Point Friend Operator Implementations ---
 
 bool operator==(const Point& lh, const Point& rh) {
-	// Compare normalized raw byte representations for semantic equality
-	return lh.getRaw() == rh.getRaw();
+	// (X1/Z1, Y1/Z1) == (X2/Z2, Y2/Z2) without inverting
+	return cross_equal(lh._pe->x, rh._pe->z, rh._pe->x, lh._pe->z) &&
+		cross_equal(lh._pe->y, rh._pe->z, rh._pe->y, lh._pe->z);
 }
 
 bool operator!=(const Point& lh, const Point& rh) {
@@ -491,6 +716,10 @@ Point operator+(const Point& lh, const Point& rh) {
 	return ret;
 }
 
+Point operator-(const Point& p) {
+	return Point::negate(p);
+}
+
 std::ostream& operator<<(std::ostream& out, const Point& ep) {
 	out << ep.toString(); // Use toString method
 	return out;
@@ -498,45 +727,22 @@ std::ostream& operator<<(std::ostream& out, const Point& ep) {
 
 // --- Point Static Method Implementations ---
 
-Scalar Point::getOrder() {
-	Scalar r;
-	// Copy the curve order from the FourQ constants
-	// Ensure curve_order is accessible (likely included via FourQ_internal.h or similar)
-	std::memcpy(r._b.data(), curve_order, sizeof(curve_order));
-	return r;
-}
-
-Point Point::getBase() {
-	point_t G0_affine;
-	Point bp;
-	eccset(G0_affine); // Correct usage for base point
-	point_setup(G0_affine, bp._pe); // Pass bp._pe
-	return bp;
-}
-
 Point Point::negate(const Point& p0) {
-	if (p0.isZero()) { // Optimization: Negation of zero is zero
-		return Point::getZero();
-	}
-	// Calculate -P as P * (order - 1)
-	Scalar minus_one;
-	subtract_mod_order(curve_order, Scalar(1)._b.data(), minus_one._b.data());
-	return minus_one * p0; // Reuse operator*(Scalar, Point)
+	// -(X, Y, Z, T) = (-X, Y, Z, -T), no scalar multiplication
+	Point ret = p0;
+	negate_extproj(ret._pe);
+	return ret;
 }
 
-Point Point::getZero() {
-	// Default constructor creates zero/identity
-	return Point();
-}
 
 Point Point::mulBase(const Scalar& b) {
+	FASTECC_STAT_SCOPE(MulBase);
 	point_t Q_affine; // Result in affine coordinates
 	Point ret;
 
 	// Perform fixed-base scalar multiplication: Q = b * G
-	// ecc_mul_fixed expects digit_t*, need to cast away const
-	if (!ecc_mul_fixed(const_cast<digit_t*>(b._b.data()), Q_affine)) {
-		 throw std::runtime_error("ecc_mul_fixed failed in Point::mulBase");
+	if (!detail::mul_fixed_base(b._b.data(), Q_affine)) {
+		 throw std::runtime_error("Fixed-base multiplication failed in Point::mulBase");
 	}
 
 	// Setup the result point's internal representation
@@ -553,18 +759,281 @@ bool operator<(const Point& lh, const Point& rh) {
 }
 
 
+// --- AddendCache Implementation ---
+
+AddendCache::AddendCache() : AddendCache(Point()) {}
+
+AddendCache::AddendCache(const Point& Q) {
+	r1_to_r2(Q._pe, &_r2);
+	_mixed = Q.isNormalized();
+	if (_mixed) {
+		// With Z = 1 the R2 form is (x+y, y-x, 2, 2dt): drop z2
+		fp2copy1271(_r2.xy, _affine.xy);
+		fp2copy1271(_r2.yx, _affine.yx);
+		fp2copy1271(_r2.t2, _affine.t2);
+	} else {
+		std::memset(&_affine, 0, sizeof(_affine));
+	}
+}
+
+AddendCache AddendCache::affine(const Point& Q) {
+	Point copy = Q;
+	return AddendCache(copy.normalize());
+}
+
+std::vector<AddendCache> AddendCache::affineBatch(std::span<const Point> points) {
+	std::vector<Point> normalized(points.begin(), points.end());
+	normalizeAll(normalized);
+	std::vector<AddendCache> out;
+	out.reserve(normalized.size());
+	for (const Point& P : normalized) {
+		out.emplace_back(P);
+	}
+	return out;
+}
+
+
+// --- Batch Normalization / Encoding ---
+
+void encodeAll(std::span<const Point> points, std::span<EccDataType> out) {
+	if (points.size() != out.size()) {
+		throw std::invalid_argument("encodeAll: points and out must have the same length");
+	}
+	detail::Scratch scratch;
+	auto affine = scratch.vector<point_affine>(points.size());
+	batch_to_affine(as_extproj(points), affine.data());
+	for (size_t i = 0; i < points.size(); i++) {
+		encode_point(&affine[i], out[i].data());
+	}
+}
+
+void normalizeAll(std::span<Point> points) {
+	detail::Scratch scratch;
+	auto affine = scratch.vector<point_affine>(points.size());
+	batch_to_affine(as_extproj(points), affine.data());
+	for (size_t i = 0; i < points.size(); i++) {
+		point_setup(&affine[i], reinterpret_cast<point_extproj*>(&points[i]));
+	}
+}
+
+
+// --- SchnorrQ ---
+
+namespace detail {
+
+void schnorrq_expand_key(const Scalar& secretKey, uint8_t* sk, uint8_t* pk, uint8_t* prefix, Point* pub)
+{
+	EccDataType skraw = secretKey.getRaw();
+	Point A = Point::mulBase(secretKey); // Normalized, so getRaw() does not invert
+	EccDataType pkraw = A.getRaw();
+	if (pub != nullptr) {
+		*pub = A;
+	}
+
+	// Nonce prefix: upper half of H(SecretKey), as in schnorrq_new.c
+	uint8_t kh[64];
+	Sha512::hash(skraw, kh);
+	std::memcpy(sk, skraw.data(), 32);
+	std::memcpy(pk, pkraw.data(), 32);
+	std::memcpy(prefix, kh + 32, 32);
+	clear_words(kh, 512 / (sizeof(unsigned int) * 8));
+	clear_words(skraw.data(), 256 / (sizeof(unsigned int) * 8));
+}
+
+// SchnorrQ signing core, mirroring SchnorrQ_Sign in schnorrq_new.c without the scratch
+// buffer: r = H(prefix || M), R = r*G, h = H(R || A || M), s = r - k*h mod order.
+// sk, prefix and pk are 32 bytes each; writes the 64-byte signature.
+bool schnorrq_sign(const uint8_t* sk, const uint8_t* prefix, const uint8_t* pk, std::span<const uint8_t> msg, uint8_t* sig)
+{
+	const SignRequest req{sk, prefix, pk, msg, sig};
+	bool ok = false;
+	schnorrq_sign_many({&req, 1}, &ok);
+	return ok;
+}
+
+void schnorrq_sign_many(std::span<const SignRequest> reqs, bool* ok)
+{
+	FASTECC_STAT_SCOPE_N(SchnorrQSign, reqs.size());
+	// Chunks keep the scratch on the stack; 16 fills two 8-lane hashMany rounds
+	constexpr size_t kChunk = 16;
+	std::array<Sha512::Message, kChunk> in;
+	std::array<Sha512::Digest, kChunk> r, h;
+
+	for (size_t base = 0; base < reqs.size(); base += kChunk) {
+		const size_t m = std::min(kChunk, reqs.size() - base);
+		const std::span<const SignRequest> chunk = reqs.subspan(base, m);
+
+		for (size_t j = 0; j < m; j++) {
+			in[j] = {std::span<const uint8_t>(chunk[j].prefix, 32), chunk[j].msg, {}};
+		}
+		Sha512::hashMany(std::span(in).first(m), std::span(r).first(m));
+
+		for (size_t j = 0; j < m; j++) {
+			digit_t rw[2 * NWORDS_ORDER];
+			point_t R;
+			std::memcpy(rw, r[j].data(), sizeof(rw));
+			ok[base + j] = mul_fixed_base(rw, R);
+			clear_words(rw, 512 / (sizeof(unsigned int) * 8));
+			if (ok[base + j]) {
+				encode_point(R, chunk[j].sig);
+				in[j] = {std::span<const uint8_t>(chunk[j].sig, 32), std::span<const uint8_t>(chunk[j].pk, 32), chunk[j].msg};
+			} else {
+				in[j] = {};
+			}
+		}
+		Sha512::hashMany(std::span(in).first(m), std::span(h).first(m));
+
+		for (size_t j = 0; j < m; j++) {
+			if (!ok[base + j]) {
+				continue;
+			}
+			digit_t k[NWORDS_ORDER], rw[2 * NWORDS_ORDER], hw[2 * NWORDS_ORDER], S[NWORDS_ORDER];
+			std::memcpy(k, chunk[j].sk, 32);
+			std::memcpy(rw, r[j].data(), sizeof(rw));
+			std::memcpy(hw, h[j].data(), sizeof(hw));
+			modulo_order(rw, rw);
+			modulo_order(hw, hw);
+			to_Montgomery(k, S);
+			to_Montgomery(hw, hw);
+			Montgomery_multiply_mod_order(S, hw, S);
+			from_Montgomery(S, S);
+			subtract_mod_order(rw, S, S);
+			std::memcpy(chunk[j].sig + 32, S, 32);
+			clear_words(k, 256 / (sizeof(unsigned int) * 8));
+			clear_words(rw, 512 / (sizeof(unsigned int) * 8));
+		}
+		clear_words(r.data(), (digit_t)(sizeof(r) / sizeof(unsigned int)));
+	}
+}
+
+} // namespace detail
+
+bool SchnorrQSign(const Scalar& secretKey, std::span<const uint8_t> msg, std::array<uint8_t, 64>& sig)
+{
+	if (msg.empty()) {
+		return false;
+	}
+	return SigningKey(secretKey).sign(msg, sig);
+}
+
+
+// --- SigningKey ---
+
+SigningKey::SigningKey(const Scalar& secretKey) {
+	detail::schnorrq_expand_key(secretKey, _sk.data(), _pk.data(), _prefix.data(), &_pub);
+}
+
+SigningKey::~SigningKey() {
+	clear_words(_sk.data(), 256 / (sizeof(unsigned int) * 8));
+	clear_words(_prefix.data(), 256 / (sizeof(unsigned int) * 8));
+}
+
+bool SigningKey::sign(std::span<const uint8_t> msg, std::array<uint8_t, 64>& sig) const
+{
+	if (msg.empty()) {
+		return false; // Same as SchnorrQSign
+	}
+	return detail::schnorrq_sign(_sk.data(), _prefix.data(), _pk.data(), msg, sig.data());
+}
+
+namespace {
+
+// Signs msgs[i] into sigs[i] and reports each result through record(i, ok). Empty messages
+// fail as in sign(); the rest share the multi-buffer hashing, in small groups on the stack
+// (as SchnorrQBatchEngine::sign does).
+template<typename F>
+bool sign_grouped(const uint8_t* sk, const uint8_t* prefix, const uint8_t* pk,
+	std::span<const std::span<const uint8_t>> msgs, std::span<std::array<uint8_t, 64>> sigs, const F& record)
+{
+	if (msgs.size() != sigs.size()) {
+		throw std::invalid_argument("SigningKey::signBatch: msgs and sigs must have the same length");
+	}
+	constexpr size_t kGroup = 16;
+	std::array<detail::SignRequest, kGroup> reqs;
+	std::array<size_t, kGroup> idx;
+	bool ok[kGroup];
+	size_t count = 0;
+	bool all = true;
+	const auto flush = [&] {
+		detail::schnorrq_sign_many(std::span(reqs).first(count), ok);
+		for (size_t j = 0; j < count; j++) {
+			record(idx[j], ok[j]);
+			all = all && ok[j];
+		}
+		count = 0;
+	};
+	for (size_t i = 0; i < msgs.size(); i++) {
+		if (msgs[i].empty()) {
+			all = false;
+			continue;
+		}
+		reqs[count] = {sk, prefix, pk, msgs[i], sigs[i].data()};
+		idx[count++] = i;
+		if (count == kGroup) {
+			flush();
+		}
+	}
+	flush();
+	return all;
+}
+
+} // anonymous namespace
+
+bool SigningKey::signBatch(std::span<const std::span<const uint8_t>> msgs,
+	std::span<std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results) const
+{
+	results.assign(msgs.size(), false);
+	return sign_grouped(_sk.data(), _prefix.data(), _pk.data(), msgs, sigs,
+		[&](size_t i, bool ok) { results[i] = ok; });
+}
+
+bool SigningKey::signBatch(std::span<const std::span<const uint8_t>> msgs,
+	std::span<std::array<uint8_t, 64>> sigs) const
+{
+	return sign_grouped(_sk.data(), _prefix.data(), _pk.data(), msgs, sigs, [](size_t, bool) {});
+}
+
+bool SchnorrQVerify(const Point& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig)
+{
+	FASTECC_STAT_SCOPE(SchnorrQVerify);
+	// Bit 128 of R must be clear and s < 2^246, as in SchnorrQ_Verify
+	if ((sig[15] & 0x80) != 0 || sig[63] != 0 || (sig[62] & 0xC0) != 0) {
+		return false;
+	}
+
+	// The key is already decoded and validated; encode it from the same affine form
+	point_t A;
+	EccDataType pkraw;
+	to_affine(pubkey._pe, A);
+	encode_point(A, pkraw.data());
+
+	// h = H(R || A || M)
+	digit_t h[2 * NWORDS_ORDER], s[NWORDS_ORDER];
+	Sha512 ctx;
+	ctx.update(std::span<const uint8_t>(sig.data(), 32)).update(pkraw).update(msg);
+	ctx.final(reinterpret_cast<uint8_t*>(h));
+	std::memcpy(s, sig.data() + 32, 32);
+
+	point_t R;
+	if (!ecc_mul_double(s, A, h, R)) {
+		return false;
+	}
+	EccDataType rraw;
+	encode_point(R, rraw.data());
+	return std::memcmp(rraw.data(), sig.data(), 32) == 0;
+}
+
 template<>
 bool SchnorrQSign(const Scalar& secretKey, const std::string& msg, std::array<uint8_t, 64>& sig)
 {
-	auto msgvector = std::vector<uint8_t>(msg.begin(), msg.end());
-	return SchnorrQSign(secretKey, msgvector, sig);
+	return SchnorrQSign(secretKey, detail::message_bytes(msg), sig);
 }
 
 template<>  
 bool SchnorrQVerify(const Point& pubkey, const std::string& msg, const std::array<uint8_t, 64>& sig)
 {
-	auto msgvector = std::vector<uint8_t>(msg.begin(), msg.end());
-	return SchnorrQVerify(pubkey, msgvector, sig);
+	return SchnorrQVerify(pubkey, detail::message_bytes(msg), sig);
 }
 
 bool SchnorrQSignMsg(const Scalar& secretKey, const std::vector<uint8_t>& msg, std::array<uint8_t, 64>& sig)
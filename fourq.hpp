@@ -2,8 +2,12 @@
 
 #include <array>    // for std::array
 #include <cstdint>  // for uint8_t, uint32_t, uint64_t
+#include <functional> // for std::function
 #include <iosfwd>   // for std::ostream forward declaration
+#include <span>     // for std::span
 #include <string>   // for std::string
+#include <string_view> // for std::string_view
+#include <type_traits> // for std::is_standard_layout_v, std::is_constant_evaluated
 #include <vector>   // for std::vector
 #include <cstring>
 
@@ -23,25 +27,185 @@ namespace FourQ {
 
 // Forward declare Point for Scalar's friend declaration
 class Point;
+class MontScalar;
+class PreparedPoint;
+class AddendCache;
+class PointView;
+
+// Whether variable-base scalar multiplication uses FourQ's endomorphisms (CMake FASTECC_USE_ENDO)
+#if defined(FASTECC_USE_ENDO)
+constexpr bool kUseEndomorphism = true;
+#else
+constexpr bool kUseEndomorphism = false;
+#endif
+
+// Field arithmetic backend the library was built with (CMake FASTECC_FIELD_BACKEND)
+enum class FieldBackend {
+	Portable,    // FourQ_64bit_and_portable C code (64-bit multiplies on x64 and AArch64)
+	X64Asm,      // FourQlib AMD64 assembly for fp2mul1271/fp2sqr1271
+	X64AsmMulx,  // Same, using MULX/ADCX/ADOX (BMI2 + ADX)
+};
+
+#if defined(FASTECC_FIELD_X64_ASM) && defined(FASTECC_FIELD_MULX_ADX)
+constexpr FieldBackend kFieldBackend = FieldBackend::X64AsmMulx;
+#elif defined(FASTECC_FIELD_X64_ASM)
+constexpr FieldBackend kFieldBackend = FieldBackend::X64Asm;
+#else
+constexpr FieldBackend kFieldBackend = FieldBackend::Portable;
+#endif
+
+#if defined(FASTECC_FIELD_AVX2)
+constexpr bool kUseAVX2 = true;
+#else
+constexpr bool kUseAVX2 = false;
+#endif
+
+// Fixed-base comb behind mulBase and SchnorrQ signing (CMake FASTECC_MULBASE_W/_V).
+// By default FourQlib's ecc_mul_fixed and its compiled-in W=5, V=5 table are used; with
+// the CMake values set, an in-tree constant-time comb with V*2^(W-1) precomputed points
+// (96 bytes each) is built on first use. Larger tables mean fewer additions per mulBase.
+#if defined(FASTECC_MULBASE_W) && defined(FASTECC_MULBASE_V)
+constexpr bool kMulBaseCustomComb = true;
+constexpr unsigned kMulBaseW = FASTECC_MULBASE_W;
+constexpr unsigned kMulBaseV = FASTECC_MULBASE_V;
+static_assert(kMulBaseW >= 2 && kMulBaseW <= 8 && kMulBaseV >= 1 && kMulBaseV <= 16, "FASTECC_MULBASE_W/_V out of range");
+#else
+constexpr bool kMulBaseCustomComb = false;
+constexpr unsigned kMulBaseW = W_FIXEDBASE;
+constexpr unsigned kMulBaseV = V_FIXEDBASE;
+#endif
+constexpr size_t kMulBaseTableBytes = (size_t)kMulBaseV * ((size_t)1 << (kMulBaseW - 1)) * sizeof(point_precomp);
+
+// CPU feature probe (implementation in fourq_cpu.cpp)
+struct CpuFeatures {
+	bool bmi2 = false;
+	bool adx = false;
+	bool avx2 = false; // Also requires OS support for YMM state
+	bool avx512f = false;    // Also requires OS support for ZMM and opmask state
+	bool avx512ifma = false; // AVX512F + AVX512IFMA
+};
+const CpuFeatures& cpuFeatures();
+
+// Whether this host can run the compiled-in backend (kFieldBackend/kUseAVX2).
+// Always true for the portable build; call it once at startup before touching
+// any FourQ function in an assembly build, which otherwise dies with SIGILL.
+bool fieldBackendSupported();
+const char* fieldBackendName();
 
 // Type Aliases
 typedef std::array<digit_t, NWORDS_ORDER> fourq_scalar_t;
 typedef std::array<uint8_t, ECC_KEY_LENGTH> EccDataType;
 
+// Characters written by toHex / expected by fromHex (no terminator)
+constexpr size_t kHexLength = 2 * ECC_KEY_LENGTH;
+
+namespace detail {
+
+static_assert(sizeof(digit_t) == 8 && NWORDS_ORDER == 4, "scalar words are 4 x 64 bits");
+
+// The group order N, as curve_order in FourQ_params.h (whose C arrays cannot be read in
+// constant expressions)
+inline constexpr fourq_scalar_t kOrderWords = {0x2FB2540EC7768CE7, 0xDFBD004DFE0F7999, 0xF05397829CBC14E5, 0x0029CBC14E5E0A72};
+
+// Bit-serial arithmetic mod N for constant expressions (about 256 additions per
+// multiplication); at run time the Scalar/MontScalar operators use FourQlib instead.
+// Inputs of add_mod, sub_mod and mul_mod are below N.
+namespace ct {
+
+constexpr bool geq(const fourq_scalar_t& a, const fourq_scalar_t& b) {
+	for (size_t i = NWORDS_ORDER; i-- > 0;) {
+		if (a[i] != b[i]) {
+			return a[i] > b[i];
+		}
+	}
+	return true;
+}
+
+// a - b for a >= b
+constexpr fourq_scalar_t sub(const fourq_scalar_t& a, const fourq_scalar_t& b) {
+	fourq_scalar_t r{};
+	digit_t borrow = 0;
+	for (size_t i = 0; i < NWORDS_ORDER; i++) {
+		const digit_t t = a[i] - b[i];
+		r[i] = t - borrow;
+		borrow = (digit_t)(a[i] < b[i]) | (digit_t)(t < borrow);
+	}
+	return r;
+}
+
+constexpr fourq_scalar_t add_mod(const fourq_scalar_t& a, const fourq_scalar_t& b) {
+	fourq_scalar_t r{};
+	digit_t carry = 0;
+	for (size_t i = 0; i < NWORDS_ORDER; i++) {
+		const digit_t t = a[i] + carry;
+		r[i] = t + b[i];
+		carry = (digit_t)(t < carry) | (digit_t)(r[i] < t);
+	}
+	return geq(r, kOrderWords) ? sub(r, kOrderWords) : r; // a + b < 2N < 2^256
+}
+
+constexpr fourq_scalar_t sub_mod(const fourq_scalar_t& a, const fourq_scalar_t& b) {
+	return geq(a, b) ? sub(a, b) : add_mod(a, sub(kOrderWords, b)); // a + (N - b) < N
+}
+
+// Any 256-bit value mod N
+constexpr fourq_scalar_t reduce(const fourq_scalar_t& a) {
+	fourq_scalar_t r{};
+	for (size_t i = 64 * NWORDS_ORDER; i-- > 0;) {
+		r = add_mod(r, r);
+		if ((a[i / 64] >> (i % 64)) & 1) {
+			r = add_mod(r, fourq_scalar_t{1, 0, 0, 0});
+		}
+	}
+	return r;
+}
+
+constexpr fourq_scalar_t mul_mod(const fourq_scalar_t& a, const fourq_scalar_t& b) {
+	fourq_scalar_t r{};
+	for (size_t i = 64 * NWORDS_ORDER; i-- > 0;) {
+		r = add_mod(r, r);
+		if ((b[i / 64] >> (i % 64)) & 1) {
+			r = add_mod(r, a);
+		}
+	}
+	return r;
+}
+
+// R = 2^256 mod N, the Montgomery form of 1
+constexpr fourq_scalar_t montgomery_r() {
+	const fourq_scalar_t half = reduce(fourq_scalar_t{0, 0, 0, (digit_t)1 << 63});
+	return add_mod(half, half);
+}
+
+} // namespace ct
+} // namespace detail
+
 // --- Scalar Class Declaration ---
 class Scalar {
 private:
 	friend class Point; // Point needs access to _b
+	friend class MontScalar;
+	friend class PreparedPoint;
 	fourq_scalar_t _b;
 
+	// Words already below the order, taken as they are
+	struct ReducedWords {};
+	constexpr Scalar(const fourq_scalar_t& w, ReducedWords) : _b(w) {}
+
 	// Internal conversion helpers (implementation in .cpp)
 	EccDataType toBytes(const fourq_scalar_t& w) const;
 	fourq_scalar_t toWords(const EccDataType& b) const;
 
+	// Run-time halves of the constexpr operations below (implementation in .cpp)
+	static Scalar addMod(const Scalar& lh, const Scalar& rh);
+	static Scalar subMod(const Scalar& lh, const Scalar& rh);
+	static Scalar mulMod(const Scalar& lh, const Scalar& rh);
+	static Scalar reduceWords(const fourq_scalar_t& w);
+
 public:
-	// Constructors (implementation in .cpp)
-	Scalar(uint32_t val = 0);
-	Scalar(const Scalar& br);
+	// Constructors (implementation in .cpp, except the constexpr ones)
+	constexpr Scalar(uint32_t val = 0) : _b{val, 0, 0, 0} {}
+	Scalar(const Scalar& br) = default;
 	Scalar(const std::string& ins);
 	Scalar(const EccDataType& val);
 
@@ -49,20 +213,22 @@ public:
 	EccDataType getRaw() const;
 	std::string toString() const;
 	void fromString(const std::string& ins);
+	// Allocation-free forms: toHex writes kHexLength chars, fromHex throws like fromString
+	void toHex(char* out) const;
+	void fromHex(std::string_view ins);
 	size_t Size() const;
 	bool isZero() const;
 	Scalar& Sanitize(); // Ensure scalar is in the correct range
 
 	// Assignment Operators (implementation in .cpp)
-	Scalar& operator=(const Scalar& b);
+	Scalar& operator=(const Scalar& b) = default;
 	Scalar& operator=(const std::string& ins);
 
 	// Comparison Operators (Inline for efficiency)
-	inline friend bool operator==(const Scalar& lh, const Scalar& rh) {
-		// Assuming fourq_scalar_t is POD and memcmp is appropriate
-		return memcmp(lh._b.data(), rh._b.data(), sizeof(fourq_scalar_t)) == 0;
+	inline friend constexpr bool operator==(const Scalar& lh, const Scalar& rh) {
+		return lh._b == rh._b; // Scalars are kept reduced, so equal values have equal words
 	}
-	inline friend bool operator!=(const Scalar& lh, const Scalar& rh) {
+	inline friend constexpr bool operator!=(const Scalar& lh, const Scalar& rh) {
 		 return !(lh == rh); // Reuse operator==
 	}
 	
@@ -72,10 +238,26 @@ public:
 		return memcmp(lh._b.data(), rh._b.data(), sizeof(fourq_scalar_t)) < 0;
 	}
 
-	// Arithmetic Friend Operators (declarations only, implementation in .cpp)
-	friend Scalar operator+(const Scalar& lh, const Scalar& rh);
-	friend Scalar operator-(const Scalar& lh, const Scalar& rh);
-	friend Scalar operator*(const Scalar& lh, const Scalar& rh);
+	// Arithmetic Friend Operators. +, - and * are constexpr: in a constant expression they
+	// use detail::ct, otherwise FourQlib (implementation in .cpp), with the same results.
+	friend constexpr Scalar operator+(const Scalar& lh, const Scalar& rh) {
+		if (std::is_constant_evaluated()) {
+			return Scalar(detail::ct::add_mod(lh._b, rh._b), ReducedWords{});
+		}
+		return addMod(lh, rh);
+	}
+	friend constexpr Scalar operator-(const Scalar& lh, const Scalar& rh) {
+		if (std::is_constant_evaluated()) {
+			return Scalar(detail::ct::sub_mod(lh._b, rh._b), ReducedWords{});
+		}
+		return subMod(lh, rh);
+	}
+	friend constexpr Scalar operator*(const Scalar& lh, const Scalar& rh) {
+		if (std::is_constant_evaluated()) {
+			return Scalar(detail::ct::mul_mod(lh._b, rh._b), ReducedWords{});
+		}
+		return mulMod(lh, rh);
+	}
 	friend Scalar operator/(const Scalar& lh, const Scalar& rh);
 
 	// Stream Operator (declaration only, implementation in .cpp)
@@ -83,11 +265,123 @@ public:
 
 	// Static Methods (implementation in .cpp)
 	static Scalar invert(const Scalar& b);
-	static Scalar negate(const Scalar& b);
-	static Scalar getZero();
+	static constexpr Scalar negate(const Scalar& b) {
+		return Scalar() - b;
+	}
+	static constexpr Scalar getZero() {
+		return Scalar();
+	}
+	// Little-endian words reduced mod the order, constexpr like the operators above
+	static constexpr Scalar fromWords(const fourq_scalar_t& w) {
+		if (std::is_constant_evaluated()) {
+			return Scalar(detail::ct::reduce(w), ReducedWords{});
+		}
+		return reduceWords(w);
+	}
+
+	// Compile-time constants (defined after the class)
+	static const Scalar kZero;
+	static const Scalar kOne;
+	static const Scalar kTwo;
+	static const Scalar kOrderMinusOne; // -1 mod order
+
+	// Inverts every element in place with a single modular inversion (Montgomery's
+	// trick, ~3 extra multiplications per element). Throws std::runtime_error, leaving
+	// the values untouched, if any of them is zero.
+	static void invertBatch(std::span<Scalar> values);
+
+	// Uniform nonzero scalars mod the group order, by rejection sampling over the
+	// per-thread CSPRNG (fourq_random.hpp). Throw std::runtime_error if the OS entropy
+	// source fails.
+	static Scalar random();
+	static void randomBatch(std::span<Scalar> out);
+};
+
+inline constexpr Scalar Scalar::kZero{0};
+inline constexpr Scalar Scalar::kOne{1};
+inline constexpr Scalar Scalar::kTwo{2};
+inline constexpr Scalar Scalar::kOrderMinusOne = Scalar::negate(Scalar::kOne);
+
+
+// --- MontScalar Class Declaration ---
+// A scalar kept in Montgomery form (a*R mod order). +, - and * stay in that domain, so a
+// chain of operations converts only when entering (MontScalar(Scalar)) and leaving
+// (toScalar()), instead of twice per multiplication as Scalar::operator* does.
+class MontScalar {
+private:
+	fourq_scalar_t _m;
+
+	struct MontgomeryWords {};
+	constexpr MontScalar(const fourq_scalar_t& m, MontgomeryWords) : _m(m) {}
+	static fourq_scalar_t toMontgomery(const Scalar& s); // Run-time half of MontScalar(Scalar)
+
+public:
+	constexpr MontScalar() : _m{} {} // Zero
+	// constexpr, so fixed constants can be converted at compile time (s * R by detail::ct);
+	// at run time one FourQlib to_Montgomery
+	explicit constexpr MontScalar(const Scalar& s)
+		: _m(std::is_constant_evaluated() ? detail::ct::mul_mod(s._b, detail::ct::montgomery_r()) : toMontgomery(s)) {}
+
+	Scalar toScalar() const;
+	bool isZero() const;
+
+	// Comparison Operators (Montgomery form is unique, so compare words)
+	inline friend constexpr bool operator==(const MontScalar& lh, const MontScalar& rh) {
+		return lh._m == rh._m;
+	}
+	inline friend constexpr bool operator!=(const MontScalar& lh, const MontScalar& rh) {
+		return !(lh == rh);
+	}
+
+	// Arithmetic (implementation in .cpp)
+	MontScalar& operator+=(const MontScalar& b);
+	MontScalar& operator-=(const MontScalar& b);
+	MontScalar& operator*=(const MontScalar& b);
+	friend MontScalar operator+(const MontScalar& lh, const MontScalar& rh);
+	friend MontScalar operator-(const MontScalar& lh, const MontScalar& rh);
+	friend MontScalar operator*(const MontScalar& lh, const MontScalar& rh);
+
+	// Static Methods (implementation in .cpp, except one())
+	static constexpr MontScalar one() {
+		return MontScalar(detail::ct::montgomery_r(), MontgomeryWords{});
+	}
+	static MontScalar invert(const MontScalar& b); // Throws std::runtime_error on zero
+	static void invertBatch(std::span<MontScalar> values); // Same contract as Scalar::invertBatch
 };
 
 
+namespace detail {
+
+// R1 forms (X, Y, Z, Ta, Tb) = (x, y, 1, x, y), as point_setup writes them: the identity
+// and G (GENERATOR_x/_y in FourQ_params.h, which are not usable in constant expressions)
+inline constexpr point_extproj kIdentityR1 = {
+	{{0, 0}, {0, 0}}, {{1, 0}, {0, 0}}, {{1, 0}, {0, 0}}, {{0, 0}, {0, 0}}, {{1, 0}, {0, 0}}};
+inline constexpr point_extproj kGeneratorR1 = {
+	{{0x286592AD7B3833AA, 0x1A3472237C2FB305}, {0x96869FB360AC77F6, 0x1E1F553F2878AA9C}},
+	{{0xB924A2462BCBB287, 0x0E3FEE9BA120785A}, {0x49A7C344844C8B5C, 0x6E1C4AF8630E0242}},
+	{{1, 0}, {0, 0}},
+	{{0x286592AD7B3833AA, 0x1A3472237C2FB305}, {0x96869FB360AC77F6, 0x1E1F553F2878AA9C}},
+	{{0xB924A2462BCBB287, 0x0E3FEE9BA120785A}, {0x49A7C344844C8B5C, 0x6E1C4AF8630E0242}}};
+
+} // namespace detail
+
+
+// --- Executor ---
+// A scheduler for the parallel entry points (Point::MultiMul with an Executor). run(n, task)
+// must call task(i) exactly once for every i in [0, n), on any threads and in any order, and
+// return once all of them have returned; an exception thrown by a task should be rethrown
+// by run(). concurrency is the number of tasks the executor runs at once and only sizes the
+// split of the work. Wrap an existing thread pool in one to share it.
+struct Executor {
+	unsigned concurrency = 1;
+	std::function<void(size_t, const std::function<void(size_t)>&)> run;
+
+	// A pool of threads - 1 workers, started here and kept until the last copy of the
+	// executor is destroyed; the calling thread takes part in every run(), and concurrent
+	// run() calls take turns. threads == 0 uses std::thread::hardware_concurrency().
+	static Executor threads(unsigned threads = 0);
+};
+
 // --- Point Class Declaration ---
 // Forward declare point_extproj struct if needed, though FourQ.h includes it
 // struct point_extproj; // Or rely on FourQ.h
@@ -97,11 +391,18 @@ class Point {
 private:
 	point_extproj_t _pe;
 
+	friend class PreparedPoint;
+	friend class AddendCache;
+	friend bool SchnorrQVerify(const Point& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+
+	constexpr explicit Point(const point_extproj& pe) : _pe{pe} {}
+
 public:
-	// Constructors (implementation in .cpp)
-	Point();
-	Point(const Point& that);
-	Point(Point&& that) noexcept; // Move constructor
+	// Constructors (implementation in .cpp, except the constexpr identity)
+	constexpr Point() : _pe{detail::kIdentityR1} {}
+	// Copies and moves are plain 160-byte copies (Point is trivially copyable)
+	Point(const Point& that) = default;
+	Point(Point&& that) noexcept = default;
 	Point(const std::string& str);
 	Point(const EccDataType& val);
 
@@ -112,67 +413,131 @@ public:
 	EccDataType getRaw() const;
 	std::string toString() const;
 	void fromString(const std::string& str);
-	bool isZero() const;
+	// Allocation-free forms: toHex writes kHexLength chars, fromHex throws like fromString
+	void toHex(char* out) const;
+	void fromHex(std::string_view str);
+	bool isZero() const; // Projective check, no inversion
 
-	// Assignment Operators (implementation in .cpp)
-	Point& operator=(const Point& b);
-	Point& operator=(Point&& b) noexcept; // Move assignment
+	// Points stay in extended projective form; getRaw/toString, operator*= and MulAdd
+	// normalize on demand. normalize() does it once in place (one inversion) so that
+	// later calls on the same point skip it. isNormalized() is true when Z == 1.
+	Point& normalize();
+	bool isNormalized() const;
+
+	// Assignment Operators
+	Point& operator=(const Point& b) = default;
+	Point& operator=(Point&& b) noexcept = default;
 
 	// Compound Assignment Operators (implementation in .cpp)
 	Point& operator+=(const Point& that);
 	Point& operator-=(const Point& that);
 	Point& operator*=(const Scalar& b);
+	// Adding a cached addend skips its R1_to_R2 conversion (and uses mixed addition when
+	// the addend was cached in affine form), see AddendCache
+	Point& operator+=(const AddendCache& that);
+	Point& operator-=(const AddendCache& that);
+
+	// In-place doubling (eccdouble), cheaper than P += P
+	Point& dbl();
 
 	// Special Operations (implementation in .cpp)
 	Point MulAdd(const Scalar& mG, const Scalar& mP) const; // Note: Added const
 
+	// Multi-scalar multiplication: sum(scalars[i] * points[i]) (implementation in fourq_msm.cpp)
+	// Straus for small inputs, Pippenger buckets for large ones. Variable time, so only
+	// use it on public data. Throws std::invalid_argument if the lengths differ.
+	static Point MultiMul(std::span<const Scalar> scalars, std::span<const Point> points);
+	// Same sum, spread over the executor for large inputs (Pippenger with the work split into
+	// bucket windows x point ranges, see fourq_msm.cpp). Smaller inputs, or an executor with
+	// concurrency 1, take the single-threaded path.
+	static Point MultiMul(std::span<const Scalar> scalars, std::span<const Point> points, const Executor& executor);
+
 	// Comparison Operators (declarations only, implementation in .cpp)
-	// Pointer comparison is likely wrong, implement comparison logic in cpp
+	// == and != compare projectively (X1*Z2 == X2*Z1, Y1*Z2 == Y2*Z1), no inversion
 	friend bool operator==(const Point& lh, const Point& rh);
 	friend bool operator!=(const Point& lh, const Point& rh);
 	
-	// 添加operator<运算符，用于支持std::set排序
+	// 添加operator<运算符，用于支持std::set排序（按编码比较，需要规范化）
 	friend bool operator<(const Point& lh, const Point& rh);
 
 	// Arithmetic Friend Operators (declarations only, implementation in .cpp)
 	friend Point operator*(const Scalar& b, const Point& ep);
 	friend Point operator-(const Point& lh, const Point& rh);
 	friend Point operator+(const Point& lh, const Point& rh);
+	friend Point operator-(const Point& p); // Same as negate(p)
 
 	// Stream Operator (declaration only, implementation in .cpp)
 	friend std::ostream& operator<<(std::ostream& out, const Point& ep);
 
 	// Static Methods (implementation in .cpp)
-	static Scalar getOrder();
-	static Point getBase();
-	static Point negate(const Point& p0);
-	static Point getZero();
+	// The order itself (not reduced, so not usable as a Scalar operand)
+	static constexpr Scalar getOrder() {
+		return Scalar(detail::kOrderWords, Scalar::ReducedWords{});
+	}
+	static constexpr Point getBase() { // Constant G, no eccset/point_setup
+		return Point(detail::kGeneratorR1);
+	}
+	static Point negate(const Point& p0); // Negates X and T, no scalar multiplication
+	static constexpr Point getZero() {
+		return Point();
+	}
 	static Point mulBase(const Scalar& b);
 };
 
+// --- AddendCache Class Declaration ---
+// A point kept in the form the addition formulas consume, for points that are added many
+// times (e.g. Pedersen generators). Built from an arbitrary point it holds the R2 form
+// (X+Y, Y-X, 2Z, 2dT) and P += it is one eccadd without the R1_to_R2 conversion. Built
+// from a normalized point (Z == 1), or through affine()/affineBatch(), it holds the affine
+// (x+y, y-x, 2dt) form and P += it is a mixed addition (eccmadd), which also saves the
+// multiplication by Z. Subtraction negates the cached form (swap, negate 2dt) for free.
+class AddendCache {
+private:
+	point_extproj_precomp _r2;  // Used when !_mixed
+	point_precomp _affine;      // Used when _mixed
+	bool _mixed;
+
+	friend class Point;
+	friend class PointView; // Precomputed key store records are this affine form
+
+public:
+	AddendCache(); // Identity
+	explicit AddendCache(const Point& Q);
+
+	// Normalizes a copy of Q first (one field inversion) to get the mixed-addition form
+	static AddendCache affine(const Point& Q);
+	// Same for many points, sharing a single inversion (see normalizeAll)
+	static std::vector<AddendCache> affineBatch(std::span<const Point> points);
+
+	bool isMixed() const { return _mixed; }
+};
+
+namespace detail {
+// Any contiguous container or view (std::string, std::vector<uint8_t>, std::span, ...) as bytes
+template<typename T>
+std::span<const uint8_t> message_bytes(const T& msg)
+{
+    return std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(msg.data()), msg.size() * sizeof(*msg.data()));
+}
+} // namespace detail
+
+// SchnorrQ over a byte span (implementation in fourq.cpp). R, A and the message are fed
+// to an incremental SHA-512 in place, so there is no heap allocation, no message copy,
+// and no unsigned int length limit. Same signatures as the C SchnorrQ_Sign/SchnorrQ_Verify.
+// As before, signing an empty message returns false.
+bool SchnorrQSign(const Scalar& secretKey, std::span<const uint8_t> msg, std::array<uint8_t, 64>& sig);
+bool SchnorrQVerify(const Point& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+
 template<typename T>
 bool SchnorrQSign(const Scalar& secretKey, const T& msg, std::array<uint8_t, 64>& sig)
 {
-    auto skraw = secretKey.getRaw();
-    auto pubkey = Point::mulBase(secretKey);
-    auto pkraw = pubkey.getRaw();
-
-    if (msg.size() == 0) {
-        return false;
-    }
-    
-    auto sret = ::SchnorrQ_Sign(skraw.data(), pkraw.data(), msg.data(), (unsigned int)msg.size(), sig.data());
-    //auto sret = ::SchnorrQ_Sign(secretKey._b.data(), pkraw.data(), msg.data(), msg.size(), sig.data());
-    return sret == ECCRYPTO_SUCCESS;
+    return SchnorrQSign(secretKey, detail::message_bytes(msg), sig);
 }
 
 template<typename T>
 bool SchnorrQVerify(const Point& pubkey, const T& msg, const std::array<uint8_t, 64>& sig)
 {
-    unsigned int valid = 0;
-    auto pkraw = pubkey.getRaw();
-    auto vret = ::SchnorrQ_Verify(pkraw.data(), msg.data(), (unsigned int)msg.size(), sig.data(), &valid);
-    return vret == ECCRYPTO_SUCCESS && valid;
+    return SchnorrQVerify(pubkey, detail::message_bytes(msg), sig);
 }
 
 // 显式特例化声明（实现在.cpp中）
@@ -186,9 +551,136 @@ bool SchnorrQVerify<std::string>(const Point& pubkey, const std::string& msg, co
 bool SchnorrQSignMsg(const Scalar& secretKey, const std::vector<uint8_t>& msg, std::array<uint8_t, 64>& sig);
 bool SchnorrQVerifyMsg(const Point& pubkey, const std::vector<uint8_t>& msg, const std::array<uint8_t, 64>& sig);
 
+// --- SigningKey Class Declaration ---
+// A SchnorrQ secret key expanded once: the encoded scalar, the public key A = k*G (as a
+// point and encoded) and the nonce prefix. sign() then costs one fixed-base multiplication
+// and two hashes, where SchnorrQSign(Scalar, ...) also recomputes A on every call.
+// Signatures are identical to SchnorrQSign's. The secret material is cleared on
+// destruction (implementation in fourq.cpp).
+class SigningKey {
+private:
+	std::array<uint8_t, 32> _sk, _prefix;
+	EccDataType _pk;
+	Point _pub;
+
+public:
+	explicit SigningKey(const Scalar& secretKey);
+	SigningKey(const SigningKey&) = default;
+	SigningKey& operator=(const SigningKey&) = default;
+	~SigningKey();
+
+	const Point& publicKey() const { return _pub; }
+	const EccDataType& publicKeyRaw() const { return _pk; }
+
+	// Same contract as SchnorrQSign: an empty message returns false
+	bool sign(std::span<const uint8_t> msg, std::array<uint8_t, 64>& sig) const;
+
+	template<typename T>
+	bool sign(const T& msg, std::array<uint8_t, 64>& sig) const
+	{
+	    return sign(detail::message_bytes(msg), sig);
+	}
+
+	// sigs[i] = signature of msgs[i]; results[i] is sign()'s return value, and the function
+	// returns true iff all of them succeeded. For many threads see SchnorrQBatchEngine.
+	// Throws std::invalid_argument if the spans differ in length.
+	bool signBatch(std::span<const std::span<const uint8_t>> msgs,
+		std::span<std::array<uint8_t, 64>> sigs,
+		std::vector<bool>& results) const;
+	bool signBatch(std::span<const std::span<const uint8_t>> msgs,
+		std::span<std::array<uint8_t, 64>> sigs) const;
+};
+
+// Batch verification (implementation in schnorrq_batch.cpp)
+// Checks sum(z_i * (s_i*G + h_i*A_i - R_i)) == 0 for random 128-bit z_i with a single
+// multi-scalar multiplication. If the combined check fails, every signature is verified
+// individually and results[i] is then SchnorrQVerify's answer for each.
+// Not exact: the check is not cofactored, and FourQ's cofactor is 392 = 2^3 * 7^2. A
+// signature whose R (bytes chosen by the signer) or key A has a small-order component
+// always fails SchnorrQVerify, but the components of several such signatures can cancel
+// in the sum. Each z_i is a unit mod 392, so a lone signature with such an R is always
+// caught; A's coefficient z_i*h_i is reduced mod N and gives no such guarantee for a
+// crafted key, and two or more crafted signatures can pass together, depending on the
+// construction with up to certainty. Those are then reported valid, and whether they
+// pass may differ between calls, so verifiers that must agree on every signature
+// (consensus) should use SchnorrQVerify, or BatchVerification::Exact in
+// SchnorrQBatchEngine / AsyncVerifier. Keys from mulBase and honestly generated
+// signatures have no small-order components.
+// Throws std::invalid_argument if the three spans differ in length.
+bool SchnorrQVerifyBatch(std::span<const Point> pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results);
+bool SchnorrQVerifyBatch(std::span<const Point> pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs);
+
+// How the batch verifiers (SchnorrQBatchEngine, AsyncVerifier) check a batch
+enum class BatchVerification {
+	Combined, // SchnorrQVerifyBatch: one multi-scalar multiplication, not exact (see above)
+	Exact,    // SchnorrQVerify on every signature: same answer as verifying one by one
+};
+
+// --- PreparedPoint Class Declaration ---
+// A long-lived point (e.g. a hot public key) together with its encoding and a Lim-Lee
+// comb table, so that repeated k*P / MulAdd / SchnorrQ verification against it skip the
+// decode and the per-call precomputation (implementation in fourq_prepared.cpp).
+// The comb splits a 246-bit scalar into `teeth` rows of a = ceil(246/teeth) bits and each
+// row into `tables` blocks of b = ceil(a/tables) bits; it stores tables*(2^teeth - 1)
+// points (128 bytes each) and evaluates k*P with b doublings and about 246/teeth
+// additions. The default (5, 2) is 62 points (~8 KB) per key.
+// Scalar multiplications here are variable time: use only with public scalars.
+class PreparedPoint {
+private:
+	Point _p;
+	EccDataType _raw;
+	unsigned _teeth, _tables, _rows, _block;
+	std::vector<point_extproj_precomp> _table; // _table[v*(2^teeth - 1) + u - 1] = T_v[u]
+
+	void comb(const fourq_scalar_t& k, point_extproj_t R) const;
+
+public:
+	// Throws std::invalid_argument unless 1 <= teeth <= 8 and 1 <= tables <= 8
+	explicit PreparedPoint(const Point& P, unsigned teeth = 5, unsigned tables = 2);
+
+	const Point& point() const { return _p; }
+	const EccDataType& getRaw() const { return _raw; }
+	size_t tableSize() const { return _table.size(); }
+
+	Point mul(const Scalar& k) const;                          // k*P
+	Point MulAdd(const Scalar& mG, const Scalar& mP) const;    // mG*G + mP*P, like Point::MulAdd
+};
+
+// SchnorrQ verification against a prepared public key (implementation in fourq_prepared.cpp).
+// Same result as SchnorrQVerify(pubkey.point(), msg, sig).
+bool SchnorrQVerify(const PreparedPoint& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+
+template<typename T>
+bool SchnorrQVerify(const PreparedPoint& pubkey, const T& msg, const std::array<uint8_t, 64>& sig)
+{
+    return SchnorrQVerify(pubkey, detail::message_bytes(msg), sig);
+}
+
+// Batch normalization and encoding (implementation in fourq.cpp)
+// All points share a single field inversion (Montgomery's trick) instead of one each.
+// encodeAll writes points[i].getRaw() to out[i]; normalizeAll normalizes every point in
+// place. encodeAll throws std::invalid_argument if the spans differ in length.
+void encodeAll(std::span<const Point> points, std::span<EccDataType> out);
+void normalizeAll(std::span<Point> points);
+
 // --- Collection Typedefs ---
 typedef std::vector<Scalar> Scalars;
+typedef std::vector<MontScalar> MontScalars;
 typedef std::vector<Point> Points;
 
+// Point and Scalar wrap exactly one C object each, so spans of them can be handed to the
+// C-level code as arrays of point_extproj / fourq_scalar_t without copying
+static_assert(std::is_standard_layout_v<Point> && sizeof(Point) == sizeof(point_extproj), "Point layout");
+static_assert(std::is_standard_layout_v<Scalar> && sizeof(Scalar) == sizeof(fourq_scalar_t), "Scalar layout");
+static_assert(std::is_standard_layout_v<MontScalar> && sizeof(MontScalar) == sizeof(fourq_scalar_t), "MontScalar layout");
+// ... and they can be copied around in bulk (memcpy, std::vector growth) like the C structs
+static_assert(std::is_trivially_copyable_v<Point> && std::is_trivially_copyable_v<Scalar>, "Point/Scalar copies");
+static_assert(std::is_trivially_copyable_v<MontScalar>, "MontScalar copies");
+
 } // namespace FourQ
 } // namespace Curve
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "fourq_async_verifier.hpp"
+#include "fourq_decode_cache.hpp"
+#include "fourq_internal.hpp"
+
+#include <algorithm> // For std::min
+#include <stdexcept> // For std::invalid_argument, std::runtime_error
+
+
+namespace Curve {
+namespace FourQ {
+
+AsyncVerifier::AsyncVerifier(const Options& options)
+	: _options(options)
+{
+	if (options.maxBatch == 0 || options.maxQueue == 0) {
+		throw std::invalid_argument("AsyncVerifier: maxBatch and maxQueue must be positive");
+	}
+	unsigned threads = options.threads;
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads == 0) {
+		threads = 1; // hardware_concurrency() may not know
+	}
+	_workers.reserve(threads);
+	for (unsigned id = 0; id < threads; id++) {
+		_workers.emplace_back(&AsyncVerifier::workerLoop, this);
+	}
+}
+
+AsyncVerifier::~AsyncVerifier() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_work.notify_all();
+	_space.notify_all();
+	for (std::thread& t : _workers) {
+		t.join();
+	}
+}
+
+
+// --- Submission ---
+
+AsyncVerifier::Request AsyncVerifier::makeRequest(const EccDataType& pubkey, std::span<const uint8_t> msg,
+	const std::array<uint8_t, 64>& sig)
+{
+	Request r;
+	r.pubkey = pubkey;
+	r.msg.assign(msg.begin(), msg.end());
+	r.sig = sig;
+	return r;
+}
+
+// Nothing here touches the request after it is queued: a worker may resolve it (and resume
+// the coroutine owning it) as soon as the lock is released
+bool AsyncVerifier::enqueue(Request&& request, bool block) {
+	std::unique_lock<std::mutex> lock(_mutex);
+	if (block) {
+		_space.wait(lock, [&] { return _stop || _queue.size() < _options.maxQueue; });
+	}
+	if (_stop) {
+		throw std::runtime_error("AsyncVerifier: submission during shutdown");
+	}
+	if (_queue.size() >= _options.maxQueue) {
+		_stats.rejected++;
+		return false;
+	}
+	request.queued = std::chrono::steady_clock::now();
+	_queue.push_back(std::move(request));
+	_stats.submitted++;
+	// The first entry starts a deadline and a full batch can go at once; anything else
+	// only makes the pending batch larger
+	const bool wake = _queue.size() == 1 || _queue.size() % _options.maxBatch == 0;
+	lock.unlock();
+	if (wake) {
+		_work.notify_one();
+	}
+	return true;
+}
+
+std::future<bool> AsyncVerifier::submit(const EccDataType& pubkey, std::span<const uint8_t> msg,
+	const std::array<uint8_t, 64>& sig)
+{
+	Request r = makeRequest(pubkey, msg, sig);
+	std::future<bool> result = r.promise.get_future();
+	enqueue(std::move(r), true);
+	return result;
+}
+
+std::optional<std::future<bool>> AsyncVerifier::trySubmit(const EccDataType& pubkey, std::span<const uint8_t> msg,
+	const std::array<uint8_t, 64>& sig)
+{
+	Request r = makeRequest(pubkey, msg, sig);
+	std::future<bool> result = r.promise.get_future();
+	if (!enqueue(std::move(r), false)) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+AsyncVerifier::Awaitable AsyncVerifier::verify(const EccDataType& pubkey, std::span<const uint8_t> msg,
+	const std::array<uint8_t, 64>& sig)
+{
+	return Awaitable(*this, makeRequest(pubkey, msg, sig));
+}
+
+void AsyncVerifier::Awaitable::await_suspend(std::coroutine_handle<> waiter) {
+	_request.waiter = waiter;
+	_request.result = &_result;
+	_request.error = &_error;
+	_verifier->enqueue(std::move(_request), true);
+}
+
+bool AsyncVerifier::Awaitable::await_resume() const {
+	if (_error) {
+		std::rethrow_exception(_error);
+	}
+	return _result;
+}
+
+size_t AsyncVerifier::pending() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _queue.size();
+}
+
+AsyncVerifier::Stats AsyncVerifier::stats() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+	return _stats;
+}
+
+
+// --- Workers ---
+
+void AsyncVerifier::workerLoop() {
+	std::vector<Request> batch;
+	batch.reserve(_options.maxBatch);
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (;;) {
+		if (_queue.empty()) {
+			if (_stop) {
+				return;
+			}
+			_work.wait(lock);
+			continue;
+		}
+		// A partial batch waits for more until its oldest entry is due; at shutdown it
+		// goes at once
+		if (_queue.size() < _options.maxBatch && !_stop) {
+			const auto due = _queue.front().queued + _options.maxDelay;
+			if (std::chrono::steady_clock::now() < due) {
+				_work.wait_until(lock, due);
+				continue;
+			}
+		}
+		const size_t n = std::min(_queue.size(), _options.maxBatch);
+		for (size_t i = 0; i < n; i++) {
+			batch.push_back(std::move(_queue.front()));
+			_queue.pop_front();
+		}
+		_stats.batches++;
+		const bool more = !_queue.empty();
+		lock.unlock();
+		_space.notify_all();
+		if (more) {
+			_work.notify_one(); // Another worker can start on the rest
+		}
+		run(batch);
+		batch.clear();
+		lock.lock();
+	}
+}
+
+void AsyncVerifier::run(std::vector<Request>& batch) {
+	const size_t n = batch.size();
+	detail::Scratch scratch;
+	auto valid = scratch.vector<uint8_t>(n);
+	std::exception_ptr error;
+	try {
+		auto jobs = scratch.vector<size_t>();
+		auto pubkeys = scratch.vector<Point>();
+		auto msgs = scratch.vector<std::span<const uint8_t>>();
+		auto sigs = scratch.vector<std::array<uint8_t, 64>>();
+		jobs.reserve(n);
+		pubkeys.reserve(n);
+		msgs.reserve(n);
+		sigs.reserve(n);
+		for (size_t i = 0; i < n; i++) {
+			Point A;
+			bool decoded = false;
+			if (_options.cache != nullptr) {
+				decoded = _options.cache->tryDecode(batch[i].pubkey, A);
+			} else {
+				try {
+					A = Point(batch[i].pubkey);
+					decoded = true;
+				} catch (const std::runtime_error&) {
+					// Not a point on the curve: the signature is invalid
+				}
+			}
+			if (decoded) {
+				jobs.push_back(i);
+				pubkeys.push_back(A);
+				msgs.push_back(batch[i].msg);
+				sigs.push_back(batch[i].sig);
+			}
+		}
+		thread_local std::vector<bool> results; // Keeps its capacity across batches
+		if (_options.verification == BatchVerification::Exact) {
+			results.assign(jobs.size(), false);
+			for (size_t j = 0; j < jobs.size(); j++) {
+				results[j] = SchnorrQVerify(pubkeys[j], msgs[j], sigs[j]);
+			}
+		} else if (!jobs.empty()) {
+			SchnorrQVerifyBatch(pubkeys, msgs, sigs, results);
+		}
+		for (size_t j = 0; j < jobs.size(); j++) {
+			valid[jobs[j]] = results[j];
+		}
+	} catch (...) {
+		error = std::current_exception();
+	}
+
+	// Futures first: a resumed coroutine runs caller code on this thread for as long as it
+	// likes, which must not hold up the rest of the batch
+	for (size_t i = 0; i < n; i++) {
+		if (batch[i].waiter) {
+			continue;
+		}
+		if (error) {
+			batch[i].promise.set_exception(error);
+		} else {
+			batch[i].promise.set_value(valid[i] != 0);
+		}
+	}
+	for (size_t i = 0; i < n; i++) {
+		if (batch[i].waiter) {
+			*batch[i].result = valid[i] != 0;
+			*batch[i].error = error;
+			batch[i].waiter.resume();
+		}
+	}
+}
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,127 @@
+#pragma once // 头文件保护
+
+// Asynchronous SchnorrQ verification in micro-batches.
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+class DecodeCache;
+
+// --- AsyncVerifier Class Declaration ---
+// Front end for callers that must not block on verification, e.g. RPC handlers
+// (implementation in fourq_async_verifier.cpp). Submissions wait in a bounded queue.
+// A worker takes up to maxBatch of them as soon as that many are queued, or once the
+// oldest has waited maxDelay, and checks them with one SchnorrQVerifyBatch; each
+// submission then gets its own result (false for a key that does not decode). With
+// Options::verification = Exact every signature is checked on its own and the result is
+// SchnorrQVerify(Point(pubkey), msg, sig); the default Combined can accept crafted
+// signatures with small-order components (see SchnorrQVerifyBatch). A submission waits
+// at most about maxDelay plus one batch verification before a worker picks it up, and
+// the queue never holds more than maxQueue entries: submit() blocks while it is full,
+// trySubmit() fails.
+class AsyncVerifier {
+public:
+	struct Options {
+		size_t maxBatch = 64;                     // Signatures per SchnorrQVerifyBatch call
+		std::chrono::microseconds maxDelay{200};  // Longest a partial batch waits for more
+		size_t maxQueue = 4096;                   // Queued submissions not yet taken by a worker
+		unsigned threads = 1;                     // Workers; 0 uses hardware_concurrency()
+		DecodeCache* cache = nullptr;             // Optional, must outlive the verifier
+		BatchVerification verification = BatchVerification::Combined; // Exact: SchnorrQVerify each
+	};
+
+	struct Stats {
+		uint64_t submitted = 0; // Accepted into the queue
+		uint64_t rejected = 0;  // trySubmit() calls that found the queue full
+		uint64_t batches = 0;   // SchnorrQVerifyBatch calls (one per dispatched batch)
+	};
+
+	class Awaitable;
+
+	AsyncVerifier() : AsyncVerifier(Options{}) {}
+	// Throws std::invalid_argument if maxBatch or maxQueue is 0
+	explicit AsyncVerifier(const Options& options);
+	// Verifies and resolves everything still queued, then stops the workers. No submit()
+	// may run concurrently with the destructor.
+	~AsyncVerifier();
+
+	AsyncVerifier(const AsyncVerifier&) = delete;
+	AsyncVerifier& operator=(const AsyncVerifier&) = delete;
+
+	// The message is copied. Blocks while the queue is full (backpressure).
+	std::future<bool> submit(const EccDataType& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+	// Never blocks: std::nullopt if the queue is full
+	std::optional<std::future<bool>> trySubmit(const EccDataType& pubkey, std::span<const uint8_t> msg,
+		const std::array<uint8_t, 64>& sig);
+	// co_await verifier.verify(...) for coroutines: queued when awaited (blocking like
+	// submit() while the queue is full), and resumed on a worker thread with the result
+	Awaitable verify(const EccDataType& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+
+	size_t pending() const; // Queued, not yet taken by a worker
+	Stats stats() const;
+	const Options& options() const { return _options; }
+
+private:
+	struct Request {
+		EccDataType pubkey;
+		std::vector<uint8_t> msg;
+		std::array<uint8_t, 64> sig;
+		std::chrono::steady_clock::time_point queued;
+		// Either a future's promise (submit) or a suspended coroutine (verify)
+		std::promise<bool> promise;
+		std::coroutine_handle<> waiter;
+		bool* result = nullptr;
+		std::exception_ptr* error = nullptr;
+	};
+
+	static Request makeRequest(const EccDataType& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+	bool enqueue(Request&& request, bool block);
+	void workerLoop();
+	void run(std::vector<Request>& batch);
+
+	Options _options;
+	mutable std::mutex _mutex;
+	std::condition_variable _work;  // Workers: new submissions, or shutdown
+	std::condition_variable _space; // Blocked submitters: the queue shrank
+	std::deque<Request> _queue;
+	Stats _stats;
+	bool _stop = false;
+	std::vector<std::thread> _workers;
+
+public:
+	class Awaitable {
+	public:
+		bool await_ready() const noexcept { return false; }
+		void await_suspend(std::coroutine_handle<> waiter);
+		bool await_resume() const; // Rethrows if the verification itself failed (e.g. bad_alloc)
+
+	private:
+		friend class AsyncVerifier;
+		Awaitable(AsyncVerifier& verifier, Request&& request) : _verifier(&verifier), _request(std::move(request)) {}
+
+		AsyncVerifier* _verifier;
+		Request _request;
+		bool _result = false;
+		std::exception_ptr _error;
+	};
+};
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,165 @@
+#include "fourq_batch_engine.hpp"
+#include "fourq_decode_cache.hpp"
+#include "fourq_schnorrq.hpp"
+
+#include <algorithm> // For std::sort
+#include <cstring>   // For memcmp
+#include <numeric>   // For std::iota
+#include <stdexcept> // For std::invalid_argument, std::runtime_error
+
+
+namespace Curve {
+namespace FourQ {
+
+SchnorrQBatchEngine::SchnorrQBatchEngine(unsigned threads, size_t shardSize)
+	: _shardSize(shardSize), _pool(threads)
+{
+	if (shardSize == 0) {
+		throw std::invalid_argument("SchnorrQBatchEngine: shardSize must be positive");
+	}
+	_scratch.resize(_pool.threads());
+}
+
+SchnorrQBatchEngine::~SchnorrQBatchEngine() = default;
+
+
+// --- Pool ---
+
+void SchnorrQBatchEngine::parallelFor(size_t ntasks, const std::function<void(size_t, Scratch&)>& task) {
+	_pool.run(ntasks, [&](size_t t, unsigned id) { task(t, _scratch[id]); });
+}
+
+size_t SchnorrQBatchEngine::groupKeys(size_t n, const std::function<bool(size_t, size_t)>& less) {
+	_order.resize(n);
+	std::iota(_order.begin(), _order.end(), (size_t)0);
+	std::sort(_order.begin(), _order.end(), less);
+
+	_keyOf.resize(n);
+	_firstJob.clear();
+	for (size_t k = 0; k < n; k++) {
+		const size_t i = _order[k];
+		if (k == 0 || less(_order[k - 1], i)) {
+			_firstJob.push_back(i);
+		}
+		_keyOf[i] = _firstJob.size() - 1;
+	}
+	return _firstJob.size();
+}
+
+
+// --- Batches ---
+
+std::vector<bool> SchnorrQBatchEngine::sign(std::span<const SignJob> jobs, std::span<std::array<uint8_t, 64>> sigs) {
+	const size_t n = jobs.size();
+	if (sigs.size() != n) {
+		throw std::invalid_argument("SchnorrQBatchEngine::sign: jobs and sigs must have the same length");
+	}
+	std::lock_guard<std::mutex> batch(_batchMutex);
+
+	// Expand each distinct key once; one key per task since each costs a mulBase
+	const size_t keys = groupKeys(n, [&](size_t a, size_t b) { return jobs[a].secretKey < jobs[b].secretKey; });
+	_material.resize(keys);
+	parallelFor(keys, [&](size_t k, Scratch&) {
+		SigningMaterial& m = _material[k];
+		detail::schnorrq_expand_key(jobs[_firstJob[k]].secretKey, m.sk, m.pk, m.prefix);
+	});
+
+	_results.assign(n, 0);
+	const size_t shards = (n + _shardSize - 1) / _shardSize;
+	parallelFor(shards, [&](size_t t, Scratch&) {
+		// Small groups on the stack, so that their hashes share the SHA-512 lanes
+		constexpr size_t kGroup = 16;
+		std::array<detail::SignRequest, kGroup> reqs;
+		std::array<size_t, kGroup> idx;
+		bool ok[kGroup];
+		size_t count = 0;
+		const auto flush = [&] {
+			detail::schnorrq_sign_many(std::span(reqs).first(count), ok);
+			for (size_t j = 0; j < count; j++) {
+				_results[idx[j]] = ok[j];
+			}
+			count = 0;
+		};
+
+		const size_t end = std::min(n, (t + 1) * _shardSize);
+		for (size_t i = t * _shardSize; i < end; i++) {
+			if (jobs[i].msg.empty()) {
+				continue; // Same as SchnorrQSign
+			}
+			const SigningMaterial& m = _material[_keyOf[i]];
+			reqs[count] = {m.sk, m.prefix, m.pk, jobs[i].msg, sigs[i].data()};
+			idx[count++] = i;
+			if (count == kGroup) {
+				flush();
+			}
+		}
+		flush();
+	});
+
+	clear_words(_material.data(), (digit_t)(keys * sizeof(SigningMaterial) / sizeof(unsigned int)));
+	return std::vector<bool>(_results.begin(), _results.end());
+}
+
+std::vector<bool> SchnorrQBatchEngine::verify(std::span<const VerifyJob> jobs) {
+	const size_t n = jobs.size();
+	std::lock_guard<std::mutex> batch(_batchMutex);
+
+	// Decode each distinct key once
+	const size_t keys = groupKeys(n, [&](size_t a, size_t b) {
+		return std::memcmp(jobs[a].pubkey.data(), jobs[b].pubkey.data(), ECC_KEY_LENGTH) < 0;
+	});
+	_decoded.resize(keys);
+	_valid.assign(keys, 0);
+	parallelFor(keys, [&](size_t k, Scratch&) {
+		const EccDataType& raw = jobs[_firstJob[k]].pubkey;
+		if (_cache != nullptr) {
+			_valid[k] = _cache->tryDecode(raw, _decoded[k]);
+			return;
+		}
+		try {
+			_decoded[k] = Point(raw);
+			_valid[k] = 1;
+		} catch (const std::runtime_error&) {
+			// Not a point on the curve: every job using this key fails
+		}
+	});
+
+	// One batch verification per shard over the jobs whose key decoded
+	_results.assign(n, 0);
+	const size_t shards = (n + _shardSize - 1) / _shardSize;
+	parallelFor(shards, [&](size_t t, Scratch& s) {
+		if (_verification == BatchVerification::Exact) {
+			for (size_t i = t * _shardSize; i < std::min(n, (t + 1) * _shardSize); i++) {
+				if (_valid[_keyOf[i]]) {
+					_results[i] = SchnorrQVerify(_decoded[_keyOf[i]], jobs[i].msg, jobs[i].sig);
+				}
+			}
+			return;
+		}
+		s.jobs.clear();
+		s.pubkeys.clear();
+		s.msgs.clear();
+		s.sigs.clear();
+		const size_t end = std::min(n, (t + 1) * _shardSize);
+		for (size_t i = t * _shardSize; i < end; i++) {
+			if (_valid[_keyOf[i]]) {
+				s.jobs.push_back(i);
+				s.pubkeys.push_back(_decoded[_keyOf[i]]);
+				s.msgs.push_back(jobs[i].msg);
+				s.sigs.push_back(jobs[i].sig);
+			}
+		}
+		if (s.jobs.empty()) {
+			return;
+		}
+		SchnorrQVerifyBatch(s.pubkeys, s.msgs, s.sigs, s.results);
+		for (size_t j = 0; j < s.jobs.size(); j++) {
+			_results[s.jobs[j]] = s.results[j];
+		}
+	});
+
+	return std::vector<bool>(_results.begin(), _results.end());
+}
+
+} // namespace FourQ
+} // namespace Curve
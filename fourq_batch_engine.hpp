@@ -0,0 +1,116 @@
+#pragma once // 头文件保护
+
+// Multi-threaded SchnorrQ signing and verification over batches of jobs.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "fourq.hpp"
+#include "fourq_pool.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+class DecodeCache;
+
+// --- SchnorrQBatchEngine Class Declaration ---
+// A persistent thread pool that signs or verifies a batch of independent jobs and returns
+// the results in job order (implementation in fourq_batch_engine.cpp). Jobs are cut into
+// shards of `shardSize`; idle threads claim the next unprocessed shard, so a slow shard
+// never holds up the others. Across the whole batch the engine:
+//  - sign:   expands each distinct secret key once (A = k*G and the nonce prefix),
+//  - verify: decodes each distinct public key once, then checks every shard with
+//            SchnorrQVerifyBatch (one multi-scalar multiplication per shard), or each
+//            job with SchnorrQVerify in BatchVerification::Exact mode.
+// Per-thread scratch buffers live as long as the engine, so steady-state batches do not
+// reallocate them. One batch runs at a time; concurrent calls are serialized.
+// Duplicate secret keys are found by comparing key bytes, which is not constant time
+// with respect to the keys.
+class SchnorrQBatchEngine {
+public:
+	struct SignJob {
+		Scalar secretKey;
+		std::span<const uint8_t> msg; // Must stay valid for the duration of sign()
+	};
+	struct VerifyJob {
+		EccDataType pubkey;           // Encoded public key
+		std::span<const uint8_t> msg; // Must stay valid for the duration of verify()
+		std::array<uint8_t, 64> sig;
+	};
+
+	static constexpr size_t kDefaultShardSize = 64;
+
+	// threads == 0 uses std::thread::hardware_concurrency(). The calling thread takes part
+	// in every batch, so threads - 1 workers are started. Throws std::invalid_argument if
+	// shardSize is 0.
+	explicit SchnorrQBatchEngine(unsigned threads = 0, size_t shardSize = kDefaultShardSize);
+	~SchnorrQBatchEngine();
+
+	SchnorrQBatchEngine(const SchnorrQBatchEngine&) = delete;
+	SchnorrQBatchEngine& operator=(const SchnorrQBatchEngine&) = delete;
+
+	unsigned threads() const { return _pool.threads(); }
+	size_t shardSize() const { return _shardSize; }
+
+	// sigs[i] = SchnorrQSign(jobs[i].secretKey, jobs[i].msg); result[i] is its return value.
+	// Throws std::invalid_argument if the spans differ in length.
+	std::vector<bool> sign(std::span<const SignJob> jobs, std::span<std::array<uint8_t, 64>> sigs);
+
+	// result[i] is false if jobs[i].pubkey does not decode to a valid point. Otherwise, in
+	// BatchVerification::Exact mode it is SchnorrQVerify(Point(jobs[i].pubkey), jobs[i].msg,
+	// jobs[i].sig); in Combined mode (the default) it is the SchnorrQVerifyBatch result over
+	// the job's shard, which agrees with SchnorrQVerify except that crafted signatures with
+	// small-order components can be accepted (see SchnorrQVerifyBatch).
+	std::vector<bool> verify(std::span<const VerifyJob> jobs);
+
+	// How verify() checks a shard; Exact costs about one SchnorrQVerify per job
+	void setVerification(BatchVerification mode) { _verification = mode; }
+	BatchVerification verification() const { return _verification; }
+
+	// Optional: decode verify() keys through a shared DecodeCache, so that keys repeated
+	// across batches are decoded once. nullptr (the default) decodes every batch anew.
+	// The cache must outlive its use by the engine.
+	void setDecodeCache(DecodeCache* cache) { _cache = cache; }
+
+private:
+	// Reused between batches by the thread it belongs to
+	struct Scratch {
+		std::vector<size_t> jobs;
+		std::vector<Point> pubkeys;
+		std::vector<std::span<const uint8_t>> msgs;
+		std::vector<std::array<uint8_t, 64>> sigs;
+		std::vector<bool> results;
+	};
+
+	// Expanded signing key (see detail::schnorrq_expand_key)
+	struct SigningMaterial {
+		uint8_t sk[32], pk[32], prefix[32];
+	};
+
+	// Runs task(t, scratch) for every t in [0, ntasks) on the pool and the calling thread
+	void parallelFor(size_t ntasks, const std::function<void(size_t, Scratch&)>& task);
+	size_t groupKeys(size_t n, const std::function<bool(size_t, size_t)>& less);
+
+	size_t _shardSize;
+	DecodeCache* _cache = nullptr;
+	BatchVerification _verification = BatchVerification::Combined;
+	detail::WorkerPool _pool;
+	std::vector<Scratch> _scratch; // One per pool thread, [0] is the caller's
+
+	std::mutex _batchMutex; // Serializes sign()/verify()
+
+	// Per-batch tables, kept to reuse their capacity. groupKeys() fills _keyOf[i] with the
+	// index of job i's distinct key and _firstJob[u] with a job holding key u.
+	std::vector<size_t> _order, _keyOf, _firstJob;
+	std::vector<SigningMaterial> _material;
+	std::vector<Point> _decoded;
+	std::vector<uint8_t> _valid, _results;
+};
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,197 @@
+#include "fourq_comb.hpp"
+
+#include <cstring>   // For memcpy, memset
+#include <stdexcept> // For std::invalid_argument
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+// k + order < 2^247; one more digit so that the top column (always positive) can absorb
+// the last borrow of the recoding
+constexpr unsigned kCombBits = 248;
+constexpr unsigned kMaxColumns = 256;
+constexpr size_t kPrecompWords = sizeof(point_precomp) / sizeof(digit_t);
+
+inline digit_t word_bit(const digit_t* k, unsigned pos) {
+	return (k[pos / 64] >> (pos % 64)) & 1;
+}
+
+// All-ones when a == b, zero otherwise, without branching on the values
+inline digit_t eq_mask(unsigned a, unsigned b) {
+	const uint64_t diff = (uint64_t)(a ^ b);
+	return (digit_t)0 - (digit_t)((diff - 1) >> 63);
+}
+
+// S = negate ? -table[index] : table[index], reading every entry. -(x, y) = (-x, y), so
+// negation swaps x+y with y-x and negates 2dt.
+void lookup(const point_precomp* table, size_t n, unsigned index, digit_t negate, point_precomp_t S) {
+	digit_t* out = reinterpret_cast<digit_t*>(S);
+	std::memset(out, 0, sizeof(point_precomp));
+	for (size_t t = 0; t < n; t++) {
+		const digit_t mask = eq_mask((unsigned)t, index);
+		const digit_t* entry = reinterpret_cast<const digit_t*>(&table[t]);
+		for (size_t i = 0; i < kPrecompWords; i++) {
+			out[i] |= entry[i] & mask;
+		}
+	}
+
+	const digit_t mask = (digit_t)0 - negate;
+	digit_t* xy = reinterpret_cast<digit_t*>(S->xy);
+	digit_t* yx = reinterpret_cast<digit_t*>(S->yx);
+	for (size_t i = 0; i < sizeof(f2elm_t) / sizeof(digit_t); i++) {
+		const digit_t swap = (xy[i] ^ yx[i]) & mask;
+		xy[i] ^= swap;
+		yx[i] ^= swap;
+	}
+	f2elm_t t2neg;
+	fp2copy1271(S->t2, t2neg);
+	fp2neg1271(t2neg);
+	digit_t* t2 = reinterpret_cast<digit_t*>(S->t2);
+	const digit_t* t2n = reinterpret_cast<const digit_t*>(t2neg);
+	for (size_t i = 0; i < sizeof(f2elm_t) / sizeof(digit_t); i++) {
+		t2[i] = (t2[i] & ~mask) | (t2n[i] & mask);
+	}
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+FixedBaseComb::FixedBaseComb(unsigned w, unsigned v)
+	: _w(w), _v(v)
+{
+	if (w < 2 || w > kMaxW || v < 1 || v > kMaxV) {
+		throw std::invalid_argument("FixedBaseComb: need 2 <= w <= 8 and 1 <= v <= 16");
+	}
+	_e = (kCombBits + w * v - 1) / (w * v);
+	_d = _e * v;
+
+	// Q[m] = 2^(e*m) * G; every base 2^(b*e + i*d) * G is one of them (m = b + v*i)
+	Points q(w * v);
+	q[0] = Point::getBase();
+	for (size_t m = 1; m < q.size(); m++) {
+		q[m] = q[m - 1];
+		for (unsigned j = 0; j < _e; j++) {
+			q[m] += q[m];
+		}
+	}
+
+	// T_b[u] = 2^(b*e) * (1 + sum of 2^(i*d) over the set bits i-1 of u), built from
+	// T_b[u without its top bit]
+	const size_t per_table = (size_t)1 << (w - 1);
+	Points sums(v * per_table);
+	for (unsigned b = 0; b < v; b++) {
+		Point* T = &sums[b * per_table];
+		T[0] = q[b];
+		for (size_t u = 1; u < per_table; u++) {
+			unsigned top = 0;
+			while ((u >> (top + 1)) != 0) {
+				top++;
+			}
+			T[u] = T[u & ~((size_t)1 << top)] + q[b + v * (top + 1)];
+		}
+	}
+
+	// Affine (x+y, y-x, 2dt): with Z = 1, R1_to_R2 gives (x+y, y-x, 2, 2dt)
+	normalizeAll(sums);
+	_table.resize(sums.size());
+	for (size_t t = 0; t < sums.size(); t++) {
+		point_extproj_precomp_t R2;
+		R1_to_R2(reinterpret_cast<point_extproj*>(&sums[t]), R2);
+		fp2copy1271(R2->xy, _table[t].xy);
+		fp2copy1271(R2->yx, _table[t].yx);
+		fp2copy1271(R2->t2, _table[t].t2);
+	}
+}
+
+void FixedBaseComb::mul(const digit_t* k, point_t Q) const {
+	digit_t kr[NWORDS_ORDER], odd[NWORDS_ORDER];
+	std::memcpy(kr, k, sizeof(kr));
+	modulo_order(kr, kr);
+	conversion_to_odd(kr, odd);
+
+	// mLSB-set recoding. Column j has sign s_j = 2*k_(j+1) - 1 (s_(d-1) = +1) and row
+	// digits in {0, s_j}; idx[j] collects the rows 1..w-1 of column j.
+	uint8_t neg[kMaxColumns], idx[kMaxColumns];
+	for (unsigned j = 0; j < _d; j++) {
+		neg[j] = (uint8_t)(j + 1 < _d ? 1 - word_bit(odd, j + 1) : 0);
+		idx[j] = 0;
+	}
+	// c = odd >> d (d is public, so the shift may branch on it)
+	digit_t c[NWORDS_ORDER] = {0};
+	for (unsigned i = 0; i < NWORDS_ORDER; i++) {
+		const unsigned src = i + _d / 64;
+		const unsigned shift = _d % 64;
+		if (src < NWORDS_ORDER) {
+			c[i] = odd[src] >> shift;
+			if (shift != 0 && src + 1 < NWORDS_ORDER) {
+				c[i] |= odd[src + 1] << (64 - shift);
+			}
+		}
+	}
+	// Digit i of rows 1..w-1 is b = s_j * (c mod 2); then c = (c - b) / 2
+	for (unsigned i = _d; i < _w * _d; i++) {
+		const unsigned col = i % _d;
+		const digit_t bit = c[0] & 1;
+		idx[col] = (uint8_t)(idx[col] | (bit << (i / _d - 1)));
+		digit_t carry = bit & neg[col];
+		for (unsigned n = 0; n < NWORDS_ORDER; n++) {
+			const digit_t next = n + 1 < NWORDS_ORDER ? c[n + 1] : 0;
+			const digit_t shifted = (c[n] >> 1) | (next << 63);
+			c[n] = shifted + carry;
+			carry = (digit_t)(c[n] < carry);
+		}
+	}
+
+	// R = sum over j' of 2^j' * sum over b of s * T_b[idx], Horner on j'
+	const size_t per_table = (size_t)1 << (_w - 1);
+	point_t identity;
+	fp2zero1271(identity->x);
+	fp2zero1271(identity->y);
+	identity->y[0][0] = 1;
+	point_extproj_t R;
+	point_setup(identity, R);
+	point_precomp_t S;
+	for (unsigned j = _e; j-- > 0;) {
+		if (j + 1 != _e) {
+			eccdouble(R);
+		}
+		for (unsigned b = 0; b < _v; b++) {
+			const unsigned col = b * _e + j;
+			lookup(&_table[b * per_table], per_table, idx[col], neg[col], S);
+			eccmadd(S, R);
+		}
+	}
+	eccnorm(R, Q);
+
+	clear_words(kr, 256 / (sizeof(unsigned int) * 8));
+	clear_words(odd, 256 / (sizeof(unsigned int) * 8));
+	clear_words(c, 256 / (sizeof(unsigned int) * 8));
+	clear_words(neg, (digit_t)(sizeof(neg) / sizeof(unsigned int)));
+	clear_words(idx, (digit_t)(sizeof(idx) / sizeof(unsigned int)));
+}
+
+bool mul_fixed_base(const digit_t* k, point_t Q) {
+	if constexpr (kMulBaseCustomComb) {
+		static const FixedBaseComb comb(kMulBaseW, kMulBaseV);
+		comb.mul(k, Q);
+		return true;
+	} else {
+		// ecc_mul_fixed only reads k, the C API is just not const-correct
+		return ecc_mul_fixed(const_cast<digit_t*>(k), Q);
+	}
+}
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,49 @@
+#pragma once // 头文件保护
+
+// Internal fixed-base comb behind Point::mulBase and SchnorrQ signing.
+// Not part of the public wrapper API.
+
+#include <cstddef>
+#include <vector>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// Constant-time mLSB-set comb for k*G (Faz-Hernandez, Longa, Sanchez), the algorithm of
+// FourQlib's ecc_mul_fixed with (W, V) chosen at construction instead of fixed by the
+// compiled-in FourQ_tables.h. The odd representative of k (k or k + order) is recoded as
+// d = V*ceil(248/(W*V)) signed columns that are all nonzero, so the evaluation always
+// does e = d/V - 1 doublings and d mixed additions, and every table read scans the whole
+// table. The table holds V*2^(W-1) affine points in (x+y, y-x, 2dt) form, 96 bytes each.
+class FixedBaseComb {
+public:
+	static constexpr unsigned kMaxW = 8;
+	static constexpr unsigned kMaxV = 16;
+
+	// Builds the table (variable time, public data only). Throws std::invalid_argument
+	// unless 2 <= w <= kMaxW and 1 <= v <= kMaxV.
+	FixedBaseComb(unsigned w, unsigned v);
+
+	unsigned w() const { return _w; }
+	unsigned v() const { return _v; }
+	size_t tableBytes() const { return _table.size() * sizeof(point_precomp); }
+
+	// Q = k*G in affine coordinates for any 256-bit k, reduced mod the order first
+	void mul(const digit_t* k, point_t Q) const;
+
+private:
+	unsigned _w, _v, _d, _e; // d columns in v blocks of e
+	std::vector<point_precomp> _table; // _table[b*2^(w-1) + u] = 2^(b*e) * T[u]
+};
+
+// Q = k*G with the build's fixed-base method: FourQlib's ecc_mul_fixed, or a shared
+// FixedBaseComb(kMulBaseW, kMulBaseV) built on first use when kMulBaseCustomComb is set.
+// Same contract as ecc_mul_fixed.
+bool mul_fixed_base(const digit_t* k, point_t Q);
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,109 @@
+#include "fourq.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>  // For __cpuid, __cpuidex, _xgetbv
+#else
+#include <cpuid.h>   // For __get_cpuid, __get_cpuid_count
+#endif
+#define FASTECC_X86_64 1
+#endif
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::CpuFeatures;
+
+#if defined(FASTECC_X86_64)
+bool cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	if ((unsigned)info[0] < leaf) {
+		return false;
+	}
+	__cpuidex(info, (int)leaf, (int)subleaf);
+	for (int i = 0; i < 4; i++) {
+		regs[i] = (unsigned)info[i];
+	}
+	return true;
+#else
+	return __get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3]) != 0;
+#endif
+}
+
+unsigned long long xcr0() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned lo, hi;
+	__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+// XCR0 bits 1 and 2: the OS saves SSE and AVX (YMM) state on context switches
+bool os_saves_ymm() {
+	return (xcr0() & 0x6) == 0x6;
+}
+
+// XCR0 bits 5-7 on top: opmask and the upper ZMM registers as well
+bool os_saves_zmm() {
+	return (xcr0() & 0xE6) == 0xE6;
+}
+#endif
+
+CpuFeatures detect() {
+	CpuFeatures f;
+#if defined(FASTECC_X86_64)
+	unsigned r1[4] = {0}, r7[4] = {0};
+	const bool has1 = cpuid(1, 0, r1);
+	if (cpuid(7, 0, r7)) {
+		f.bmi2 = (r7[1] >> 8) & 1;   // EBX bit 8
+		f.adx = (r7[1] >> 19) & 1;   // EBX bit 19
+		const bool osxsave = has1 && ((r1[2] >> 27) & 1); // ECX bit 27
+		f.avx2 = ((r7[1] >> 5) & 1) && osxsave && os_saves_ymm();
+		f.avx512f = ((r7[1] >> 16) & 1) && osxsave && os_saves_zmm(); // EBX bit 16
+		f.avx512ifma = f.avx512f && ((r7[1] >> 21) & 1);                // EBX bit 21
+	}
+#endif
+	return f;
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+const CpuFeatures& cpuFeatures() {
+	static const CpuFeatures features = detect();
+	return features;
+}
+
+bool fieldBackendSupported() {
+	const CpuFeatures& f = cpuFeatures();
+	if (kFieldBackend == FieldBackend::X64AsmMulx && !(f.bmi2 && f.adx)) {
+		return false;
+	}
+	if (kUseAVX2 && !f.avx2) {
+		return false;
+	}
+	return true;
+}
+
+const char* fieldBackendName() {
+	switch (kFieldBackend) {
+	case FieldBackend::X64Asm:
+		return kUseAVX2 ? "x64-asm+avx2" : "x64-asm";
+	case FieldBackend::X64AsmMulx:
+		return kUseAVX2 ? "x64-asm-mulx-adx+avx2" : "x64-asm-mulx-adx";
+	case FieldBackend::Portable:
+	default:
+		return "portable";
+	}
+}
+
+} // namespace FourQ
+} // namespace Curve
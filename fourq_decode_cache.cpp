@@ -0,0 +1,155 @@
+#include "fourq_decode_cache.hpp"
+#include "fourq_random.hpp"
+
+#include <cstring>   // For memcpy
+#include <stdexcept> // For std::invalid_argument, std::runtime_error
+
+
+namespace Curve {
+namespace FourQ {
+
+size_t DecodeCache::KeyHash::operator()(const EccDataType& key) const {
+	// Seeded multiply-xorshift over the four words, so crafted keys cannot target a shard
+	uint64_t h = seed;
+	for (size_t i = 0; i < key.size(); i += 8) {
+		uint64_t w;
+		std::memcpy(&w, key.data() + i, 8);
+		h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+		h ^= h >> 32;
+	}
+	return (size_t)h;
+}
+
+DecodeCache::DecodeCache(size_t capacity, unsigned shards) {
+	if (capacity == 0 || shards == 0) {
+		throw std::invalid_argument("DecodeCache: capacity and shards must be positive");
+	}
+	if (!randomBytes({reinterpret_cast<uint8_t*>(&_hash.seed), sizeof(_hash.seed)})) {
+		_hash.seed = (uint64_t)reinterpret_cast<uintptr_t>(this); // Still works, just guessable
+	}
+	_perShard = (capacity + shards - 1) / shards;
+	_shards.reserve(shards);
+	for (unsigned i = 0; i < shards; i++) {
+		_shards.push_back(std::make_unique<Shard>(_hash.seed));
+		_shards.back()->slots.reserve(_perShard);
+		_shards.back()->index.reserve(_perShard);
+	}
+}
+
+DecodeCache::~DecodeCache() = default;
+
+DecodeCache::Shard& DecodeCache::shardFor(const EccDataType& raw) {
+	// The map uses the low bits of the same hash; take the shard from the high ones
+	const uint64_t h = (uint64_t)_hash(raw);
+	return *_shards[(size_t)((h >> 40) % _shards.size())];
+}
+
+bool DecodeCache::tryDecode(const EccDataType& raw, Point& out) {
+	Shard& shard = shardFor(raw);
+	{
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		auto it = shard.index.find(raw);
+		if (it != shard.index.end()) {
+			Entry& e = shard.slots[it->second];
+			e.referenced = true;
+			out = e.point;
+			shard.hits.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	shard.misses.fetch_add(1, std::memory_order_relaxed);
+
+	// Decode without holding the lock; two threads missing on the same key both decode
+	Point decoded;
+	try {
+		decoded = Point(raw);
+	} catch (const std::runtime_error&) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	if (shard.index.find(raw) == shard.index.end()) {
+		size_t slot;
+		if (shard.slots.size() < _perShard) {
+			slot = shard.slots.size();
+			shard.slots.push_back({raw, decoded, false});
+		} else {
+			// CLOCK: skip (and clear) referenced entries, evict the first unreferenced one
+			while (shard.slots[shard.hand].referenced) {
+				shard.slots[shard.hand].referenced = false;
+				shard.hand = (shard.hand + 1) % shard.slots.size();
+			}
+			slot = shard.hand;
+			shard.hand = (shard.hand + 1) % shard.slots.size();
+			shard.index.erase(shard.slots[slot].key);
+			shard.slots[slot] = {raw, decoded, false};
+			shard.evictions.fetch_add(1, std::memory_order_relaxed);
+		}
+		shard.index.emplace(raw, slot);
+	}
+	out = decoded;
+	return true;
+}
+
+Point DecodeCache::decode(const EccDataType& raw) {
+	Point p;
+	if (!tryDecode(raw, p)) {
+		throw std::runtime_error("Point decoding failed");
+	}
+	return p;
+}
+
+DecodeCache::Stats DecodeCache::stats() const {
+	Stats s;
+	for (const auto& shard : _shards) {
+		s.hits += shard->hits.load(std::memory_order_relaxed);
+		s.misses += shard->misses.load(std::memory_order_relaxed);
+		s.evictions += shard->evictions.load(std::memory_order_relaxed);
+	}
+	return s;
+}
+
+void DecodeCache::resetStats() {
+	for (auto& shard : _shards) {
+		shard->hits.store(0, std::memory_order_relaxed);
+		shard->misses.store(0, std::memory_order_relaxed);
+		shard->evictions.store(0, std::memory_order_relaxed);
+	}
+}
+
+void DecodeCache::clear() {
+	for (auto& shard : _shards) {
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		shard->index.clear();
+		shard->slots.clear();
+		shard->hand = 0;
+	}
+}
+
+size_t DecodeCache::size() const {
+	size_t n = 0;
+	for (const auto& shard : _shards) {
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		n += shard->slots.size();
+	}
+	return n;
+}
+
+size_t DecodeCache::capacity() const {
+	return _perShard * _shards.size();
+}
+
+
+// --- SchnorrQ verification with a cached key ---
+
+bool SchnorrQVerify(DecodeCache& cache, const EccDataType& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig)
+{
+	Point A;
+	if (!cache.tryDecode(pubkey, A)) {
+		return false;
+	}
+	return SchnorrQVerify(A, msg, sig);
+}
+
+} // namespace FourQ
+} // namespace Curve
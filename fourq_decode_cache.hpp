@@ -0,0 +1,89 @@
+#pragma once // 头文件保护
+
+// Bounded, thread-safe cache of decoded public keys.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+// --- DecodeCache Class Declaration ---
+// Maps 32-byte encodings to decoded and validated points, so that a repeated key skips
+// decode() (a field square root) and ecc_point_validate (implementation in
+// fourq_decode_cache.cpp). The cache is split into shards, each with its own mutex and a
+// CLOCK (second chance) replacement policy, so concurrent lookups of different keys rarely
+// contend. Shards are picked by a hash keyed with a random per-cache seed. Invalid
+// encodings are never cached.
+class DecodeCache {
+public:
+	struct Stats {
+		uint64_t hits = 0;
+		uint64_t misses = 0;    // Lookups that had to decode, including invalid encodings
+		uint64_t evictions = 0;
+	};
+
+	static constexpr size_t kDefaultCapacity = 4096;
+	static constexpr unsigned kDefaultShards = 16;
+
+	// capacity is split evenly over the shards (rounded up). Throws std::invalid_argument
+	// if capacity or shards is 0.
+	explicit DecodeCache(size_t capacity = kDefaultCapacity, unsigned shards = kDefaultShards);
+	~DecodeCache();
+
+	DecodeCache(const DecodeCache&) = delete;
+	DecodeCache& operator=(const DecodeCache&) = delete;
+
+	// Same result as Point(raw): throws std::runtime_error if raw is not a valid point
+	Point decode(const EccDataType& raw);
+	// Non-throwing form; returns false (out untouched) for an invalid encoding
+	bool tryDecode(const EccDataType& raw, Point& out);
+
+	Stats stats() const;
+	void resetStats();
+	void clear(); // Drops all entries, keeps the counters
+	size_t size() const;
+	size_t capacity() const;
+
+private:
+	struct KeyHash {
+		uint64_t seed;
+		size_t operator()(const EccDataType& key) const;
+	};
+	struct Entry {
+		EccDataType key;
+		Point point;
+		bool referenced = false;
+	};
+	struct Shard {
+		mutable std::mutex mutex;
+		std::unordered_map<EccDataType, size_t, KeyHash> index; // key -> slot
+		std::vector<Entry> slots;
+		size_t hand = 0;
+		std::atomic<uint64_t> hits{0}, misses{0}, evictions{0};
+		explicit Shard(uint64_t seed) : index(0, KeyHash{seed}) {}
+	};
+
+	Shard& shardFor(const EccDataType& raw);
+
+	KeyHash _hash;
+	size_t _perShard;
+	std::vector<std::unique_ptr<Shard>> _shards;
+};
+
+// SchnorrQ verification against an encoded public key, decoding it through the cache.
+// Same result as SchnorrQVerify(Point(pubkey), msg, sig), and false for a key that does
+// not decode (implementation in fourq_decode_cache.cpp).
+bool SchnorrQVerify(DecodeCache& cache, const EccDataType& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig);
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,636 @@
+#pragma once // 头文件保护
+
+// Differential checks: every optimized path against a straightforward reference on the
+// same inputs. Shared by the property tests (test_differential.cpp) and the libFuzzer
+// target (fuzz_fourq.cpp); not part of the fourq library.
+//
+// The references stay deliberately naive: scalar arithmetic bit by bit (detail::ct),
+// scalar multiplication by double-and-add over Point::dbl() and +=, signatures through
+// the C SchnorrQ_Sign/SchnorrQ_Verify, hashing through FourQlib's crypto_sha512, decoding
+// through FourQlib's decode + ecc_point_validate. Each check reads its inputs from a
+// FuzzInput and returns an empty string when all paths agree, otherwise a description of
+// the first mismatch.
+//
+// Checks switch the process-wide lane and SHA-512 backends (and restore them), so they
+// must not run concurrently with other users of addAll/doubleAll/hashMany.
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "fourq.hpp"
+#include "fourq_batch_engine.hpp"
+#include "fourq_decode_cache.hpp"
+#include "fourq_msm.hpp"
+#include "fourq_sha512.hpp"
+#include "fourq_soa.hpp"
+
+#include "FourQlib/sha512/sha512.h"
+
+namespace Curve {
+namespace FourQ {
+namespace differential {
+
+// --- FuzzInput ---
+// Reads values from a byte string. Past the end it yields zeros, so any byte string is a
+// valid input (and a short one still exercises the zero / identity edge cases).
+class FuzzInput {
+public:
+	explicit FuzzInput(std::span<const uint8_t> data) : _data(data) {}
+
+	bool exhausted() const { return _pos >= _data.size(); }
+
+	uint8_t byte() { return _pos < _data.size() ? _data[_pos++] : 0; }
+
+	// A value in [lo, hi]
+	size_t range(size_t lo, size_t hi) {
+		const uint16_t v = (uint16_t)((uint16_t)byte() << 8 | byte());
+		return lo + (size_t)v % (hi - lo + 1);
+	}
+
+	void fill(std::span<uint8_t> out) {
+		for (uint8_t& b : out) {
+			b = byte();
+		}
+	}
+
+	std::vector<uint8_t> bytes(size_t n) {
+		std::vector<uint8_t> out(n);
+		fill(out);
+		return out;
+	}
+
+	// Edge values (0, 1, N-1, small) or 32 arbitrary bytes reduced mod N
+	Scalar scalar() {
+		switch (byte() % 8) {
+		case 0: return Scalar::kZero;
+		case 1: return Scalar::kOne;
+		case 2: return Scalar::kOrderMinusOne;
+		case 3: return Scalar((uint32_t)range(2, 65535));
+		default: {
+			fourq_scalar_t w;
+			for (digit_t& d : w) {
+				d = 0;
+				for (unsigned j = 0; j < 8; j++) {
+					d |= (digit_t)byte() << (8 * j);
+				}
+			}
+			return Scalar::fromWords(w);
+		}
+		}
+	}
+
+	// A point of the prime-order subgroup, normalized or not, sometimes the identity
+	Point point() {
+		const Scalar k = scalar();
+		Point P = Point::mulBase(k);
+		switch (byte() % 4) {
+		case 0: return P;
+		case 1: return (P + Point::getBase()) - Point::getBase(); // Same point, Z != 1
+		case 2: return Point::getZero();
+		default: return P.dbl();
+		}
+	}
+
+private:
+	std::span<const uint8_t> _data;
+	size_t _pos = 0;
+};
+
+// --- References ---
+
+inline fourq_scalar_t words(const Scalar& k) {
+	const EccDataType b = k.getRaw(); // Little endian
+	fourq_scalar_t w{};
+	for (size_t i = 0; i < 32; i++) {
+		w[i / 8] |= (digit_t)b[i] << (8 * (i % 8));
+	}
+	return w;
+}
+
+// sum(scalars[i] * points[i]) by one shared double-and-add over the 256 bits
+inline Point referenceMultiMul(std::span<const Scalar> scalars, std::span<const Point> points) {
+	std::vector<EccDataType> bits;
+	for (const Scalar& k : scalars) {
+		bits.push_back(k.getRaw());
+	}
+	Point R = Point::getZero();
+	for (int i = 255; i >= 0; i--) {
+		R.dbl();
+		for (size_t j = 0; j < points.size(); j++) {
+			if ((bits[j][(size_t)i / 8] >> (i % 8)) & 1) {
+				R += points[j];
+			}
+		}
+	}
+	return R;
+}
+
+inline Point referenceMul(const Scalar& k, const Point& P) {
+	return referenceMultiMul({&k, 1}, {&P, 1});
+}
+
+// FourQlib's own decode and validation; false if the encoding is rejected
+inline bool referenceDecode(const EccDataType& raw, Point& out) {
+	point_t A;
+	if (::decode(raw.data(), A) != ECCRYPTO_SUCCESS) {
+		return false;
+	}
+	point_extproj_t P;
+	point_setup(A, P);
+	if (!ecc_point_validate(P)) {
+		return false;
+	}
+	std::memcpy(&out, P, sizeof(point_extproj_t)); // Point wraps one point_extproj
+	return true;
+}
+
+inline std::string mismatch(const std::string& what, size_t index = SIZE_MAX) {
+	return index == SIZE_MAX ? what : what + " [" + std::to_string(index) + "]";
+}
+
+// --- Checks ---
+
+enum class Check : uint8_t {
+	Scalar,        // +, -, *, /, invert, invertBatch, MontScalar, fromWords against detail::ct
+	ScalarMul,     // operator*, *=, mulBase, MulAdd, PreparedPoint, SigningKey against double-and-add
+	Normalization, // Lazy normalization, encodeAll, normalizeAll, AddendCache, PointBatch
+	MultiMul,      // Straus, Pippenger, the parallel split, PointBatch MultiMul
+	Lanes,         // addAll / doubleAll on every supported lane backend
+	Sha512,        // hashMany on every supported backend, incremental Sha512
+	Signatures,    // Sign/verify, batch verify, PreparedPoint, DecodeCache, SchnorrQBatchEngine against the C API
+	Decode,        // Point(raw), DecodeCache, PointBatch::assignEncoded against decode + validate
+};
+inline constexpr size_t kCheckCount = 8;
+
+inline const char* checkName(Check check) {
+	static constexpr const char* kNames[kCheckCount] = {
+		"Scalar", "ScalarMul", "Normalization", "MultiMul", "Lanes", "Sha512", "Signatures", "Decode",
+	};
+	return kNames[(size_t)check];
+}
+
+inline std::string checkScalar(FuzzInput& in) {
+	namespace ct = detail::ct;
+	const Scalar a = in.scalar(), b = in.scalar();
+	const fourq_scalar_t wa = words(a), wb = words(b);
+	if (words(a + b) != ct::add_mod(wa, wb)) {
+		return mismatch("a + b");
+	}
+	if (words(a - b) != ct::sub_mod(wa, wb)) {
+		return mismatch("a - b");
+	}
+	const fourq_scalar_t ab = ct::mul_mod(wa, wb);
+	if (words(a * b) != ab) {
+		return mismatch("a * b");
+	}
+	if (words((MontScalar(a) * MontScalar(b)).toScalar()) != ab) {
+		return mismatch("MontScalar a * b");
+	}
+	if ((MontScalar(a) + MontScalar(b)).toScalar() != a + b || (MontScalar(a) - MontScalar(b)).toScalar() != a - b) {
+		return mismatch("MontScalar a +- b");
+	}
+	if (!b.isZero()) {
+		if (ct::mul_mod(words(a / b), wb) != wa) {
+			return mismatch("(a / b) * b");
+		}
+		if (ct::mul_mod(words(Scalar::invert(b)), wb) != words(Scalar::kOne)) {
+			return mismatch("invert(b) * b");
+		}
+		std::array<Scalar, 2> batch{b, a.isZero() ? b : a};
+		Scalar::invertBatch(batch);
+		if (batch[0] != Scalar::invert(b) || batch[1] != Scalar::invert(a.isZero() ? b : a)) {
+			return mismatch("invertBatch");
+		}
+	}
+	fourq_scalar_t raw;
+	for (digit_t& d : raw) {
+		d = 0;
+		for (unsigned j = 0; j < 8; j++) {
+			d |= (digit_t)in.byte() << (8 * j);
+		}
+	}
+	if (words(Scalar::fromWords(raw)) != ct::reduce(raw)) {
+		return mismatch("fromWords");
+	}
+	if (Scalar(a.getRaw()) != a) {
+		return mismatch("Scalar(getRaw())");
+	}
+	return {};
+}
+
+inline std::string checkScalarMul(FuzzInput& in) {
+	const Scalar k = in.scalar(), a = in.scalar();
+	const Point P = in.point();
+	const Point G = Point::getBase();
+	const Point kP = referenceMul(k, P), kG = referenceMul(k, G);
+
+	if (k * P != kP) {
+		return mismatch("k * P");
+	}
+	Point Q = P;
+	Q *= k;
+	if (Q != kP) {
+		return mismatch("P *= k");
+	}
+	if (Point::mulBase(k) != kG) {
+		return mismatch("mulBase(k)");
+	}
+	const Point expected = referenceMul(a, G) + kP;
+	if (P.MulAdd(a, k) != expected) {
+		return mismatch("P.MulAdd(a, k)");
+	}
+	const PreparedPoint prepared(P);
+	if (prepared.mul(k) != kP) {
+		return mismatch("PreparedPoint::mul");
+	}
+	if (prepared.MulAdd(a, k) != expected) {
+		return mismatch("PreparedPoint::MulAdd");
+	}
+	if (!k.isZero() && SigningKey(k).publicKey() != kG) {
+		return mismatch("SigningKey::publicKey");
+	}
+	return {};
+}
+
+inline std::string checkNormalization(FuzzInput& in) {
+	const size_t n = in.range(1, 8);
+	std::vector<Point> ps;
+	for (size_t i = 0; i < n; i++) {
+		ps.push_back(in.point());
+	}
+
+	// Reference: one point at a time, each normalized on its own copy
+	std::vector<EccDataType> raw;
+	for (const Point& P : ps) {
+		Point copy = P;
+		raw.push_back(copy.normalize().getRaw());
+	}
+	std::vector<EccDataType> all(n);
+	encodeAll(ps, all);
+	std::vector<Point> normalized = ps;
+	normalizeAll(normalized);
+	for (size_t i = 0; i < n; i++) {
+		if (ps[i].getRaw() != raw[i]) {
+			return mismatch("getRaw", i);
+		}
+		if (all[i] != raw[i]) {
+			return mismatch("encodeAll", i);
+		}
+		if (!normalized[i].isNormalized() || normalized[i] != ps[i] || normalized[i].getRaw() != raw[i]) {
+			return mismatch("normalizeAll", i);
+		}
+		if (Point(raw[i]) != ps[i]) {
+			return mismatch("Point(getRaw())", i);
+		}
+		if (ps[i].isZero() != (ps[i] == Point::getZero())) {
+			return mismatch("isZero", i);
+		}
+	}
+
+	// Sums over projective and affine operands, and through AddendCache, agree
+	Point x = Point::getZero(), y = Point::getZero(), z = Point::getZero();
+	for (size_t i = 0; i < n; i++) {
+		x += ps[i];
+		y += normalized[i];
+		z += AddendCache(ps[i]);
+		z -= AddendCache::affine(ps[i]);
+		z += AddendCache::affine(ps[i]);
+		if (x != y || x != z) {
+			return mismatch("running sum", i);
+		}
+		if (ps[i] + Point::negate(ps[i]) != Point::getZero() || !(ps[i] - ps[i]).isZero()) {
+			return mismatch("P - P", i);
+		}
+	}
+	const std::vector<AddendCache> caches = AddendCache::affineBatch(ps);
+	Point w = Point::getZero();
+	for (const AddendCache& c : caches) {
+		w += c;
+	}
+	if (w != x) {
+		return mismatch("AddendCache::affineBatch");
+	}
+
+	const PointBatch batch(ps);
+	std::vector<EccDataType> encoded(n);
+	batch.encodeAll(encoded);
+	for (size_t i = 0; i < n; i++) {
+		if (batch.get(i) != ps[i] || batch.getRaw(i) != raw[i] || encoded[i] != raw[i]) {
+			return mismatch("PointBatch", i);
+		}
+	}
+	return {};
+}
+
+inline std::string checkMultiMul(FuzzInput& in) {
+	// Mostly the Straus sizes, sometimes past kPippengerThreshold
+	const size_t n = (in.byte() % 4 == 0) ? in.range(detail::kPippengerThreshold, detail::kPippengerThreshold + 32) : in.range(0, 24);
+	std::vector<Scalar> ks;
+	std::vector<Point> ps;
+	for (size_t i = 0; i < n; i++) {
+		ks.push_back(in.scalar());
+		ps.push_back(in.point());
+	}
+	const Point expected = referenceMultiMul(ks, ps);
+
+	const std::span<const fourq_scalar_t> kw(reinterpret_cast<const fourq_scalar_t*>(ks.data()), n);
+	const std::span<const point_extproj> pw(reinterpret_cast<const point_extproj*>(ps.data()), n);
+	if (Point::MultiMul(ks, ps) != expected) {
+		return mismatch("Point::MultiMul");
+	}
+	Point R;
+	detail::multi_mul_straus(kw, pw, reinterpret_cast<point_extproj*>(&R));
+	if (R != expected) {
+		return mismatch("multi_mul_straus");
+	}
+	detail::multi_mul_pippenger(kw, pw, reinterpret_cast<point_extproj*>(&R));
+	if (R != expected) {
+		return mismatch("multi_mul_pippenger");
+	}
+	// The parallel split below its size threshold, with the tasks run in reverse order on
+	// this thread
+	Executor reversed;
+	reversed.concurrency = (unsigned)in.range(2, 8);
+	reversed.run = [](size_t ntasks, const std::function<void(size_t)>& task) {
+		for (size_t i = ntasks; i-- > 0;) {
+			task(i);
+		}
+	};
+	if (n > 0) {
+		detail::multi_mul_parallel(kw, pw, reinterpret_cast<point_extproj*>(&R), reversed);
+		if (R != expected) {
+			return mismatch("multi_mul_parallel");
+		}
+	}
+	if (MultiMul(ScalarBatch(ks), PointBatch(ps)) != expected) {
+		return mismatch("MultiMul(ScalarBatch, PointBatch)");
+	}
+	return {};
+}
+
+inline std::string checkLanes(FuzzInput& in) {
+	const size_t n = in.range(0, 20);
+	const unsigned times = (unsigned)in.range(1, 3);
+	std::vector<Point> ps, qs;
+	for (size_t i = 0; i < n; i++) {
+		ps.push_back(in.point());
+		qs.push_back(in.point());
+	}
+	std::vector<Point> sums, doubled;
+	for (size_t i = 0; i < n; i++) {
+		sums.push_back(ps[i] + qs[i]);
+		Point D = ps[i];
+		for (unsigned t = 0; t < times; t++) {
+			D.dbl();
+		}
+		doubled.push_back(D);
+	}
+	const PointBatch addends(qs);
+	const LaneBackend saved = laneBackend();
+	std::string error;
+	for (LaneBackend backend : {LaneBackend::Scalar, LaneBackend::AVX2, LaneBackend::AVX512IFMA}) {
+		if (!setLaneBackend(backend)) {
+			continue;
+		}
+		std::vector<Point> acc = ps, dbl = ps;
+		addAll(acc, addends);
+		doubleAll(dbl, times);
+		for (size_t i = 0; i < n && error.empty(); i++) {
+			if (acc[i] != sums[i]) {
+				error = mismatch(std::string("addAll ") + laneBackendName(), i);
+			} else if (dbl[i] != doubled[i]) {
+				error = mismatch(std::string("doubleAll ") + laneBackendName(), i);
+			}
+		}
+		if (!error.empty()) {
+			break;
+		}
+	}
+	setLaneBackend(saved);
+	return error;
+}
+
+inline std::string checkSha512(FuzzInput& in) {
+	const size_t n = in.range(1, 12);
+	std::vector<std::vector<uint8_t>> data;
+	std::vector<Sha512::Message> msgs;
+	std::vector<Sha512::Digest> expected(n);
+	for (size_t i = 0; i < n; i++) {
+		data.push_back(in.bytes(in.range(0, 300)));
+	}
+	for (size_t i = 0; i < n; i++) {
+		const std::vector<uint8_t>& d = data[i];
+		static const uint8_t kNoData = 0; // crypto_sha512 memcpy()s from the pointer even for 0 bytes
+		crypto_sha512(d.empty() ? &kNoData : d.data(), d.size(), expected[i].data());
+		// Up to three parts, cut anywhere
+		size_t cut1 = in.range(0, d.size()), cut2 = in.range(0, d.size());
+		if (cut1 > cut2) {
+			std::swap(cut1, cut2);
+		}
+		const std::span<const uint8_t> s(d);
+		msgs.push_back({s.first(cut1), s.subspan(cut1, cut2 - cut1), s.subspan(cut2)});
+
+		Sha512 h;
+		const size_t chunk = in.range(1, 130);
+		for (size_t off = 0; off < d.size(); off += chunk) {
+			h.update(s.subspan(off, std::min(chunk, d.size() - off)));
+		}
+		Sha512::Digest incremental;
+		h.final(incremental.data());
+		if (incremental != expected[i]) {
+			return mismatch("Sha512::update", i);
+		}
+	}
+	const Sha512Backend saved = sha512Backend();
+	std::string error;
+	for (Sha512Backend backend : {Sha512Backend::Portable, Sha512Backend::AVX2, Sha512Backend::AVX512}) {
+		if (!setSha512Backend(backend)) {
+			continue;
+		}
+		std::vector<Sha512::Digest> out(n);
+		Sha512::hashMany(msgs, out);
+		for (size_t i = 0; i < n && error.empty(); i++) {
+			if (out[i] != expected[i]) {
+				error = mismatch(std::string("hashMany ") + sha512BackendName(), i);
+			}
+		}
+		if (!error.empty()) {
+			break;
+		}
+	}
+	setSha512Backend(saved);
+	return error;
+}
+
+inline std::string checkSignatures(FuzzInput& in) {
+	const size_t n = in.range(1, 12);
+	std::vector<Scalar> sks;
+	std::vector<Point> pks;
+	std::vector<std::vector<uint8_t>> msgs;
+	std::vector<std::array<uint8_t, 64>> sigs(n);
+	for (size_t i = 0; i < n; i++) {
+		Scalar sk = in.scalar();
+		sks.push_back(sk.isZero() ? Scalar::kOne : sk);
+		pks.push_back(Point::mulBase(sks[i]));
+		msgs.push_back(in.bytes(in.range(1, 64)));
+	}
+
+	// Signing: the C code, SchnorrQSign, SigningKey and signBatch give the same bytes
+	for (size_t i = 0; i < n; i++) {
+		EccDataType skraw = sks[i].getRaw(), pkraw = pks[i].getRaw();
+		std::array<uint8_t, 64> reference;
+		if (::SchnorrQ_Sign(skraw.data(), pkraw.data(), msgs[i].data(), (unsigned int)msgs[i].size(), reference.data()) != ECCRYPTO_SUCCESS) {
+			return mismatch("SchnorrQ_Sign failed", i);
+		}
+		if (!SchnorrQSign(sks[i], std::span<const uint8_t>(msgs[i]), sigs[i]) || sigs[i] != reference) {
+			return mismatch("SchnorrQSign", i);
+		}
+		const SigningKey key(sks[i]);
+		std::array<uint8_t, 64> sig;
+		if (!key.sign(msgs[i], sig) || sig != reference) {
+			return mismatch("SigningKey::sign", i);
+		}
+		const std::span<const uint8_t> one(msgs[i]);
+		if (!key.signBatch({&one, 1}, {&sig, 1}) || sig != reference) {
+			return mismatch("SigningKey::signBatch", i);
+		}
+	}
+
+	// Damage some: flip a signature bit, use another key, or change the message
+	for (size_t i = 0; i < n; i++) {
+		switch (in.byte() % 4) {
+		case 1: {
+			const size_t bit = in.range(0, 511);
+			sigs[i][bit / 8] ^= (uint8_t)(1u << (bit % 8));
+			break;
+		}
+		case 2: pks[i] = pks[(i + 1) % n]; break;
+		case 3: msgs[i][in.range(0, msgs[i].size() - 1)] ^= 0x01; break;
+		default: break;
+		}
+	}
+
+	std::vector<std::span<const uint8_t>> spans;
+	std::vector<EccDataType> pkraw;
+	std::vector<bool> expected;
+	for (size_t i = 0; i < n; i++) {
+		spans.emplace_back(msgs[i]);
+		pkraw.push_back(pks[i].getRaw());
+		unsigned int valid = 0;
+		::SchnorrQ_Verify(pkraw[i].data(), msgs[i].data(), (unsigned int)msgs[i].size(), sigs[i].data(), &valid);
+		expected.push_back(valid != 0);
+	}
+	const bool all = std::find(expected.begin(), expected.end(), false) == expected.end();
+
+	DecodeCache cache(16);
+	for (size_t i = 0; i < n; i++) {
+		if (SchnorrQVerify(pks[i], spans[i], sigs[i]) != expected[i]) {
+			return mismatch("SchnorrQVerify", i);
+		}
+		if (SchnorrQVerify(PreparedPoint(pks[i]), spans[i], sigs[i]) != expected[i]) {
+			return mismatch("SchnorrQVerify(PreparedPoint)", i);
+		}
+		if (SchnorrQVerify(cache, pkraw[i], spans[i], sigs[i]) != expected[i]) {
+			return mismatch("SchnorrQVerify(DecodeCache)", i);
+		}
+	}
+	std::vector<bool> results;
+	if (SchnorrQVerifyBatch(pks, spans, sigs, results) != all || results != expected) {
+		return mismatch("SchnorrQVerifyBatch");
+	}
+	if (SchnorrQVerifyBatch(PointBatch(pks), spans, sigs, results) != all || results != expected) {
+		return mismatch("SchnorrQVerifyBatch(PointBatch)");
+	}
+	std::vector<SchnorrQBatchEngine::VerifyJob> jobs;
+	for (size_t i = 0; i < n; i++) {
+		jobs.push_back({pkraw[i], spans[i], sigs[i]});
+	}
+	if (SchnorrQBatchEngine(1, 4).verify(jobs) != expected) {
+		return mismatch("SchnorrQBatchEngine::verify");
+	}
+	return {};
+}
+
+inline std::string checkDecode(FuzzInput& in) {
+	// Arbitrary bytes, a valid encoding, or a valid encoding with one bit flipped
+	EccDataType raw;
+	const uint8_t mode = in.byte() % 3;
+	if (mode == 0) {
+		in.fill(raw);
+	} else {
+		raw = in.point().getRaw();
+		if (mode == 2) {
+			const size_t bit = in.range(0, 255);
+			raw[bit / 8] ^= (uint8_t)(1u << (bit % 8));
+		}
+	}
+
+	Point expected;
+	const bool ok = referenceDecode(raw, expected);
+	bool decoded = true;
+	Point P;
+	try {
+		P = Point(raw);
+	} catch (const std::runtime_error&) {
+		decoded = false;
+	}
+	if (decoded != ok || (ok && P != expected)) {
+		return mismatch("Point(EccDataType)");
+	}
+	DecodeCache cache(4);
+	for (int pass = 0; pass < 2; pass++) { // Miss, then hit
+		Point C;
+		if (cache.tryDecode(raw, C) != ok || (ok && C != expected)) {
+			return mismatch("DecodeCache::tryDecode", (size_t)pass);
+		}
+	}
+	PointBatch batch;
+	bool assigned = true;
+	try {
+		batch.assignEncoded({&raw, 1});
+	} catch (const std::runtime_error&) {
+		assigned = false;
+	}
+	if (assigned != ok || (ok && batch.get(0) != expected)) {
+		return mismatch("PointBatch::assignEncoded");
+	}
+	if (ok && Point(expected.getRaw()) != expected) {
+		return mismatch("Point(getRaw()) after decode");
+	}
+	return {};
+}
+
+inline std::string run(Check check, FuzzInput& in) {
+	switch (check) {
+	case Check::Scalar: return checkScalar(in);
+	case Check::ScalarMul: return checkScalarMul(in);
+	case Check::Normalization: return checkNormalization(in);
+	case Check::MultiMul: return checkMultiMul(in);
+	case Check::Lanes: return checkLanes(in);
+	case Check::Sha512: return checkSha512(in);
+	case Check::Signatures: return checkSignatures(in);
+	case Check::Decode: return checkDecode(in);
+	}
+	return {};
+}
+
+// The fuzzer entry: the first byte picks the check, the rest is its input
+inline std::string run(std::span<const uint8_t> data) {
+	if (data.empty()) {
+		return {};
+	}
+	const Check check = (Check)(data[0] % kCheckCount);
+	FuzzInput in(data.subspan(1));
+	const std::string error = run(check, in);
+	return error.empty() ? error : std::string(checkName(check)) + ": " + error;
+}
+
+} // namespace differential
+} // namespace FourQ
+} // namespace Curve
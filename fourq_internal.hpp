@@ -0,0 +1,211 @@
+#pragma once // 头文件保护
+
+// Internal helpers shared by the wrapper's translation units. Not part of the public
+// wrapper API.
+//
+// The FourQlib C prototypes take every argument as non-const even where the function only
+// reads it, which used to force defensive copies (Point copy = that) or scattered
+// const_casts. The shims below take the read-only arguments as const and cast once here;
+// each one forwards to a FourQlib function that does not write the const inputs.
+
+#include <cstddef>
+#include <cstring> // For memset
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#include "fourq.hpp"
+#include "fourq_scratch.hpp"
+#include "fourq_stats.hpp"
+
+#if defined(FASTECC_STATS)
+#include <chrono>
+#endif
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// --- GF(p^2) ---
+
+inline void fp2copy(const f2elm_t a, f2elm_t c)
+{
+	fp2copy1271(const_cast<felm_t*>(a), c);
+}
+
+inline void fp2mul(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{
+	fp2mul1271(const_cast<felm_t*>(a), const_cast<felm_t*>(b), c);
+}
+
+inline void fp2sub(const f2elm_t a, const f2elm_t b, f2elm_t c)
+{
+	fp2sub1271(const_cast<felm_t*>(a), const_cast<felm_t*>(b), c);
+}
+
+// FourQ keeps GF(p) elements in [0, p] with p = 2^127 - 1, so p is a second
+// representation of zero
+inline bool fp_is_p(const felm_t a)
+{
+	for (unsigned i = 0; i + 1 < NWORDS_FIELD; i++) {
+		if (a[i] != ~(digit_t)0) {
+			return false;
+		}
+	}
+	return a[NWORDS_FIELD - 1] == (~(digit_t)0 >> 1);
+}
+
+// Maps p to 0 so that the element has a unique encoding
+inline void fp2_canonical(f2elm_t a)
+{
+	for (int i = 0; i < 2; i++) {
+		if (fp_is_p(a[i])) {
+			std::memset(a[i], 0, sizeof(felm_t));
+		}
+	}
+}
+
+// --- Points ---
+
+// (X, Y, Z, Ta, Tb) -> (X+Y, Y-X, 2Z, 2dT)
+inline void r1_to_r2(const point_extproj* P, point_extproj_precomp* Q)
+{
+	R1_to_R2(const_cast<point_extproj*>(P), Q);
+}
+
+// P += Q, Q in R2 form
+inline void add_r2(const point_extproj_precomp* Q, point_extproj* P)
+{
+	eccadd(const_cast<point_extproj_precomp*>(Q), P);
+}
+
+// P += Q, Q in affine (x+y, y-x, 2dt) form
+inline void add_affine(const point_precomp* Q, point_extproj* P)
+{
+	eccmadd(const_cast<point_precomp*>(Q), P);
+}
+
+// P += Q, both in R1 form
+inline void add_r1(const point_extproj* Q, point_extproj* P)
+{
+	point_extproj_precomp_t Q_precomp;
+	r1_to_r2(Q, Q_precomp);
+	eccadd(Q_precomp, P);
+}
+
+// -P in R1 form: (-X, Y, Z, -Ta, Tb), since T = Ta*Tb. fp2neg1271 maps 0 to p, which is
+// mapped back so -O keeps X == 0.
+inline void negate_extproj(point_extproj* P)
+{
+	fp2neg1271(P->x);
+	fp2neg1271(P->ta);
+	fp2_canonical(P->x);
+	fp2_canonical(P->ta);
+}
+
+// -P in R2 form: (X+Y, Y-X, 2Z, 2dT) -> (Y-X, X+Y, 2Z, -2dT). Q may be P.
+inline void negate_r2(const point_extproj_precomp* P, point_extproj_precomp* Q)
+{
+	f2elm_t t;
+	fp2copy(P->xy, t);
+	fp2copy(P->yx, Q->xy);
+	fp2copy(t, Q->yx);
+	fp2copy(P->z2, Q->z2);
+	fp2copy(P->t2, Q->t2);
+	fp2neg1271(Q->t2);
+}
+
+// -P in affine (x+y, y-x, 2dt) form, the same swap and negation without Z. Q may be P.
+inline void negate_affine(const point_precomp* P, point_precomp* Q)
+{
+	f2elm_t t;
+	fp2copy(P->xy, t);
+	fp2copy(P->yx, Q->xy);
+	fp2copy(t, Q->yx);
+	fp2copy(P->t2, Q->t2);
+	fp2neg1271(Q->t2);
+}
+
+// --- Scalars ---
+
+// For the FourQlib functions that take a scalar as digit_t* and only read it
+inline digit_t* scalar_words(const fourq_scalar_t& k)
+{
+	return const_cast<digit_t*>(k.data());
+}
+
+// --- Affine conversion (implementation in fourq.cpp) ---
+
+// Affine form of P, skipping the inversion when Z is already 1. Output is canonical
+// (coordinates in [0, p)).
+void to_affine(const point_extproj* P, point_affine* Q);
+
+// Q[i] = affine form of P[i] with one shared inversion (Montgomery's trick)
+void batch_to_affine(std::span<const point_extproj> P, point_affine* Q);
+
+// --- Scratch memory (fourq_scratch.hpp) ---
+
+// The calling thread's scratch resource; arena is set when it is a ScratchArena
+// (implementation in fourq_scratch.cpp)
+std::pmr::memory_resource* scratch_resource(ScratchArena*& arena);
+
+// Temporaries of one call. Declare it before the arrays it hands out: an arena is rewound
+// to where it was when the scope ends, which must be after the arrays are gone.
+class Scratch {
+public:
+	Scratch() : _resource(scratch_resource(_arena)), _mark(_arena != nullptr ? _arena->mark() : ScratchArena::Mark{}) {}
+	~Scratch() {
+		if (_arena != nullptr) {
+			_arena->rewind(_mark);
+		}
+	}
+	Scratch(const Scratch&) = delete;
+	Scratch& operator=(const Scratch&) = delete;
+
+	std::pmr::memory_resource* resource() const { return _resource; }
+
+	// n value-initialized elements, like std::vector<T>(n)
+	template<typename T>
+	std::pmr::vector<T> vector(size_t n = 0) const { return std::pmr::vector<T>(n, _resource); }
+
+private:
+	ScratchArena* _arena = nullptr;
+	std::pmr::memory_resource* _resource;
+	ScratchArena::Mark _mark;
+};
+
+// --- Instrumentation (fourq_stats.hpp) ---
+
+#if defined(FASTECC_STATS)
+// Records one call of op, with its items and wall time, when the scope ends
+class StatScope {
+public:
+	explicit StatScope(StatOp op, uint64_t items = 1)
+		: _op(op), _items(items), _start(std::chrono::steady_clock::now()) {}
+	~StatScope() {
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+		stats_record(_op, _items, (uint64_t)ns);
+	}
+	StatScope(const StatScope&) = delete;
+	StatScope& operator=(const StatScope&) = delete;
+
+private:
+	StatOp _op;
+	uint64_t _items;
+	std::chrono::steady_clock::time_point _start;
+};
+
+#define FASTECC_STAT_CONCAT2(a, b) a##b
+#define FASTECC_STAT_CONCAT(a, b) FASTECC_STAT_CONCAT2(a, b)
+#define FASTECC_STAT_SCOPE(op) \
+	::Curve::FourQ::detail::StatScope FASTECC_STAT_CONCAT(fastecc_stat_, __LINE__)(::Curve::FourQ::StatOp::op)
+#define FASTECC_STAT_SCOPE_N(op, items) \
+	::Curve::FourQ::detail::StatScope FASTECC_STAT_CONCAT(fastecc_stat_, __LINE__)(::Curve::FourQ::StatOp::op, (uint64_t)(items))
+#else
+#define FASTECC_STAT_SCOPE(op) ((void)0)
+#define FASTECC_STAT_SCOPE_N(op, items) ((void)0)
+#endif
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
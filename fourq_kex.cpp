@@ -0,0 +1,113 @@
+#include "fourq_kex.hpp"
+#include "fourq_internal.hpp"
+
+#include <cstring>   // For memcpy
+#include <stdexcept> // For std::invalid_argument
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+// The tail of CompressedSecretAgreement: y of k*(392*A), failing on the identity.
+// A is any affine point; ecc_mul validates it.
+bool agree(const uint8_t* sk, point_t A, Curve::FourQ::EccDataType& secret)
+{
+	FASTECC_STAT_SCOPE(Mul);
+	digit_t k[NWORDS_ORDER];
+	std::memcpy(k, sk, sizeof(k));
+	point_t Q;
+	const bool ok = ecc_mul(A, k, Q, true) && !is_zero_ct(reinterpret_cast<digit_t*>(Q->x), 2 * NWORDS_FIELD);
+	if (ok) {
+		std::memcpy(secret.data(), Q->y, secret.size());
+	} else {
+		secret.fill(0);
+	}
+	clear_words(k, 256 / (sizeof(unsigned int) * 8));
+	clear_words(Q, (digit_t)(sizeof(point_t) / (sizeof(unsigned int))));
+	return ok;
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+KeyExchange::KeyExchange(const Scalar& secretKey)
+	: _sk(secretKey.getRaw()), _pub(Point::mulBase(secretKey)) {
+	_pub.normalize(); // Encoded once here, and affine for anyone using publicKey()
+	_pk = _pub.getRaw();
+}
+
+KeyExchange KeyExchange::generate() {
+	const Scalar sk = Scalar::random();
+	return KeyExchange(sk);
+}
+
+KeyExchange::~KeyExchange() {
+	clear_words(_sk.data(), 256 / (sizeof(unsigned int) * 8));
+}
+
+bool KeyExchange::sharedSecret(const EccDataType& peer, EccDataType& secret) const
+{
+	point_t A;
+	bool decoded = false;
+	if ((peer[15] & 0x80) == 0) {
+		FASTECC_STAT_SCOPE(Decode);
+		decoded = decode(peer.data(), A) == ECCRYPTO_SUCCESS;
+	}
+	if (!decoded) {
+		secret.fill(0);
+		return false;
+	}
+	return agree(_sk.data(), A, secret);
+}
+
+bool KeyExchange::sharedSecret(const Point& peer, EccDataType& secret) const
+{
+	point_t A;
+	detail::to_affine(reinterpret_cast<const point_extproj*>(&peer), A);
+	return agree(_sk.data(), A, secret);
+}
+
+bool KeyExchange::sharedSecret(DecodeCache& cache, const EccDataType& peer, EccDataType& secret) const
+{
+	// The cache only holds points that decode; the bit-127 check is on the encoding
+	Point A;
+	if ((peer[15] & 0x80) != 0 || !cache.tryDecode(peer, A)) {
+		secret.fill(0);
+		return false;
+	}
+	return sharedSecret(A, secret);
+}
+
+bool KeyExchange::sharedSecretBatch(DecodeCache& cache, std::span<const EccDataType> peers,
+	std::span<EccDataType> secrets, std::vector<bool>& results) const
+{
+	if (peers.size() != secrets.size()) {
+		throw std::invalid_argument("KeyExchange::sharedSecretBatch: peers and secrets must have the same length");
+	}
+	results.assign(peers.size(), false);
+	bool all = true;
+	for (size_t i = 0; i < peers.size(); i++) {
+		results[i] = sharedSecret(cache, peers[i], secrets[i]);
+		all = all && results[i];
+	}
+	return all;
+}
+
+bool KeyExchange::sharedSecretBatch(DecodeCache& cache, std::span<const EccDataType> peers,
+	std::span<EccDataType> secrets) const
+{
+	std::vector<bool> results;
+	return sharedSecretBatch(cache, peers, secrets, results);
+}
+
+} // namespace FourQ
+} // namespace Curve
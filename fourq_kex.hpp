@@ -0,0 +1,56 @@
+#pragma once // 头文件保护
+
+// Diffie-Hellman key exchange compatible with FourQlib's kex.c.
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "fourq.hpp"
+#include "fourq_decode_cache.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+// --- KeyExchange Class Declaration ---
+// One side of an ECDH exchange (implementation in fourq_kex.cpp). The public key is
+// k*G from the fixed-base comb (Point::mulBase); a shared secret is the affine y
+// coordinate of k*(392*A) from the variable-base ecc_mul (the endomorphism path in
+// endomorphism builds), byte for byte what CompressedSecretAgreement returns. Peer keys
+// with bit 127 set, that do not decode, or that give the identity are rejected. The
+// secret key is wiped on destruction.
+class KeyExchange {
+private:
+	std::array<uint8_t, 32> _sk;
+	EccDataType _pk;
+	Point _pub;
+
+public:
+	explicit KeyExchange(const Scalar& secretKey);
+	// Fresh ephemeral key from Scalar::random (throws std::runtime_error if that does)
+	static KeyExchange generate();
+	KeyExchange(const KeyExchange&) = default;
+	KeyExchange& operator=(const KeyExchange&) = default;
+	~KeyExchange();
+
+	const Point& publicKey() const { return _pub; }
+	const EccDataType& publicKeyRaw() const { return _pk; }
+
+	// false (secret zeroed) for a rejected peer key
+	bool sharedSecret(const EccDataType& peer, EccDataType& secret) const;
+	bool sharedSecret(const Point& peer, EccDataType& secret) const;
+	// Same result, with the peer decoded through the cache
+	bool sharedSecret(DecodeCache& cache, const EccDataType& peer, EccDataType& secret) const;
+
+	// secrets[i] = secret with peers[i], each peer decoded through the cache; results[i]
+	// is sharedSecret()'s return value and the function returns true iff all succeeded.
+	// Throws std::invalid_argument if the spans differ in length.
+	bool sharedSecretBatch(DecodeCache& cache, std::span<const EccDataType> peers,
+		std::span<EccDataType> secrets, std::vector<bool>& results) const;
+	bool sharedSecretBatch(DecodeCache& cache, std::span<const EccDataType> peers,
+		std::span<EccDataType> secrets) const;
+};
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,482 @@
+#include "fourq_keystore.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_sha512.hpp"
+
+#include <algorithm>  // For std::min
+#include <bit>        // For std::endian
+#include <cstdio>     // For fopen, fwrite
+#include <cstring>    // For memcpy, memcmp
+#include <exception>  // For std::exception_ptr
+#include <filesystem> // For rename
+#include <fstream>
+#include <iterator>   // For std::istreambuf_iterator
+#include <stdexcept>  // For std::runtime_error, std::invalid_argument, std::out_of_range
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>    // For open
+#include <sys/mman.h> // For mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For close
+#define FASTECC_HAVE_MMAP 1
+#endif
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+// Records hold FourQlib's digit_t words as they are in memory
+static_assert(std::endian::native == std::endian::little, "The key store format is little endian");
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::KeyStore;
+using Curve::FourQ::KeyStoreFormat;
+using Curve::FourQ::Point;
+
+constexpr char kMagic[8] = {'F', 'O', 'U', 'R', 'Q', 'K', 'S', '\0'};
+constexpr size_t kDigestSize = 32;  // Truncated SHA-512
+constexpr size_t kDataAlignment = 64;
+
+struct FileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t format;
+	uint64_t count;
+	uint32_t recordSize;
+	uint32_t chunkRecords;
+	uint64_t dataOffset;
+	uint8_t reserved[56]; // Zero
+	uint8_t digest[kDigestSize];
+};
+static_assert(sizeof(FileHeader) == 128, "Key store header layout");
+
+// 1/2 mod p = 2^126, as a GF(p^2) element
+constexpr f2elm_t kHalf = {{0, (digit_t)1 << 62}, {0, 0}};
+
+bool known_format(uint32_t format) {
+	return format >= (uint32_t)KeyStoreFormat::Compressed && format <= (uint32_t)KeyStoreFormat::Precomputed;
+}
+
+// Header (digest zeroed) || chunk digest table
+void header_digest(const FileHeader& header, const uint8_t* table, size_t chunks, uint8_t* out) {
+	FileHeader h = header;
+	std::memset(h.digest, 0, sizeof(h.digest));
+	Curve::FourQ::Sha512 ctx;
+	ctx.update({reinterpret_cast<const uint8_t*>(&h), sizeof(h)});
+	ctx.update({table, chunks * kDigestSize});
+	uint8_t full[Curve::FourQ::Sha512::kDigestSize];
+	ctx.final(full);
+	std::memcpy(out, full, kDigestSize);
+}
+
+unsigned resolve_threads(unsigned threads, size_t work) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads == 0) {
+		threads = 1; // hardware_concurrency() may not know
+	}
+	return (unsigned)std::min<size_t>(threads, std::max<size_t>(work, 1));
+}
+
+// fn(begin, end) over `threads` contiguous slices of [0, n), one on the calling thread.
+// The first exception thrown by a slice is rethrown once all have finished.
+template<typename F>
+void parallel_ranges(size_t n, unsigned threads, const F& fn) {
+	const unsigned t = resolve_threads(threads, n);
+	if (t <= 1) {
+		fn((size_t)0, n);
+		return;
+	}
+	std::vector<std::exception_ptr> errors(t);
+	auto run = [&](unsigned id) {
+		try {
+			fn(n * id / t, n * (id + 1) / t);
+		} catch (...) {
+			errors[id] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> workers;
+	workers.reserve(t - 1);
+	for (unsigned id = 1; id < t; id++) {
+		workers.emplace_back(run, id);
+	}
+	run(0);
+	for (std::thread& w : workers) {
+		w.join();
+	}
+	for (const std::exception_ptr& e : errors) {
+		if (e) {
+			std::rethrow_exception(e);
+		}
+	}
+}
+
+// The record for an affine point with canonical coordinates
+void write_record(KeyStoreFormat format, point_affine* P, uint8_t* out) {
+	switch (format) {
+	case KeyStoreFormat::Compressed: {
+		digit_t encoded[NWORDS_ORDER]; // encode() stores through digit_t*
+		encode(P, reinterpret_cast<unsigned char*>(encoded));
+		std::memcpy(out, encoded, 32);
+		break;
+	}
+	case KeyStoreFormat::Affine:
+		std::memcpy(out, P->x, sizeof(f2elm_t));
+		std::memcpy(out + sizeof(f2elm_t), P->y, sizeof(f2elm_t));
+		break;
+	case KeyStoreFormat::Precomputed: {
+		// With Z = 1 the R2 form is (x+y, y-x, 2, 2dt), as in AddendCache
+		point_extproj_t R1;
+		point_extproj_precomp_t R2;
+		point_setup(P, R1);
+		Curve::FourQ::detail::r1_to_r2(R1, R2);
+		std::memcpy(out, R2->xy, sizeof(f2elm_t));
+		std::memcpy(out + sizeof(f2elm_t), R2->yx, sizeof(f2elm_t));
+		std::memcpy(out + 2 * sizeof(f2elm_t), R2->t2, sizeof(f2elm_t));
+		break;
+	}
+	}
+}
+
+// Both halves of an Affine record below p, as write_record stores them
+bool canonical_coordinates(const uint8_t* record) {
+	f2elm_t c[2];
+	std::memcpy(c, record, sizeof(c));
+	for (const f2elm_t& v : c) {
+		for (const felm_t& a : v) {
+			if ((a[1] >> 63) != 0 || (a[0] == ~(digit_t)0 && a[1] == (~(digit_t)0 >> 1))) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// The checks of Point(EccDataType) for Compressed records; for the other formats the point
+// must be on the curve and its record exactly what write_record makes of it
+bool valid_record(const Curve::FourQ::PointView& view) {
+	point_extproj_t P;
+	if (view.format() == KeyStoreFormat::Compressed) {
+		point_t A;
+		if (decode(view.bytes().data(), A) != ECCRYPTO_SUCCESS) {
+			return false;
+		}
+		point_setup(A, P);
+		return ecc_point_validate(P);
+	}
+	if (view.format() == KeyStoreFormat::Affine && !canonical_coordinates(view.bytes().data())) {
+		return false;
+	}
+	const Point p = view.point();
+	point_t A;
+	Curve::FourQ::detail::to_affine(reinterpret_cast<const point_extproj*>(&p), A);
+	point_setup(A, P);
+	if (!ecc_point_validate(P)) {
+		return false;
+	}
+	uint8_t expected[96];
+	write_record(view.format(), A, expected);
+	return std::memcmp(expected, view.bytes().data(), view.bytes().size()) == 0;
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+// --- PointView Implementation ---
+
+std::span<const uint8_t> PointView::bytes() const {
+	return {_record, KeyStore::recordSize(_format)};
+}
+
+EccDataType PointView::encoding() const {
+	if (_format == KeyStoreFormat::Compressed) {
+		EccDataType raw;
+		std::memcpy(raw.data(), _record, raw.size());
+		return raw;
+	}
+	return point().getRaw(); // Z == 1, no inversion
+}
+
+Point PointView::point() const {
+	point_t A;
+	switch (_format) {
+	case KeyStoreFormat::Compressed:
+		if (decode(_record, A) != ECCRYPTO_SUCCESS) {
+			throw std::runtime_error("PointView: record does not decode");
+		}
+		break;
+	case KeyStoreFormat::Affine:
+		std::memcpy(A->x, _record, sizeof(f2elm_t));
+		std::memcpy(A->y, _record + sizeof(f2elm_t), sizeof(f2elm_t));
+		break;
+	case KeyStoreFormat::Precomputed: {
+		// x = ((x+y) - (y-x)) / 2, y = ((x+y) + (y-x)) / 2
+		f2elm_t xy, yx, t;
+		std::memcpy(xy, _record, sizeof(f2elm_t));
+		std::memcpy(yx, _record + sizeof(f2elm_t), sizeof(f2elm_t));
+		fp2sub1271(xy, yx, t);
+		detail::fp2mul(t, kHalf, A->x);
+		fp2add1271(xy, yx, t);
+		detail::fp2mul(t, kHalf, A->y);
+		break;
+	}
+	}
+	Point p;
+	point_setup(A, reinterpret_cast<point_extproj*>(&p));
+	return p;
+}
+
+AddendCache PointView::addend() const {
+	if (_format != KeyStoreFormat::Precomputed) {
+		return AddendCache(point());
+	}
+	AddendCache cache;
+	std::memcpy(&cache._affine, _record, sizeof(point_precomp));
+	cache._mixed = true;
+	return cache;
+}
+
+
+// --- KeyStore Implementation ---
+
+size_t KeyStore::recordSize(KeyStoreFormat format) {
+	switch (format) {
+	case KeyStoreFormat::Compressed:
+		return 32;
+	case KeyStoreFormat::Affine:
+		return 2 * sizeof(f2elm_t);
+	case KeyStoreFormat::Precomputed:
+		return sizeof(point_precomp);
+	}
+	throw std::invalid_argument("KeyStore: unknown format");
+}
+
+void KeyStore::write(const std::string& path, std::span<const Point> points, KeyStoreFormat format, unsigned threads) {
+	const size_t rs = recordSize(format);
+	const size_t n = points.size();
+	const size_t chunks = (n + kChunkRecords - 1) / kChunkRecords;
+	const size_t tableEnd = sizeof(FileHeader) + chunks * kDigestSize;
+	const size_t dataOffset = (tableEnd + kDataAlignment - 1) / kDataAlignment * kDataAlignment;
+
+	std::vector<uint8_t> file(dataOffset + n * rs, 0);
+	uint8_t* table = file.data() + sizeof(FileHeader);
+	uint8_t* records = file.data() + dataOffset;
+	parallel_ranges(chunks, threads, [&](size_t begin, size_t end) {
+		std::vector<point_affine> affine(std::min(kChunkRecords, n));
+		for (size_t c = begin; c < end; c++) {
+			const size_t first = c * kChunkRecords;
+			const size_t len = std::min(kChunkRecords, n - first);
+			detail::batch_to_affine({reinterpret_cast<const point_extproj*>(points.data() + first), len}, affine.data());
+			for (size_t i = 0; i < len; i++) {
+				write_record(format, &affine[i], records + (first + i) * rs);
+			}
+			uint8_t full[Sha512::kDigestSize];
+			Sha512::hash({records + first * rs, len * rs}, full);
+			std::memcpy(table + c * kDigestSize, full, kDigestSize);
+		}
+	});
+
+	FileHeader header{};
+	std::memcpy(header.magic, kMagic, sizeof(kMagic));
+	header.version = kVersion;
+	header.format = (uint32_t)format;
+	header.count = n;
+	header.recordSize = (uint32_t)rs;
+	header.chunkRecords = (uint32_t)kChunkRecords;
+	header.dataOffset = dataOffset;
+	header_digest(header, table, chunks, header.digest);
+	std::memcpy(file.data(), &header, sizeof(header));
+
+	const std::string tmp = path + ".tmp";
+	std::FILE* f = std::fopen(tmp.c_str(), "wb");
+	if (f == nullptr) {
+		throw std::runtime_error("KeyStore: cannot create " + tmp);
+	}
+	const bool written = std::fwrite(file.data(), 1, file.size(), f) == file.size();
+	if (std::fclose(f) != 0 || !written) {
+		std::remove(tmp.c_str());
+		throw std::runtime_error("KeyStore: cannot write " + tmp);
+	}
+	std::error_code ec;
+	std::filesystem::rename(tmp, path, ec);
+	if (ec) {
+		std::remove(tmp.c_str());
+		throw std::runtime_error("KeyStore: cannot rename " + tmp + " to " + path + ": " + ec.message());
+	}
+}
+
+KeyStore::KeyStore(const std::string& path, KeyStoreVerify verify, unsigned threads) {
+#if defined(FASTECC_HAVE_MMAP)
+	const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		throw std::runtime_error("KeyStore: cannot open " + path);
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(FileHeader)) {
+		::close(fd);
+		throw std::runtime_error("KeyStore: " + path + " is too short");
+	}
+	void* map = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd); // The mapping keeps the file open
+	if (map == MAP_FAILED) {
+		throw std::runtime_error("KeyStore: cannot map " + path);
+	}
+	_data = static_cast<const uint8_t*>(map);
+	_size = (size_t)st.st_size;
+	_mapped = true;
+#else
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		throw std::runtime_error("KeyStore: cannot open " + path);
+	}
+	_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	if (_buffer.size() < sizeof(FileHeader)) {
+		throw std::runtime_error("KeyStore: " + path + " is too short");
+	}
+	_data = _buffer.data();
+	_size = _buffer.size();
+#endif
+
+	try {
+		FileHeader header;
+		std::memcpy(&header, _data, sizeof(header));
+		if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+			throw std::runtime_error("KeyStore: " + path + " is not a key store");
+		}
+		if (header.version != kVersion) {
+			throw std::runtime_error("KeyStore: unsupported version " + std::to_string(header.version));
+		}
+		if (!known_format(header.format) || header.recordSize != recordSize((KeyStoreFormat)header.format) || header.chunkRecords == 0) {
+			throw std::runtime_error("KeyStore: malformed header");
+		}
+		// Checked in this order so that nothing below can overflow
+		const size_t rs = header.recordSize;
+		if (header.count > _size / rs) {
+			throw std::runtime_error("KeyStore: malformed header");
+		}
+		const size_t count = (size_t)header.count;
+		const size_t chunks = (count + header.chunkRecords - 1) / header.chunkRecords;
+		if (header.dataOffset % kDataAlignment != 0 || header.dataOffset < sizeof(FileHeader) + chunks * kDigestSize ||
+			header.dataOffset > _size || _size - header.dataOffset != count * rs) {
+			throw std::runtime_error("KeyStore: size does not match the header (truncated file?)");
+		}
+
+		const uint8_t* table = _data + sizeof(FileHeader);
+		uint8_t digest[kDigestSize];
+		header_digest(header, table, chunks, digest);
+		if (std::memcmp(digest, header.digest, kDigestSize) != 0) {
+			throw std::runtime_error("KeyStore: header digest mismatch");
+		}
+		_format = (KeyStoreFormat)header.format;
+		_recordSize = rs;
+		_count = count;
+		_records = _data + header.dataOffset;
+
+		if (verify != KeyStoreVerify::Header) {
+			const size_t perChunk = header.chunkRecords;
+			parallel_ranges(chunks, threads, [&](size_t begin, size_t end) {
+				std::vector<Sha512::Message> msgs(end - begin);
+				std::vector<Sha512::Digest> out(end - begin);
+				for (size_t c = begin; c < end; c++) {
+					const size_t first = c * perChunk;
+					msgs[c - begin][0] = {_records + first * rs, std::min(perChunk, count - first) * rs};
+				}
+				Sha512::hashMany(msgs, out);
+				for (size_t c = begin; c < end; c++) {
+					if (std::memcmp(out[c - begin].data(), table + c * kDigestSize, kDigestSize) != 0) {
+						throw std::runtime_error("KeyStore: digest mismatch in chunk " + std::to_string(c));
+					}
+				}
+			});
+		}
+		if (verify == KeyStoreVerify::Full) {
+			parallel_ranges(count, threads, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; i++) {
+					if (!valid_record((*this)[i])) {
+						throw std::runtime_error("KeyStore: record " + std::to_string(i) + " is not a valid point");
+					}
+				}
+			});
+		}
+	} catch (...) {
+		close();
+		throw;
+	}
+}
+
+KeyStore::~KeyStore() {
+	close();
+}
+
+KeyStore::KeyStore(KeyStore&& that) noexcept {
+	*this = std::move(that);
+}
+
+KeyStore& KeyStore::operator=(KeyStore&& that) noexcept {
+	if (this != &that) {
+		close();
+		_data = that._data;
+		_size = that._size;
+		_records = that._records;
+		_count = that._count;
+		_recordSize = that._recordSize;
+		_format = that._format;
+		_mapped = that._mapped;
+		_buffer = std::move(that._buffer); // Moving keeps the storage _data points into
+		that._data = that._records = nullptr;
+		that._size = that._count = 0;
+		that._mapped = false;
+	}
+	return *this;
+}
+
+void KeyStore::close() {
+#if defined(FASTECC_HAVE_MMAP)
+	if (_mapped) {
+		::munmap(const_cast<uint8_t*>(_data), _size);
+	}
+#endif
+	_buffer.clear();
+	_data = _records = nullptr;
+	_size = _count = 0;
+	_mapped = false;
+}
+
+PointView KeyStore::at(size_t i) const {
+	if (i >= _count) {
+		throw std::out_of_range("KeyStore::at: index " + std::to_string(i) + " out of range");
+	}
+	return (*this)[i];
+}
+
+void KeyStore::loadAll(std::span<Point> out, unsigned threads) const {
+	if (out.size() != _count) {
+		throw std::invalid_argument("KeyStore::loadAll: out must have size() points");
+	}
+	// Compressed records need a square root each; the others are copies, where more
+	// threads than a few only add start-up cost
+	const size_t work = _format == KeyStoreFormat::Compressed ? _count : _count / kChunkRecords;
+	parallel_ranges(_count, resolve_threads(threads, work), [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			out[i] = (*this)[i].point();
+		}
+	});
+}
+
+std::vector<Point> KeyStore::loadAll(unsigned threads) const {
+	std::vector<Point> out(_count);
+	loadAll(out, threads);
+	return out;
+}
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,115 @@
+#pragma once // 头文件保护
+
+// Versioned binary store of pre-validated public keys, read through mmap.
+//
+// File layout (version 1, little endian):
+//   [0, 128)            header: magic "FOURQKS\0", version, format, count, record size,
+//                       records per chunk, data offset, header digest
+//   [128, dataOffset)   one 32-byte digest per chunk of records
+//   [dataOffset, end)   count records of recordSize bytes (dataOffset is 64-byte aligned)
+// Each chunk digest is the first half of SHA-512 over the chunk's records; the header
+// digest covers the header (digest field zeroed) and the chunk digest table. The digests
+// catch truncation and corruption, not tampering: whoever can write the file can recompute
+// them. Open files from untrusted sources with KeyStoreVerify::Full.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+// How each record stores its point
+enum class KeyStoreFormat : uint32_t {
+	Compressed = 1,  // 32-byte encoding; loading a point costs a decode (square root)
+	Affine = 2,      // 64 bytes, canonical (x, y); loading is a copy
+	Precomputed = 3, // 96 bytes, the affine addend (x+y, y-x, 2dt) that AddendCache uses
+};
+
+// What KeyStore checks when it opens a file; every level includes the ones above it
+enum class KeyStoreVerify {
+	Header, // Layout and the header digest only (table of chunk digests included)
+	Digest, // ... and every chunk digest, i.e. every byte of the file
+	Full,   // ... and that every record is a valid point, as Point(EccDataType) checks
+};
+
+// --- PointView Class Declaration ---
+// One record of a KeyStore, read in place (no copy until a point is asked for). Valid as
+// long as the KeyStore it came from.
+class PointView {
+public:
+	PointView(const uint8_t* record, KeyStoreFormat format) : _record(record), _format(format) {}
+
+	KeyStoreFormat format() const { return _format; }
+	std::span<const uint8_t> bytes() const; // The record as stored
+
+	EccDataType encoding() const;
+	// Normalized point. Throws std::runtime_error if a Compressed record does not decode;
+	// records are not validated again (see KeyStoreVerify::Full).
+	Point point() const;
+	// Mixed-addition form; a plain copy for Precomputed records
+	AddendCache addend() const;
+
+private:
+	const uint8_t* _record;
+	KeyStoreFormat _format;
+};
+
+// --- KeyStore Class Declaration ---
+// A read-only key set mapped into memory (implementation in fourq_keystore.cpp; platforms
+// without mmap read the file into a buffer instead). Opening costs the checks selected by
+// KeyStoreVerify, spread over `threads` threads; store[i] is then a zero-copy PointView.
+class KeyStore {
+public:
+	static constexpr uint32_t kVersion = 1;
+	static constexpr size_t kChunkRecords = 4096; // Records covered by one chunk digest
+
+	// Throws std::runtime_error if the file cannot be read, is malformed, or fails the
+	// requested checks. threads == 0 uses std::thread::hardware_concurrency().
+	explicit KeyStore(const std::string& path, KeyStoreVerify verify = KeyStoreVerify::Digest, unsigned threads = 0);
+	~KeyStore();
+
+	KeyStore(KeyStore&& that) noexcept;
+	KeyStore& operator=(KeyStore&& that) noexcept;
+	KeyStore(const KeyStore&) = delete;
+	KeyStore& operator=(const KeyStore&) = delete;
+
+	// Writes points to path in the given format (through path + ".tmp" and a rename, so an
+	// existing file is replaced whole or not at all). Points are normalized in chunks with
+	// one shared inversion each, in parallel. Throws std::runtime_error on I/O failure.
+	static void write(const std::string& path, std::span<const Point> points,
+		KeyStoreFormat format = KeyStoreFormat::Affine, unsigned threads = 0);
+
+	static size_t recordSize(KeyStoreFormat format);
+
+	size_t size() const { return _count; }
+	KeyStoreFormat format() const { return _format; }
+	bool isMapped() const { return _mapped; }
+
+	PointView operator[](size_t i) const { return PointView(_records + i * _recordSize, _format); }
+	PointView at(size_t i) const; // Throws std::out_of_range
+
+	// out[i] = (*this)[i].point(), in parallel. Throws std::invalid_argument if the sizes
+	// differ, and std::runtime_error like PointView::point().
+	void loadAll(std::span<Point> out, unsigned threads = 0) const;
+	std::vector<Point> loadAll(unsigned threads = 0) const;
+
+private:
+	void close();
+
+	const uint8_t* _data = nullptr; // Whole file
+	size_t _size = 0;
+	const uint8_t* _records = nullptr;
+	size_t _count = 0;
+	size_t _recordSize = 0;
+	KeyStoreFormat _format = KeyStoreFormat::Compressed;
+	bool _mapped = false;
+	std::vector<uint8_t> _buffer; // File contents when not mapped
+};
+
+} // namespace FourQ
+} // namespace Curve
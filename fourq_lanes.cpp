@@ -0,0 +1,162 @@
+#include "fourq_soa.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_lanes.hpp"
+
+#include <atomic>
+#include <stdexcept> // For std::invalid_argument
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::LaneBackend;
+using namespace Curve::FourQ::detail;
+
+LaneBackend best_backend() {
+	if (Curve::FourQ::laneBackendSupported(LaneBackend::AVX512IFMA)) {
+		return LaneBackend::AVX512IFMA;
+	}
+	if (Curve::FourQ::laneBackendSupported(LaneBackend::AVX2)) {
+		return LaneBackend::AVX2;
+	}
+	return LaneBackend::Scalar;
+}
+
+std::atomic<LaneBackend>& active_backend() {
+	static std::atomic<LaneBackend> backend{best_backend()};
+	return backend;
+}
+
+// Kernels of the active backend, nullptr for the scalar path
+const LaneKernels* active_kernels() {
+	switch (active_backend().load(std::memory_order_relaxed)) {
+#if defined(FASTECC_LANES_IFMA)
+	case LaneBackend::AVX512IFMA:
+		return &kLanesIfma;
+#endif
+#if defined(FASTECC_LANES_AVX2)
+	case LaneBackend::AVX2:
+		return &kLanesAvx2;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+point_extproj* extproj(std::span<Curve::FourQ::Point> points) {
+	return reinterpret_cast<point_extproj*>(points.data());
+}
+
+// P += (x_i, y_i) through FourQlib's eccmadd
+void madd_scalar(point_extproj* P, const Curve::FourQ::PointBatch& Q, size_t i) {
+	point_affine A;
+	digit_t* words = reinterpret_cast<digit_t*>(&A);
+	for (unsigned j = 0; j < Q.kLimbs; j++) {
+		words[j] = Q.limb(j)[i];
+	}
+	point_extproj_t T;
+	point_extproj_precomp_t R2;
+	point_precomp_t M;
+	point_setup(&A, T);
+	r1_to_r2(T, R2); // (x+y, y-x, 2, 2dt) since Z = 1
+	fp2copy(R2->xy, M->xy);
+	fp2copy(R2->yx, M->yx);
+	fp2copy(R2->t2, M->t2);
+	add_affine(M, P);
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+bool laneBackendSupported(LaneBackend backend) {
+	switch (backend) {
+	case LaneBackend::Scalar:
+		return true;
+	case LaneBackend::AVX2:
+#if defined(FASTECC_LANES_AVX2)
+		return cpuFeatures().avx2;
+#else
+		return false;
+#endif
+	case LaneBackend::AVX512IFMA:
+#if defined(FASTECC_LANES_IFMA)
+		return cpuFeatures().avx512ifma;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+LaneBackend laneBackend() {
+	return active_backend().load(std::memory_order_relaxed);
+}
+
+bool setLaneBackend(LaneBackend backend) {
+	if (!laneBackendSupported(backend)) {
+		return false;
+	}
+	active_backend().store(backend, std::memory_order_relaxed);
+	return true;
+}
+
+const char* laneBackendName() {
+	switch (laneBackend()) {
+	case LaneBackend::AVX2:
+		return "avx2";
+	case LaneBackend::AVX512IFMA:
+		return "avx512-ifma";
+	case LaneBackend::Scalar:
+	default:
+		return "scalar";
+	}
+}
+
+void addAll(std::span<Point> acc, const PointBatch& addends) {
+	if (acc.size() != addends.size()) {
+		throw std::invalid_argument("addAll: acc and addends must have the same length");
+	}
+	point_extproj* P = extproj(acc);
+	size_t done = 0;
+	if (const LaneKernels* k = active_kernels()) {
+		const digit_t* q[PointBatch::kLimbs];
+		for (unsigned j = 0; j < PointBatch::kLimbs; j++) {
+			q[j] = addends.limb(j);
+		}
+		done = acc.size() / k->lanes * k->lanes;
+		if (done != 0) {
+			k->madd(P, q, done);
+		}
+	}
+	for (size_t i = done; i < acc.size(); i++) {
+		madd_scalar(&P[i], addends, i);
+	}
+}
+
+void doubleAll(std::span<Point> points, unsigned times) {
+	point_extproj* P = extproj(points);
+	size_t done = 0;
+	if (const LaneKernels* k = active_kernels()) {
+		done = points.size() / k->lanes * k->lanes;
+		if (done != 0 && times != 0) {
+			k->dbl(P, done, times);
+		}
+	}
+	for (size_t i = done; i < points.size(); i++) {
+		for (unsigned t = 0; t < times; t++) {
+			eccdouble(&P[i]);
+		}
+	}
+}
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,44 @@
+#pragma once // 头文件保护
+
+// Internal lane-parallel point arithmetic behind addAll/doubleAll (fourq_soa.hpp).
+// Not part of the public wrapper API.
+//
+// Each SIMD backend keeps one GF(p) element per 64-bit lane in an unsaturated radix and
+// runs FourQlib's eccmadd/eccdouble formulas on kLanes independent points at once:
+//   AVX2        4 lanes, radix 2^26 (limbs of 26, 26, 26, 26, 23 bits), VPMULUDQ
+//   AVX-512     8 lanes, radix 2^52 (limbs of 52, 52, 23 bits), VPMADD52LUQ/HUQ (IFMA)
+// The formulas are FourQlib's, and coordinates are stored back in [0, p] as FourQlib keeps
+// them, so the two paths can be mixed freely on the same points.
+// The kernels only handle whole lane groups; the caller does the rest with FourQlib.
+
+#include <cstddef>
+
+// Only the FourQlib types: the kernels are built with their own -m flags and must not
+// emit copies of the wrapper's inline functions (the linker could keep those for everyone)
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// P[i] += (x_i, y_i) for i < n, n a multiple of the backend's lane count. q[j] points at
+// limb j of the addends (PointBatch layout, kLanes-aligned), q[0..3] x and q[4..7] y.
+using LaneMaddFn = void (*)(point_extproj* P, const digit_t* const* q, size_t n);
+// P[i] = 2^times * P[i] for i < n, n a multiple of the backend's lane count
+using LaneDblFn = void (*)(point_extproj* P, size_t n, unsigned times);
+
+struct LaneKernels {
+	size_t lanes;
+	LaneMaddFn madd;
+	LaneDblFn dbl;
+};
+
+// Compiled only when the build has the corresponding kernels (FASTECC_LANES_AVX2 /
+// FASTECC_LANES_IFMA); the caller checks the CPU before using them.
+extern const LaneKernels kLanesAvx2;  // fourq_lanes_avx2.cpp
+extern const LaneKernels kLanesIfma;  // fourq_lanes_ifma.cpp
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,137 @@
+// 4-lane GF(2^127-1) arithmetic on AVX2, built with -mavx2 (CMake FASTECC_LANES). Only
+// reached through detail::kLanesAvx2 after cpuFeatures().avx2 has been checked.
+
+#include "fourq_lanes.hpp"
+#include "fourq_lanes_impl.hpp"
+
+#include <immintrin.h>
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+// Radix 2^26: limbs of 26, 26, 26, 26 and 23 bits, one element per 64-bit lane.
+// VPMULUDQ multiplies the low 32 bits of each lane, so reduced limbs (a little over 2^26
+// at most) leave ample headroom for the 5-term column sums.
+struct Avx2Field {
+	static constexpr size_t kLanes = 4;
+	struct Fp {
+		__m256i v[5];
+	};
+
+	static __m256i mask(int bits) { return _mm256_set1_epi64x(((long long)1 << bits) - 1); }
+
+	// Carries once around the ring (2^127 = 1), then once more out of limb 0: limb 1 may end
+	// up slightly above 2^26, the others are exact
+	static void carry(__m256i c[5]) {
+		const __m256i m26 = mask(26);
+		for (int k = 0; k < 4; k++) {
+			c[k + 1] = _mm256_add_epi64(c[k + 1], _mm256_srli_epi64(c[k], 26));
+			c[k] = _mm256_and_si256(c[k], m26);
+		}
+		c[0] = _mm256_add_epi64(c[0], _mm256_srli_epi64(c[4], 23));
+		c[4] = _mm256_and_si256(c[4], mask(23));
+		c[1] = _mm256_add_epi64(c[1], _mm256_srli_epi64(c[0], 26));
+		c[0] = _mm256_and_si256(c[0], m26);
+	}
+
+	static Fp add(const Fp& a, const Fp& b) {
+		Fp c;
+		for (int k = 0; k < 5; k++) {
+			c.v[k] = _mm256_add_epi64(a.v[k], b.v[k]);
+		}
+		carry(c.v);
+		return c;
+	}
+
+	// a + 4p - b; every limb of 4p is at least the matching limb of a reduced b
+	static Fp sub(const Fp& a, const Fp& b) {
+		static constexpr long long k4p[5] = {(1 << 28) - 4, (1 << 28) - 4, (1 << 28) - 4, (1 << 28) - 4, (1 << 25) - 4};
+		Fp c;
+		for (int k = 0; k < 5; k++) {
+			c.v[k] = _mm256_sub_epi64(_mm256_add_epi64(a.v[k], _mm256_set1_epi64x(k4p[k])), b.v[k]);
+		}
+		carry(c.v);
+		return c;
+	}
+
+	// Schoolbook product; columns 5-8 sit at 2^130 = 8 (mod p) times columns 0-3
+	static Fp mul(const Fp& a, const Fp& b) {
+		__m256i c[9];
+		for (int k = 0; k < 9; k++) {
+			c[k] = _mm256_setzero_si256();
+		}
+		for (int i = 0; i < 5; i++) {
+			for (int j = 0; j < 5; j++) {
+				c[i + j] = _mm256_add_epi64(c[i + j], _mm256_mul_epu32(a.v[i], b.v[j]));
+			}
+		}
+		Fp r;
+		for (int k = 0; k < 4; k++) {
+			r.v[k] = _mm256_add_epi64(c[k], _mm256_slli_epi64(c[k + 5], 3));
+		}
+		r.v[4] = c[4];
+		carry(r.v);
+		return r;
+	}
+
+	// lo/hi: kLanes words each, 32-byte aligned, values in [0, p]
+	static void load(const uint64_t* lo, const uint64_t* hi, Fp& a) {
+		const __m256i l = _mm256_load_si256(reinterpret_cast<const __m256i*>(lo));
+		const __m256i h = _mm256_load_si256(reinterpret_cast<const __m256i*>(hi));
+		const __m256i m26 = mask(26);
+		a.v[0] = _mm256_and_si256(l, m26);
+		a.v[1] = _mm256_and_si256(_mm256_srli_epi64(l, 26), m26);
+		a.v[2] = _mm256_or_si256(_mm256_srli_epi64(l, 52), _mm256_and_si256(_mm256_slli_epi64(h, 12), m26));
+		a.v[3] = _mm256_and_si256(_mm256_srli_epi64(h, 14), m26);
+		a.v[4] = _mm256_srli_epi64(h, 40);
+	}
+
+	// Completes the carries so that every limb is exact; the value then is below 2^127,
+	// i.e. in [0, p]
+	static void store(const Fp& a, uint64_t* lo, uint64_t* hi) {
+		__m256i c[5] = {a.v[0], a.v[1], a.v[2], a.v[3], a.v[4]};
+		const __m256i m26 = mask(26);
+		for (int k = 1; k < 4; k++) {
+			c[k + 1] = _mm256_add_epi64(c[k + 1], _mm256_srli_epi64(c[k], 26));
+			c[k] = _mm256_and_si256(c[k], m26);
+		}
+		c[0] = _mm256_add_epi64(c[0], _mm256_srli_epi64(c[4], 23));
+		c[4] = _mm256_and_si256(c[4], mask(23));
+		c[1] = _mm256_add_epi64(c[1], _mm256_srli_epi64(c[0], 26));
+		c[0] = _mm256_and_si256(c[0], m26);
+
+		const __m256i l = _mm256_or_si256(_mm256_or_si256(c[0], _mm256_slli_epi64(c[1], 26)), _mm256_slli_epi64(c[2], 52));
+		const __m256i h = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi64(c[2], 12), _mm256_slli_epi64(c[3], 14)), _mm256_slli_epi64(c[4], 40));
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lo), l);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(hi), h);
+	}
+
+	static Fp broadcast(uint64_t lo, uint64_t hi) {
+		alignas(32) uint64_t l[kLanes], h[kLanes];
+		for (size_t i = 0; i < kLanes; i++) {
+			l[i] = lo;
+			h[i] = hi;
+		}
+		Fp a;
+		load(l, h, a);
+		return a;
+	}
+};
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+const LaneKernels kLanesAvx2 = {
+	Avx2Field::kLanes,
+	&lanes::madd_kernel<Avx2Field>,
+	&lanes::dbl_kernel<Avx2Field>,
+};
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
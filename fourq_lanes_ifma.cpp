@@ -0,0 +1,140 @@
+// 8-lane GF(2^127-1) arithmetic on AVX-512 IFMA, built with -mavx512f -mavx512ifma (CMake
+// FASTECC_LANES). Only reached through detail::kLanesIfma after cpuFeatures().avx512ifma
+// has been checked.
+
+#include "fourq_lanes.hpp"
+#include "fourq_lanes_impl.hpp"
+
+#include <immintrin.h>
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+// Radix 2^52: limbs of 52, 52 and 23 bits, one element per 64-bit lane. VPMADD52LUQ/HUQ
+// add the low/high 52 bits of a 52x52-bit product to an accumulator and ignore input bits
+// 52 and up, so limbs 0 and 1 are kept strictly below 2^52.
+struct IfmaField {
+	static constexpr size_t kLanes = 8;
+	struct Fp {
+		__m512i v[3];
+	};
+
+	static __m512i mask(int bits) { return _mm512_set1_epi64(((long long)1 << bits) - 1); }
+
+	// Carries once around the ring (2^127 = 1), then out of limbs 0 and 1 once more: limbs 0
+	// and 1 end up below 2^52, limb 2 at most 2^23
+	static void carry(__m512i c[3]) {
+		const __m512i m52 = mask(52);
+		c[1] = _mm512_add_epi64(c[1], _mm512_srli_epi64(c[0], 52));
+		c[0] = _mm512_and_si512(c[0], m52);
+		c[2] = _mm512_add_epi64(c[2], _mm512_srli_epi64(c[1], 52));
+		c[1] = _mm512_and_si512(c[1], m52);
+		c[0] = _mm512_add_epi64(c[0], _mm512_srli_epi64(c[2], 23));
+		c[2] = _mm512_and_si512(c[2], mask(23));
+		c[1] = _mm512_add_epi64(c[1], _mm512_srli_epi64(c[0], 52));
+		c[0] = _mm512_and_si512(c[0], m52);
+		c[2] = _mm512_add_epi64(c[2], _mm512_srli_epi64(c[1], 52));
+		c[1] = _mm512_and_si512(c[1], m52);
+	}
+
+	static Fp add(const Fp& a, const Fp& b) {
+		Fp c;
+		for (int k = 0; k < 3; k++) {
+			c.v[k] = _mm512_add_epi64(a.v[k], b.v[k]);
+		}
+		carry(c.v);
+		return c;
+	}
+
+	// a + 4p - b; every limb of 4p is at least the matching limb of a reduced b
+	static Fp sub(const Fp& a, const Fp& b) {
+		static constexpr long long k4p[3] = {((long long)1 << 54) - 4, ((long long)1 << 54) - 4, (1 << 25) - 4};
+		Fp c;
+		for (int k = 0; k < 3; k++) {
+			c.v[k] = _mm512_sub_epi64(_mm512_add_epi64(a.v[k], _mm512_set1_epi64(k4p[k])), b.v[k]);
+		}
+		carry(c.v);
+		return c;
+	}
+
+	// Schoolbook product: the low half of a_i*b_j goes to column i+j, the high half to
+	// column i+j+1 (a_2*b_2 < 2^52 has none). Column 3 sits at 2^156 = 2^29 (mod p) and
+	// column 4 at 2^208 = 2^81 (mod p).
+	static Fp mul(const Fp& a, const Fp& b) {
+		__m512i c[5];
+		for (int k = 0; k < 5; k++) {
+			c[k] = _mm512_setzero_si512();
+		}
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				c[i + j] = _mm512_madd52lo_epu64(c[i + j], a.v[i], b.v[j]);
+				if (i + j < 4) {
+					c[i + j + 1] = _mm512_madd52hi_epu64(c[i + j + 1], a.v[i], b.v[j]);
+				}
+			}
+		}
+		const __m512i m23 = mask(23);
+		Fp r;
+		r.v[0] = _mm512_add_epi64(c[0], _mm512_slli_epi64(_mm512_and_si512(c[3], m23), 29));
+		r.v[1] = _mm512_add_epi64(_mm512_add_epi64(c[1], _mm512_srli_epi64(c[3], 23)),
+			_mm512_slli_epi64(_mm512_and_si512(c[4], m23), 29));
+		r.v[2] = _mm512_add_epi64(c[2], _mm512_srli_epi64(c[4], 23));
+		carry(r.v);
+		return r;
+	}
+
+	// lo/hi: kLanes words each, 64-byte aligned, values in [0, p]
+	static void load(const uint64_t* lo, const uint64_t* hi, Fp& a) {
+		const __m512i l = _mm512_load_si512(lo);
+		const __m512i h = _mm512_load_si512(hi);
+		const __m512i m52 = mask(52);
+		a.v[0] = _mm512_and_si512(l, m52);
+		a.v[1] = _mm512_or_si512(_mm512_srli_epi64(l, 52), _mm512_and_si512(_mm512_slli_epi64(h, 12), m52));
+		a.v[2] = _mm512_srli_epi64(h, 40);
+	}
+
+	// Completes the carries so that every limb is exact; the value then is below 2^127,
+	// i.e. in [0, p]
+	static void store(const Fp& a, uint64_t* lo, uint64_t* hi) {
+		__m512i c[3] = {a.v[0], a.v[1], a.v[2]};
+		const __m512i m52 = mask(52);
+		c[0] = _mm512_add_epi64(c[0], _mm512_srli_epi64(c[2], 23));
+		c[2] = _mm512_and_si512(c[2], mask(23));
+		c[1] = _mm512_add_epi64(c[1], _mm512_srli_epi64(c[0], 52));
+		c[0] = _mm512_and_si512(c[0], m52);
+		c[2] = _mm512_add_epi64(c[2], _mm512_srli_epi64(c[1], 52));
+		c[1] = _mm512_and_si512(c[1], m52);
+
+		_mm512_store_si512(lo, _mm512_or_si512(c[0], _mm512_slli_epi64(c[1], 52)));
+		_mm512_store_si512(hi, _mm512_or_si512(_mm512_srli_epi64(c[1], 12), _mm512_slli_epi64(c[2], 40)));
+	}
+
+	static Fp broadcast(uint64_t lo, uint64_t hi) {
+		alignas(64) uint64_t l[kLanes], h[kLanes];
+		for (size_t i = 0; i < kLanes; i++) {
+			l[i] = lo;
+			h[i] = hi;
+		}
+		Fp a;
+		load(l, h, a);
+		return a;
+	}
+};
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+const LaneKernels kLanesIfma = {
+	IfmaField::kLanes,
+	&lanes::madd_kernel<IfmaField>,
+	&lanes::dbl_kernel<IfmaField>,
+};
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,178 @@
+#pragma once // 头文件保护
+
+// Lane-parallel FourQ point formulas over a SIMD field backend. Included only by the
+// backend translation units (fourq_lanes_avx2.cpp, fourq_lanes_ifma.cpp), each compiled
+// with its own target flags.
+//
+// A Field provides, for kLanes independent GF(p) elements held in a type Fp:
+//   add, sub, mul          results reduced so that they are valid inputs again
+//   load(lo, hi, a)        kLanes (low word, high word) pairs with values in [0, p]
+//   store(a, lo, hi)       back to words, values in [0, p] as FourQlib keeps them
+//   broadcast(lo, hi)      one constant in every lane
+
+#include <cstddef>
+#include <cstdint>
+
+#include "fourq_lanes.hpp"
+
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_params.h" // For PARAMETER_d
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+namespace lanes {
+
+template<typename Field>
+struct Fp2 {
+	typename Field::Fp re, im;
+};
+
+template<typename Field>
+inline Fp2<Field> add(const Fp2<Field>& a, const Fp2<Field>& b) {
+	return {Field::add(a.re, b.re), Field::add(a.im, b.im)};
+}
+
+template<typename Field>
+inline Fp2<Field> sub(const Fp2<Field>& a, const Fp2<Field>& b) {
+	return {Field::sub(a.re, b.re), Field::sub(a.im, b.im)};
+}
+
+// (a0 + a1 i)(b0 + b1 i) with i^2 = -1, schoolbook (Karatsuba's sums would need an
+// extra reduction per operand)
+template<typename Field>
+inline Fp2<Field> mul(const Fp2<Field>& a, const Fp2<Field>& b) {
+	return {
+		Field::sub(Field::mul(a.re, b.re), Field::mul(a.im, b.im)),
+		Field::add(Field::mul(a.re, b.im), Field::mul(a.im, b.re)),
+	};
+}
+
+// (a0 + a1 i)^2 = (a0 + a1)(a0 - a1) + 2 a0 a1 i
+template<typename Field>
+inline Fp2<Field> sqr(const Fp2<Field>& a) {
+	const typename Field::Fp t = Field::mul(a.re, a.im);
+	return {Field::mul(Field::add(a.re, a.im), Field::sub(a.re, a.im)), Field::add(t, t)};
+}
+
+template<typename Field>
+struct ExtLanes { // (X, Y, Z, Ta, Tb) with T = Ta*Tb, as point_extproj
+	Fp2<Field> x, y, z, ta, tb;
+};
+
+// kLanes words of one limb of one coordinate, gathered from / scattered to AoS points
+template<typename Field>
+inline void load_fp2(const point_extproj* P, size_t coord, Fp2<Field>& a) {
+	alignas(64) uint64_t w[4][Field::kLanes];
+	for (size_t l = 0; l < Field::kLanes; l++) {
+		const digit_t* words = reinterpret_cast<const digit_t*>(&P[l]) + 4 * coord;
+		for (size_t j = 0; j < 4; j++) {
+			w[j][l] = words[j];
+		}
+	}
+	Field::load(w[0], w[1], a.re);
+	Field::load(w[2], w[3], a.im);
+}
+
+template<typename Field>
+inline void store_fp2(const Fp2<Field>& a, point_extproj* P, size_t coord) {
+	alignas(64) uint64_t w[4][Field::kLanes];
+	Field::store(a.re, w[0], w[1]);
+	Field::store(a.im, w[2], w[3]);
+	for (size_t l = 0; l < Field::kLanes; l++) {
+		digit_t* words = reinterpret_cast<digit_t*>(&P[l]) + 4 * coord;
+		for (size_t j = 0; j < 4; j++) {
+			words[j] = w[j][l];
+		}
+	}
+}
+
+template<typename Field>
+inline void load_ext(const point_extproj* P, ExtLanes<Field>& R) {
+	load_fp2(P, 0, R.x);
+	load_fp2(P, 1, R.y);
+	load_fp2(P, 2, R.z);
+	load_fp2(P, 3, R.ta);
+	load_fp2(P, 4, R.tb);
+}
+
+template<typename Field>
+inline void store_ext(const ExtLanes<Field>& R, point_extproj* P) {
+	store_fp2(R.x, P, 0);
+	store_fp2(R.y, P, 1);
+	store_fp2(R.z, P, 2);
+	store_fp2(R.ta, P, 3);
+	store_fp2(R.tb, P, 4);
+}
+
+// FourQlib's eccdouble: 2P from X, Y, Z
+template<typename Field>
+inline void dbl(ExtLanes<Field>& P) {
+	Fp2<Field> t1 = sqr(P.x);               // X1^2
+	Fp2<Field> t2 = sqr(P.y);               // Y1^2
+	const Fp2<Field> s = add(P.x, P.y);     // X1+Y1
+	P.tb = add(t1, t2);                     // X1^2+Y1^2
+	t1 = sub(t2, t1);                       // Y1^2-X1^2
+	P.ta = sub(sqr(s), P.tb);               // 2X1*Y1
+	t2 = sqr(P.z);
+	t2 = sub(add(t2, t2), t1);              // 2Z1^2-(Y1^2-X1^2)
+	P.y = mul(t1, P.tb);
+	P.x = mul(t2, P.ta);
+	P.z = mul(t1, t2);
+}
+
+// FourQlib's eccmadd: P += Q with Q = (x+y, y-x, 2dt) affine
+template<typename Field>
+inline void madd(ExtLanes<Field>& P, const Fp2<Field>& qxy, const Fp2<Field>& qyx, const Fp2<Field>& qt2) {
+	Fp2<Field> ta = mul(mul(P.ta, P.tb), qt2); // 2dT1*t2
+	Fp2<Field> t1 = add(P.z, P.z);
+	const Fp2<Field> z = add(P.x, P.y);
+	const Fp2<Field> tb = sub(P.y, P.x);
+	const Fp2<Field> t2 = sub(t1, ta);         // theta
+	t1 = add(t1, ta);                          // alpha
+	ta = mul(qxy, z);
+	const Fp2<Field> x = mul(qyx, tb);
+	P.z = mul(t1, t2);
+	P.tb = sub(ta, x);                         // beta
+	P.ta = add(ta, x);                         // omega
+	P.x = mul(P.tb, t2);
+	P.y = mul(P.ta, t1);
+}
+
+template<typename Field>
+void madd_kernel(point_extproj* P, const digit_t* const* q, size_t n) {
+	// 2d, reduced once through the backend itself
+	Fp2<Field> d2;
+	d2.re = Field::broadcast(PARAMETER_d[0], PARAMETER_d[1]);
+	d2.im = Field::broadcast(PARAMETER_d[2], PARAMETER_d[3]);
+	d2 = add(d2, d2);
+
+	for (size_t i = 0; i < n; i += Field::kLanes) {
+		Fp2<Field> x, y;
+		Field::load(q[0] + i, q[1] + i, x.re);
+		Field::load(q[2] + i, q[3] + i, x.im);
+		Field::load(q[4] + i, q[5] + i, y.re);
+		Field::load(q[6] + i, q[7] + i, y.im);
+
+		ExtLanes<Field> R;
+		load_ext(P + i, R);
+		madd(R, add(x, y), sub(y, x), mul(mul(x, y), d2));
+		store_ext(R, P + i);
+	}
+}
+
+template<typename Field>
+void dbl_kernel(point_extproj* P, size_t n, unsigned times) {
+	for (size_t i = 0; i < n; i += Field::kLanes) {
+		ExtLanes<Field> R;
+		load_ext(P + i, R);
+		for (unsigned t = 0; t < times; t++) {
+			dbl(R);
+		}
+		store_ext(R, P + i);
+	}
+}
+
+} // namespace lanes
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
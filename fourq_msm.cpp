@@ -0,0 +1,511 @@
+#include "fourq_msm.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_pool.hpp"
+#include "fourq_soa.hpp"
+
+#include <algorithm>   // For std::fill, std::min
+#include <bit>         // For std::countl_zero
+#include <cstring>     // For memcpy
+#include <functional>  // For std::cref
+#include <memory>      // For std::make_shared
+#include <stdexcept>   // For std::invalid_argument
+#include <vector>
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::fourq_scalar_t;
+using namespace Curve::FourQ::detail; // Const-correct shims from fourq_internal.hpp
+
+// Straus: signed radix-16 digits in [-8, 8]; 64 windows cover 256 bits, plus one carry digit
+constexpr int kStrausWindow = 4;
+constexpr int kStrausDigits = 256 / kStrausWindow + 1;
+constexpr int kStrausTable = 1 << (kStrausWindow - 1); // 1P .. 8P
+
+// Pippenger window range
+constexpr unsigned kMinBucketWindow = 4;
+constexpr unsigned kMaxBucketWindow = 16;
+
+struct StrausTerm {
+	point_extproj_precomp_t table[kStrausTable]; // table[j] = (j+1)*P in R2 form
+	int8_t digits[kStrausDigits];
+};
+
+void set_identity(point_extproj_t P) {
+	point_t zero_affine;
+	fp2zero1271(zero_affine->x);
+	fp2zero1271(zero_affine->y);
+	zero_affine->y[0][0] = 1;
+	point_setup(zero_affine, P);
+}
+
+// Bits [pos, pos+width) of a 256-bit scalar, zero past the top; width <= 32
+uint32_t scalar_bits(const fourq_scalar_t& k, unsigned pos, unsigned width) {
+	if (pos >= 256) {
+		return 0;
+	}
+	unsigned word = pos / 64, shift = pos % 64;
+	uint64_t v = k[word] >> shift;
+	if (shift + width > 64 && word + 1 < NWORDS_ORDER) {
+		v |= k[word + 1] << (64 - shift);
+	}
+	return (uint32_t)(v & ((1ULL << width) - 1));
+}
+
+unsigned scalar_bitlength(const fourq_scalar_t& k) {
+	for (int i = NWORDS_ORDER - 1; i >= 0; i--) {
+		if (k[(size_t)i] != 0) {
+			return (unsigned)(64 * i + 64 - std::countl_zero(k[(size_t)i]));
+		}
+	}
+	return 0;
+}
+
+// Signed base-2^w recoding: digits in (-2^(w-1), 2^(w-1)], ndigits = ceil(bits/w) + 1
+void recode_signed(const fourq_scalar_t& k, unsigned w, int32_t* digits, unsigned ndigits) {
+	const int32_t half = 1 << (w - 1);
+	int32_t carry = 0;
+	for (unsigned i = 0; i < ndigits; i++) {
+		int32_t d = (int32_t)scalar_bits(k, i * w, w) + carry;
+		carry = (d > half) ? 1 : 0;
+		digits[i] = d - (carry << w);
+	}
+}
+
+// Builds table = {1P, 2P, ..., 8P} in R2 form
+void build_table(const point_extproj* P, point_extproj_precomp_t* table) {
+	point_extproj_t Q;
+
+	r1_to_r2(P, table[0]);
+	std::memcpy(Q, P, sizeof(point_extproj_t));
+	eccdouble(Q);
+	R1_to_R2(Q, table[1]);
+	for (int j = 2; j < kStrausTable; j++) {
+		eccadd(table[0], Q); // Q = (j+1)*P
+		R1_to_R2(Q, table[j]);
+	}
+}
+
+// Bucket window minimizing (number of windows) * (point additions + bucket sum)
+unsigned pick_bucket_window(size_t n, unsigned bits) {
+	unsigned best = kMinBucketWindow;
+	double best_cost = 0;
+	for (unsigned c = kMinBucketWindow; c <= kMaxBucketWindow; c++) {
+		double windows = (double)((bits + c - 1) / c + 1);
+		double cost = windows * ((double)n + (double)(1u << c));
+		if (c == kMinBucketWindow || cost < best_cost) {
+			best = c;
+			best_cost = cost;
+		}
+	}
+	return best;
+}
+
+// buckets[|d|-1] += sign(d) * points[i] for i in [begin, end), d = digit(i) (called in
+// order); a bucket's first point is copied in rather than added to the identity
+template<typename Digit>
+void scatter_buckets(std::span<const point_extproj> points, std::span<const point_extproj_precomp> pre, size_t begin, size_t end,
+	const Digit& digit, std::span<point_extproj> buckets, std::span<uint8_t> used) {
+	point_extproj_precomp_t neg;
+	for (size_t i = begin; i < end; i++) {
+		const int32_t d = digit(i);
+		if (d == 0) {
+			continue;
+		}
+		const size_t idx = (size_t)(d > 0 ? d : -d) - 1;
+		if (!used[idx]) {
+			std::memcpy(&buckets[idx], &points[i], sizeof(point_extproj));
+			if (d < 0) {
+				negate_extproj(&buckets[idx]);
+			}
+			used[idx] = 1;
+		} else if (d > 0) {
+			add_r2(&pre[i], &buckets[idx]);
+		} else {
+			negate_r2(&pre[i], neg);
+			eccadd(neg, &buckets[idx]);
+		}
+	}
+}
+
+// total = sum((j+1) * buckets[j]) over the used buckets, with a running sum from the top
+// bucket down (2 additions per bucket). Returns false, total untouched, if none is used.
+bool gather_buckets(std::span<point_extproj> buckets, std::span<const uint8_t> used, point_extproj* total) {
+	bool run_started = false, total_started = false;
+	point_extproj_t running;
+	for (size_t j = buckets.size(); j-- > 0;) {
+		if (used[j]) {
+			if (run_started) {
+				add_r1(&buckets[j], running);
+			} else {
+				std::memcpy(running, &buckets[j], sizeof(point_extproj_t));
+				run_started = true;
+			}
+		}
+		if (run_started) {
+			if (total_started) {
+				add_r1(running, total);
+			} else {
+				std::memcpy(total, running, sizeof(point_extproj_t));
+				total_started = true;
+			}
+		}
+	}
+	return total_started;
+}
+
+// R = sum(2^(c*w) * sums[w]) over the used windows, Horner from the top window
+void combine_windows(std::span<const point_extproj> sums, std::span<const uint8_t> used, unsigned c, point_extproj_t R) {
+	set_identity(R);
+	bool started = false;
+	for (size_t w = sums.size(); w-- > 0;) {
+		if (started) {
+			for (unsigned b = 0; b < c; b++) {
+				eccdouble(R);
+			}
+		}
+		if (used[w]) {
+			add_r1(&sums[w], R);
+			started = true;
+		}
+	}
+}
+
+// --- Parallel Pippenger ---
+
+constexpr size_t kMinRangePoints = 1024; // Smallest point range worth its own bucket array
+
+struct ParallelPlan {
+	unsigned c;       // Bucket window
+	unsigned windows;
+	size_t ranges;    // Point ranges per window
+};
+
+// With P ranges, each of the W*P tasks costs about n/P bucket additions plus 2^c for the
+// gather, and the tasks run `threads` at a time: minimize ceil(W*P / threads) * that
+ParallelPlan plan_parallel(size_t n, unsigned bits, unsigned threads) {
+	const size_t max_ranges = std::max<size_t>(1, std::min<size_t>(4 * (size_t)threads, n / kMinRangePoints));
+	ParallelPlan best{kMinBucketWindow, 0, 1};
+	double best_cost = 0;
+	for (unsigned c = kMinBucketWindow; c <= kMaxBucketWindow; c++) {
+		const unsigned windows = (bits + c - 1) / c + 1;
+		for (size_t ranges = 1; ranges <= max_ranges; ranges++) {
+			const double rounds = (double)((windows * ranges + threads - 1) / threads);
+			const double cost = rounds * ((double)n / (double)ranges + (double)(1u << c));
+			if (best.windows == 0 || cost < best_cost) {
+				best = {c, windows, ranges};
+				best_cost = cost;
+			}
+		}
+	}
+	return best;
+}
+
+// Carry bits of the signed recoding: bit i of row w is the carry out of window w of
+// scalar i, so a task can recode any window without walking the lower ones
+class CarryTable {
+public:
+	// Zeroed storage from the caller's scratch
+	CarryTable(size_t n, unsigned windows, const Scratch& scratch)
+		: _words((n + 63) / 64), _bits(scratch.vector<uint64_t>((size_t)windows * _words)) {}
+
+	size_t words() const { return _words; }
+	bool get(unsigned w, size_t i) const { return (_bits[w * _words + i / 64] >> (i % 64)) & 1; }
+	uint64_t* row(unsigned w) { return _bits.data() + w * _words; }
+
+private:
+	size_t _words;
+	std::pmr::vector<uint64_t> _bits;
+};
+
+// executor.run(ntasks, fn) without a heap copy of fn: std::function keeps a reference_wrapper
+// in place, where a closure with several captures would be allocated
+template<typename F>
+void run_tasks(const Curve::FourQ::Executor& executor, size_t ntasks, const F& fn) {
+	executor.run(ntasks, std::cref(fn));
+}
+
+// Splits [0, n) into `parts` contiguous slices and runs them as executor tasks
+template<typename F>
+void for_slices(const Curve::FourQ::Executor& executor, size_t n, size_t parts, const F& fn) {
+	parts = std::max<size_t>(1, std::min(parts, n));
+	run_tasks(executor, parts, [&](size_t t) { fn(n * t / parts, n * (t + 1) / parts); });
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+void multi_mul_straus(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R) {
+	const size_t n = points.size();
+	Scratch scratch;
+	auto terms = scratch.vector<StrausTerm>(n);
+	point_extproj_precomp_t neg;
+	int32_t digits[kStrausDigits];
+
+	for (size_t i = 0; i < n; i++) {
+		build_table(&points[i], terms[i].table);
+		recode_signed(scalars[i], kStrausWindow, digits, kStrausDigits);
+		for (int j = 0; j < kStrausDigits; j++) {
+			terms[i].digits[j] = (int8_t)digits[j];
+		}
+	}
+
+	bool started = false;
+	set_identity(R);
+	for (int w = kStrausDigits - 1; w >= 0; w--) {
+		if (started) {
+			for (int b = 0; b < kStrausWindow; b++) {
+				eccdouble(R);
+			}
+		}
+		for (auto& t : terms) {
+			int d = t.digits[w];
+			if (d > 0) {
+				eccadd(t.table[d - 1], R);
+				started = true;
+			} else if (d < 0) {
+				negate_r2(t.table[-d - 1], neg);
+				eccadd(neg, R);
+				started = true;
+			}
+		}
+	}
+}
+
+void multi_mul_pippenger(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R) {
+	const size_t n = points.size();
+	unsigned bits = 0;
+	for (const auto& k : scalars) {
+		unsigned b = scalar_bitlength(k);
+		bits = b > bits ? b : bits;
+	}
+	set_identity(R);
+	if (n == 0 || bits == 0) {
+		return;
+	}
+
+	const unsigned c = pick_bucket_window(n, bits);
+	const unsigned ndigits = (bits + c - 1) / c + 1;
+	const size_t nbuckets = (size_t)1 << (c - 1);
+	const int32_t half = 1 << (c - 1);
+
+	Scratch scratch;
+	auto pre = scratch.vector<point_extproj_precomp>(n);
+	for (size_t i = 0; i < n; i++) {
+		r1_to_r2(&points[i], &pre[i]);
+	}
+
+	// Windows are processed from the least significant one so the signed-digit
+	// carries can be kept per scalar instead of storing every digit up front
+	auto carries = scratch.vector<uint8_t>(n);
+	auto window_sums = scratch.vector<point_extproj>(ndigits);
+	auto window_used = scratch.vector<uint8_t>(ndigits);
+	auto buckets = scratch.vector<point_extproj>(nbuckets);
+	auto used = scratch.vector<uint8_t>(nbuckets);
+
+	for (unsigned w = 0; w < ndigits; w++) {
+		// Scatter: bucket[|d|-1] += sign(d) * P_i
+		std::fill(used.begin(), used.end(), 0);
+		scatter_buckets(points, pre, 0, n, [&](size_t i) {
+			int32_t d = (int32_t)scalar_bits(scalars[i], w * c, c) + carries[i];
+			carries[i] = (d > half) ? 1 : 0;
+			return d - ((int32_t)carries[i] << c);
+		}, buckets, used);
+
+		// Gather: sum((j+1) * bucket[j])
+		window_used[w] = gather_buckets(buckets, used, &window_sums[w]);
+	}
+
+	combine_windows(window_sums, window_used, c, R);
+}
+
+void multi_mul_parallel(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R,
+	const Executor& executor) {
+	const size_t n = points.size();
+	const unsigned threads = std::max(executor.concurrency, 1u);
+	const size_t slices = 4 * (size_t)threads;
+	// The shared tables come from the calling thread's scratch; the tasks only read and
+	// write them, and take their own buckets from the thread running them
+	Scratch scratch;
+
+	const size_t parts = std::max<size_t>(1, std::min(slices, n));
+	auto slice_bits = scratch.vector<unsigned>(parts);
+	run_tasks(executor, parts, [&](size_t t) {
+		for (size_t i = n * t / parts; i < n * (t + 1) / parts; i++) {
+			slice_bits[t] = std::max(slice_bits[t], scalar_bitlength(scalars[i]));
+		}
+	});
+	const unsigned bits = *std::max_element(slice_bits.begin(), slice_bits.end());
+	set_identity(R);
+	if (bits == 0) {
+		return;
+	}
+
+	const ParallelPlan plan = plan_parallel(n, bits, threads);
+	const unsigned c = plan.c;
+	const size_t nbuckets = (size_t)1 << (c - 1);
+	const int32_t half = 1 << (c - 1);
+
+	// R2 forms and the carry table, over 64-scalar words so each word has one writer
+	auto pre = scratch.vector<point_extproj_precomp>(n);
+	CarryTable carries(n, plan.windows, scratch);
+	for_slices(executor, carries.words(), slices, [&](size_t wbegin, size_t wend) {
+		const size_t end = std::min(n, 64 * wend);
+		for (size_t i = 64 * wbegin; i < end; i++) {
+			r1_to_r2(&points[i], &pre[i]);
+			uint32_t carry = 0;
+			for (unsigned w = 0; w < plan.windows; w++) {
+				carry = (int32_t)(scalar_bits(scalars[i], w * c, c) + carry) > half ? 1 : 0;
+				carries.row(w)[i / 64] |= (uint64_t)carry << (i % 64);
+			}
+		}
+	});
+
+	// One task per (window, range): its own buckets, one partial window sum
+	const size_t ranges = plan.ranges;
+	auto partial = scratch.vector<point_extproj>(plan.windows * ranges);
+	auto partial_used = scratch.vector<uint8_t>(plan.windows * ranges);
+	run_tasks(executor, plan.windows * ranges, [&](size_t task) {
+		const unsigned w = (unsigned)(task / ranges);
+		const size_t r = task % ranges;
+		const size_t begin = n * r / ranges, end = n * (r + 1) / ranges;
+		// From the running thread's scratch arena: a pool worker keeps its blocks between
+		// tasks and calls, and nothing stays pinned once the task is done
+		Scratch task_scratch;
+		auto buckets = task_scratch.vector<point_extproj>(nbuckets);
+		auto used = task_scratch.vector<uint8_t>(nbuckets);
+		scatter_buckets(points, pre, begin, end, [&](size_t i) {
+			const int32_t cin = w > 0 && carries.get(w - 1, i) ? 1 : 0;
+			const int32_t cout = carries.get(w, i) ? 1 : 0;
+			return (int32_t)scalar_bits(scalars[i], w * c, c) + cin - (cout << c);
+		}, buckets, used);
+		partial_used[task] = gather_buckets(buckets, used, &partial[task]);
+	});
+
+	// Tree reduction over the ranges of every window: at stride s, range r += range r + s
+	for (size_t s = 1; s < ranges; s *= 2) {
+		const size_t pairs = (ranges - s + 2 * s - 1) / (2 * s); // r = 0, 2s, 4s, ... with r + s < ranges
+		run_tasks(executor, plan.windows * pairs, [&](size_t task) {
+			const size_t w = task / pairs, r = (task % pairs) * 2 * s;
+			point_extproj* dst = &partial[w * ranges + r];
+			const point_extproj* src = &partial[w * ranges + r + s];
+			if (!partial_used[w * ranges + r + s]) {
+				return;
+			}
+			if (partial_used[w * ranges + r]) {
+				add_r1(src, dst);
+			} else {
+				std::memcpy(dst, src, sizeof(point_extproj));
+				partial_used[w * ranges + r] = 1;
+			}
+		});
+	}
+
+	auto window_sums = scratch.vector<point_extproj>(plan.windows);
+	auto window_used = scratch.vector<uint8_t>(plan.windows);
+	for (unsigned w = 0; w < plan.windows; w++) {
+		window_sums[w] = partial[w * ranges];
+		window_used[w] = partial_used[w * ranges];
+	}
+	combine_windows(window_sums, window_used, c, R);
+}
+
+void multi_mul(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R) {
+	if (points.size() < kPippengerThreshold) {
+		multi_mul_straus(scalars, points, R);
+	} else {
+		multi_mul_pippenger(scalars, points, R);
+	}
+}
+
+} // namespace detail
+
+
+// --- Executor ---
+
+Executor Executor::threads(unsigned threads) {
+	// Shared by every copy of the executor; the workers exit with the last copy
+	auto pool = std::make_shared<detail::WorkerPool>(threads);
+	Executor executor;
+	executor.concurrency = pool->threads();
+	executor.run = [pool](size_t ntasks, const std::function<void(size_t)>& task) {
+		pool->run(ntasks, [&](size_t t, unsigned) { task(t); });
+	};
+	return executor;
+}
+
+
+// --- Point::MultiMul ---
+
+// Spans are reinterpreted in place, see the layout static_asserts in fourq.hpp
+Point Point::MultiMul(std::span<const Scalar> scalars, std::span<const Point> points) {
+	if (scalars.size() != points.size()) {
+		throw std::invalid_argument("Point::MultiMul: scalars and points must have the same length");
+	}
+	FASTECC_STAT_SCOPE_N(MultiMul, scalars.size());
+
+	Point ret;
+	detail::multi_mul(
+		std::span<const fourq_scalar_t>(reinterpret_cast<const fourq_scalar_t*>(scalars.data()), scalars.size()),
+		std::span<const point_extproj>(reinterpret_cast<const point_extproj*>(points.data()), points.size()),
+		ret._pe);
+	return ret;
+}
+
+Point Point::MultiMul(std::span<const Scalar> scalars, std::span<const Point> points, const Executor& executor) {
+	if (scalars.size() != points.size()) {
+		throw std::invalid_argument("Point::MultiMul: scalars and points must have the same length");
+	}
+	if (scalars.size() < detail::kParallelMsmThreshold || executor.concurrency <= 1 || !executor.run) {
+		return MultiMul(scalars, points);
+	}
+	FASTECC_STAT_SCOPE_N(MultiMul, scalars.size());
+
+	Point ret;
+	detail::multi_mul_parallel(
+		std::span<const fourq_scalar_t>(reinterpret_cast<const fourq_scalar_t*>(scalars.data()), scalars.size()),
+		std::span<const point_extproj>(reinterpret_cast<const point_extproj*>(points.data()), points.size()),
+		ret._pe, executor);
+	return ret;
+}
+
+Point MultiMul(const ScalarBatch& scalars, const PointBatch& points) {
+	if (scalars.size() != points.size()) {
+		throw std::invalid_argument("MultiMul: scalars and points must have the same length");
+	}
+	FASTECC_STAT_SCOPE_N(MultiMul, scalars.size());
+
+	// The engine needs R1 (and builds R2) forms anyway; set them up from the affine lanes
+	const size_t n = points.size();
+	detail::Scratch scratch;
+	auto ks = scratch.vector<fourq_scalar_t>(n);
+	auto ps = scratch.vector<point_extproj>(n);
+	for (size_t i = 0; i < n; i++) {
+		for (unsigned j = 0; j < ScalarBatch::kLimbs; j++) {
+			ks[i][j] = scalars.limb(j)[i];
+		}
+		point_affine A;
+		digit_t* a = reinterpret_cast<digit_t*>(&A);
+		for (unsigned j = 0; j < PointBatch::kLimbs; j++) {
+			a[j] = points.limb(j)[i];
+		}
+		point_setup(&A, &ps[i]);
+	}
+
+	Point ret;
+	detail::multi_mul(ks, ps, reinterpret_cast<point_extproj*>(&ret));
+	return ret;
+}
+
+} // namespace FourQ
+} // namespace Curve
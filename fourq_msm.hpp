@@ -0,0 +1,37 @@
+#pragma once // 头文件保护
+
+// Internal multi-scalar multiplication engine shared by Point::MultiMul and the
+// SchnorrQ batch verifier. Not part of the public wrapper API.
+
+#include <cstddef>
+#include <span>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// Below this many terms interleaved Straus beats Pippenger buckets
+constexpr size_t kPippengerThreshold = 96;
+
+// R = sum(scalars[i] * points[i]), variable time (inputs must be public).
+// Points are in extended projective (R1) form; scalars are any 256-bit values.
+// Picks Straus or Pippenger depending on the number of terms.
+void multi_mul(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R);
+
+// The two strategies, exposed so they can be tested against each other
+void multi_mul_straus(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R);
+void multi_mul_pippenger(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R);
+
+// Below this many terms Point::MultiMul(..., Executor) stays on the calling thread
+constexpr size_t kParallelMsmThreshold = 4096;
+
+// Pippenger with every (bucket window, point range) pair as one executor task, whatever n
+// is; the partial window sums are then added up in a tree of tasks. Same R as multi_mul.
+void multi_mul_parallel(std::span<const fourq_scalar_t> scalars, std::span<const point_extproj> points, point_extproj_t R,
+	const Executor& executor);
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
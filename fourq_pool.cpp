@@ -0,0 +1,122 @@
+#include "fourq_pool.hpp"
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+namespace {
+
+// The pool whose task this thread is running, if any, and the thread's id in it
+struct RunningPool {
+	const WorkerPool* pool = nullptr;
+	unsigned id = 0;
+};
+thread_local RunningPool t_running;
+
+} // anonymous namespace
+
+WorkerPool::WorkerPool(unsigned threads) {
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads == 0) {
+		threads = 1; // hardware_concurrency() may not know
+	}
+	_workers.reserve(threads - 1);
+	for (unsigned id = 1; id < threads; id++) {
+		_workers.emplace_back(&WorkerPool::workerLoop, this, id);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stop = true;
+	}
+	_wake.notify_all();
+	for (std::thread& t : _workers) {
+		t.join();
+	}
+}
+
+void WorkerPool::workerLoop(unsigned id) {
+	t_running = {this, id};
+	uint64_t seen = 0;
+	std::unique_lock<std::mutex> lock(_mutex);
+	for (;;) {
+		_wake.wait(lock, [&] { return _stop || _generation != seen; });
+		if (_stop) {
+			return;
+		}
+		seen = _generation;
+		lock.unlock();
+		drain(id);
+		lock.lock();
+		if (--_busy == 0) {
+			_done.notify_one();
+		}
+	}
+}
+
+void WorkerPool::drain(unsigned id) {
+	for (;;) {
+		const size_t t = _next.fetch_add(1, std::memory_order_relaxed);
+		if (t >= _ntasks) {
+			return;
+		}
+		try {
+			(*_task)(t, id);
+		} catch (...) {
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (!_error) {
+				_error = std::current_exception();
+			}
+		}
+	}
+}
+
+void WorkerPool::run(size_t ntasks, const std::function<void(size_t, unsigned)>& task) {
+	if (ntasks == 0) {
+		return;
+	}
+	// Nested in one of our own tasks (the pool is busy with the outer run), no workers,
+	// or nothing to share: inline
+	if (t_running.pool == this || _workers.empty() || ntasks == 1) {
+		const unsigned id = t_running.pool == this ? t_running.id : 0;
+		for (size_t t = 0; t < ntasks; t++) {
+			task(t, id);
+		}
+		return;
+	}
+
+	std::lock_guard<std::mutex> turn(_runMutex);
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_task = &task;
+		_ntasks = ntasks;
+		_next.store(0, std::memory_order_relaxed);
+		_busy = (unsigned)_workers.size();
+		_error = nullptr;
+		_generation++;
+	}
+	_wake.notify_all();
+	const RunningPool outer = t_running;
+	t_running = {this, 0};
+	drain(0);
+	t_running = outer;
+
+	// Every worker has to leave this generation before _task goes out of scope
+	std::unique_lock<std::mutex> lock(_mutex);
+	_done.wait(lock, [&] { return _busy == 0; });
+	_task = nullptr;
+	if (_error) {
+		std::exception_ptr error = _error;
+		_error = nullptr;
+		std::rethrow_exception(error);
+	}
+}
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
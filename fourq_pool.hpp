@@ -0,0 +1,62 @@
+#pragma once // 头文件保护
+
+// Internal fixed-size thread pool behind SchnorrQBatchEngine and Executor::threads(). Not
+// part of the public wrapper API.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// --- WorkerPool Class Declaration ---
+// threads - 1 workers started once and parked on a condition variable between runs
+// (implementation in fourq_pool.cpp); the calling thread takes part in every run. Workers
+// keep their thread_local state (scratch arenas, RNG) across runs.
+class WorkerPool {
+public:
+	// threads == 0 uses std::thread::hardware_concurrency()
+	explicit WorkerPool(unsigned threads);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	unsigned threads() const { return (unsigned)_workers.size() + 1; }
+
+	// Calls task(t, id) for every t in [0, ntasks) and returns once all calls have returned;
+	// id in [0, threads()) names the thread running it, 0 being the caller. Rethrows the
+	// first exception a task threw. Runs from different threads take turns; a run started
+	// from inside a task of this pool executes inline on that thread.
+	void run(size_t ntasks, const std::function<void(size_t, unsigned)>& task);
+
+private:
+	void workerLoop(unsigned id);
+	void drain(unsigned id);
+
+	std::vector<std::thread> _workers;
+	std::mutex _runMutex; // Serializes run()
+
+	// Current run; guarded by _mutex except for the atomic task counter
+	std::mutex _mutex;
+	std::condition_variable _wake, _done;
+	const std::function<void(size_t, unsigned)>* _task = nullptr;
+	size_t _ntasks = 0;
+	std::atomic<size_t> _next{0};
+	unsigned _busy = 0;        // Workers still inside the current generation
+	uint64_t _generation = 0;
+	bool _stop = false;
+	std::exception_ptr _error; // First exception thrown by a task, rethrown by run()
+};
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
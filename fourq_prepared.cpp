@@ -0,0 +1,176 @@
+#include "fourq.hpp"
+#include "fourq_comb.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_sha512.hpp"
+
+#include <algorithm> // For std::sort
+#include <cstring>   // For memcpy, memcmp
+#include <stdexcept> // For std::invalid_argument, std::runtime_error
+#include <vector>
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::fourq_scalar_t;
+
+// Scalars reduced mod the 246-bit curve order
+constexpr unsigned kScalarBits = 246;
+constexpr unsigned kMaxTeeth = 8;
+constexpr unsigned kMaxTables = 8;
+
+unsigned scalar_bit(const fourq_scalar_t& k, unsigned pos) {
+	if (pos >= 64 * NWORDS_ORDER) {
+		return 0;
+	}
+	return (unsigned)(k[pos / 64] >> (pos % 64)) & 1;
+}
+
+// Adds R1 point Q into R1 point P
+void add_extproj(point_extproj_t P, point_extproj_t Q) {
+	point_extproj_precomp_t Q_precomp;
+	R1_to_R2(Q, Q_precomp);
+	eccadd(Q_precomp, P);
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+PreparedPoint::PreparedPoint(const Point& P, unsigned teeth, unsigned tables)
+	: _p(P), _teeth(teeth), _tables(tables)
+{
+	if (teeth < 1 || teeth > kMaxTeeth || tables < 1 || tables > kMaxTables) {
+		throw std::invalid_argument("PreparedPoint: teeth and tables must be in [1, 8]");
+	}
+	_p.normalize();
+	_raw = _p.getRaw();
+	_rows = (kScalarBits + teeth - 1) / teeth;
+	_block = (_rows + tables - 1) / tables;
+
+	// Bases B[v][i] = 2^(i*rows + v*block) * P, computed by doubling in exponent order
+	struct Base {
+		unsigned exponent, v, i;
+	};
+	std::vector<Base> order;
+	for (unsigned i = 0; i < teeth; i++) {
+		for (unsigned v = 0; v < tables; v++) {
+			order.push_back({i * _rows + v * _block, v, i});
+		}
+	}
+	std::sort(order.begin(), order.end(), [](const Base& x, const Base& y) { return x.exponent < y.exponent; });
+
+	std::vector<point_extproj> bases(teeth * tables);
+	point_extproj_t Q;
+	std::memcpy(Q, _p._pe, sizeof(point_extproj_t));
+	unsigned exponent = 0;
+	for (const Base& b : order) {
+		for (; exponent < b.exponent; exponent++) {
+			eccdouble(Q);
+		}
+		std::memcpy(&bases[b.v * teeth + b.i], Q, sizeof(point_extproj_t));
+	}
+
+	// T_v[u] = sum of B[v][i] over the set bits i of u, built from T_v[u without its top bit]
+	const size_t per_table = ((size_t)1 << teeth) - 1;
+	std::vector<point_extproj> sums(per_table);
+	_table.resize(tables * per_table);
+	for (unsigned v = 0; v < tables; v++) {
+		for (size_t u = 1; u <= per_table; u++) {
+			unsigned top = 0;
+			while ((u >> (top + 1)) != 0) {
+				top++;
+			}
+			const size_t rest = u & ~((size_t)1 << top);
+			std::memcpy(&sums[u - 1], &bases[v * teeth + top], sizeof(point_extproj));
+			if (rest != 0) {
+				add_extproj(&sums[u - 1], &sums[rest - 1]);
+			}
+			R1_to_R2(&sums[u - 1], &_table[v * per_table + u - 1]);
+		}
+	}
+}
+
+void PreparedPoint::comb(const fourq_scalar_t& k, point_extproj_t R) const {
+	const size_t per_table = ((size_t)1 << _teeth) - 1;
+	bool started = false;
+	std::memcpy(R, Point()._pe, sizeof(point_extproj_t)); // Identity
+	for (unsigned j = _block; j-- > 0;) {
+		if (started) {
+			eccdouble(R);
+		}
+		for (unsigned v = 0; v < _tables; v++) {
+			const unsigned offset = v * _block + j; // Position inside each row
+			if (offset >= _rows) {
+				continue; // The last block of a row can be shorter
+			}
+			size_t u = 0;
+			for (unsigned i = 0; i < _teeth; i++) {
+				u |= (size_t)scalar_bit(k, i * _rows + offset) << i;
+			}
+			if (u != 0) {
+				detail::add_r2(&_table[v * per_table + u - 1], R);
+				started = true;
+			}
+		}
+	}
+}
+
+Point PreparedPoint::mul(const Scalar& k) const {
+	Point ret;
+	fourq_scalar_t kr;
+	modulo_order(detail::scalar_words(k._b), kr.data());
+	comb(kr, ret._pe);
+	return ret;
+}
+
+Point PreparedPoint::MulAdd(const Scalar& mG, const Scalar& mP) const {
+	Point ret = mul(mP);
+	point_t G_affine;
+	point_extproj_t sG;
+	point_extproj_precomp_t sG_precomp;
+	if (!detail::mul_fixed_base(mG._b.data(), G_affine)) {
+		throw std::runtime_error("Fixed-base multiplication failed in PreparedPoint::MulAdd");
+	}
+	point_setup(G_affine, sG);
+	R1_to_R2(sG, sG_precomp);
+	eccadd(sG_precomp, ret._pe);
+	return ret;
+}
+
+
+// --- SchnorrQ verification against a PreparedPoint ---
+
+bool SchnorrQVerify(const PreparedPoint& pubkey, std::span<const uint8_t> msg, const std::array<uint8_t, 64>& sig)
+{
+	// Same range checks as SchnorrQ_Verify; the prepared key is a valid point already
+	if ((sig[15] & 0x80) != 0 || sig[63] != 0 || (sig[62] & 0xC0) != 0) {
+		return false;
+	}
+
+	// h = H(R || A || M)
+	uint8_t h[64];
+	Sha512 ctx;
+	ctx.update(std::span<const uint8_t>(sig.data(), 32)).update(pubkey.getRaw()).update(msg);
+	ctx.final(h);
+
+	// s*G + h*A must encode to R; h is the low 256 bits of the digest, reduced
+	EccDataType hraw, sraw;
+	std::memcpy(hraw.data(), h, 32);
+	std::memcpy(sraw.data(), sig.data() + 32, 32);
+	Scalar hs(hraw), ss(sraw);
+	Point check = pubkey.MulAdd(ss, hs);
+	EccDataType raw = check.getRaw();
+	return std::memcmp(raw.data(), sig.data(), 32) == 0;
+}
+
+} // namespace FourQ
+} // namespace Curve
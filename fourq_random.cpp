@@ -0,0 +1,175 @@
+#include "fourq_random.hpp"
+
+#include <atomic>
+#include <cstring> // For memcpy, memset
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h> // For pthread_atfork
+#define FASTECC_HAVE_FORK 1
+#endif
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h" // For clear_words
+#include "FourQlib/random/random.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+constexpr size_t kBlocks = 16;
+constexpr size_t kBufferSize = 64 * kBlocks;
+constexpr size_t kKeySize = 32;
+constexpr uint64_t kReseedInterval = (uint64_t)1 << 20; // Bytes of output between reseeds
+
+inline uint32_t rotl(uint32_t x, int n) {
+	return (x << n) | (x >> (32 - n));
+}
+
+inline void quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+	a += b; d ^= a; d = rotl(d, 16);
+	c += d; b ^= c; b = rotl(b, 12);
+	a += b; d ^= a; d = rotl(d, 8);
+	c += d; b ^= c; b = rotl(b, 7);
+}
+
+inline uint32_t load_le32(const uint8_t* p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+inline void store_le32(uint8_t* p, uint32_t v) {
+	for (int i = 0; i < 4; i++) {
+		p[i] = static_cast<uint8_t>(v >> (8 * i));
+	}
+}
+
+// Bumped in every forked child; a generator seeded under an older value reseeds
+std::atomic<uint64_t> g_fork_generation{0};
+
+#if defined(FASTECC_HAVE_FORK)
+void on_fork_child() {
+	g_fork_generation.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+void register_fork_handler() {
+#if defined(FASTECC_HAVE_FORK)
+	static const bool registered = pthread_atfork(nullptr, nullptr, on_fork_child) == 0;
+	(void)registered;
+#endif
+}
+
+class Generator {
+public:
+	~Generator() {
+		clear_words(_key, (digit_t)(sizeof(_key) / sizeof(unsigned int)));
+		clear_words(_buf, (digit_t)(sizeof(_buf) / sizeof(unsigned int)));
+	}
+
+	bool read(uint8_t* out, size_t n) {
+		const uint64_t generation = g_fork_generation.load(std::memory_order_relaxed);
+		if (!_seeded || _generation != generation || _output >= kReseedInterval) {
+			if (!reseed(generation)) {
+				std::memset(out, 0, n);
+				return false;
+			}
+		}
+		_output += n;
+		while (n > 0) {
+			if (_avail == 0) {
+				refill();
+			}
+			const size_t take = n < _avail ? n : _avail;
+			uint8_t* src = _buf + (kBufferSize - _avail);
+			std::memcpy(out, src, take);
+			std::memset(src, 0, take); // Served bytes are not kept
+			_avail -= take;
+			out += take;
+			n -= take;
+		}
+		return true;
+	}
+
+private:
+	// Mixes 32 fresh OS bytes into the key
+	bool reseed(uint64_t generation) {
+		register_fork_handler();
+		uint8_t seed[kKeySize];
+		if (!::random_bytes(seed, sizeof(seed))) {
+			return false;
+		}
+		for (size_t i = 0; i < 8; i++) {
+			_key[i] ^= load_le32(seed + 4 * i);
+		}
+		clear_words(seed, (digit_t)(sizeof(seed) / sizeof(unsigned int)));
+		refill(); // Discards whatever the old key had buffered
+		_seeded = true;
+		_generation = generation;
+		_output = 0;
+		return true;
+	}
+
+	// 16 blocks under the current key; the first 32 bytes become the next key
+	void refill() {
+		static constexpr uint32_t kNonce[3] = {0, 0, 0};
+		for (uint32_t b = 0; b < kBlocks; b++) {
+			Curve::FourQ::detail::chacha20_block(_key, b, kNonce, _buf + 64 * b);
+		}
+		for (size_t i = 0; i < 8; i++) {
+			_key[i] = load_le32(_buf + 4 * i);
+		}
+		std::memset(_buf, 0, kKeySize);
+		_avail = kBufferSize - kKeySize;
+	}
+
+	uint32_t _key[8] = {};
+	uint8_t _buf[kBufferSize] = {};
+	size_t _avail = 0;     // Unread bytes at the end of _buf
+	uint64_t _output = 0;  // Bytes served since the last reseed
+	uint64_t _generation = 0;
+	bool _seeded = false;
+};
+
+Generator& thread_generator() {
+	thread_local Generator generator;
+	return generator;
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+bool randomBytes(std::span<uint8_t> out) {
+	return thread_generator().read(out.data(), out.size());
+}
+
+void detail::chacha20_block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], uint8_t out[64]) {
+	uint32_t s[16] = {
+		0x61707865, 0x3320646e, 0x79622d32, 0x6b206574, // "expand 32-byte k"
+		key[0], key[1], key[2], key[3], key[4], key[5], key[6], key[7],
+		counter, nonce[0], nonce[1], nonce[2],
+	};
+	uint32_t x[16];
+	std::memcpy(x, s, sizeof(x));
+	for (int i = 0; i < 10; i++) {
+		quarter_round(x[0], x[4], x[8], x[12]);
+		quarter_round(x[1], x[5], x[9], x[13]);
+		quarter_round(x[2], x[6], x[10], x[14]);
+		quarter_round(x[3], x[7], x[11], x[15]);
+		quarter_round(x[0], x[5], x[10], x[15]);
+		quarter_round(x[1], x[6], x[11], x[12]);
+		quarter_round(x[2], x[7], x[8], x[13]);
+		quarter_round(x[3], x[4], x[9], x[14]);
+	}
+	for (int i = 0; i < 16; i++) {
+		store_le32(out + 4 * i, x[i] + s[i]);
+	}
+	clear_words(x, (digit_t)(sizeof(x) / sizeof(unsigned int)));
+	clear_words(s, (digit_t)(sizeof(s) / sizeof(unsigned int)));
+}
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,28 @@
+#pragma once // 头文件保护
+
+// Buffered per-thread CSPRNG for keys, nonces and batch-verification coefficients.
+//
+// FourQlib's random_bytes opens and reads /dev/urandom on every call. Here every thread
+// keeps a ChaCha20 generator seeded from random_bytes and serves reads from a 1 KB
+// keystream buffer ("fast key erasure": each refill starts by replacing the key with fresh
+// keystream, and served bytes are wiped). A generator reseeds after 1 MB of output, and in
+// a forked child before its first read, so parent and child never share a stream.
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Curve {
+namespace FourQ {
+
+// Fills out with random bytes. Returns false, with out zeroed, if the OS entropy source
+// (random_bytes) fails when the thread's generator has to be seeded.
+bool randomBytes(std::span<uint8_t> out);
+
+namespace detail {
+// RFC 8439 ChaCha20 block function: 64 bytes of keystream for (key, counter, nonce)
+void chacha20_block(const uint32_t key[8], uint32_t counter, const uint32_t nonce[3], uint8_t out[64]);
+} // namespace detail
+
+} // namespace FourQ
+} // namespace Curve
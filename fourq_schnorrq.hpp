@@ -0,0 +1,39 @@
+#pragma once // 头文件保护
+
+// Internal SchnorrQ signing primitives shared by SchnorrQSign and the batch engine.
+// Not part of the public wrapper API.
+
+#include <cstdint>
+#include <span>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+// Everything signing needs that depends only on the key: the 32-byte encodings of the
+// secret scalar and of A = k*G, and the nonce prefix (upper half of H(SecretKey)).
+// The caller owns the three 32-byte outputs and should clear sk and prefix afterwards.
+// If pub is given it receives A itself (normalized).
+void schnorrq_expand_key(const Scalar& secretKey, uint8_t* sk, uint8_t* pk, uint8_t* prefix, Point* pub = nullptr);
+
+// SchnorrQ signing core over an expanded key: r = H(prefix || M), R = r*G,
+// h = H(R || A || M), s = r - k*h mod order. Writes the 64-byte signature.
+bool schnorrq_sign(const uint8_t* sk, const uint8_t* prefix, const uint8_t* pk, std::span<const uint8_t> msg, uint8_t* sig);
+
+struct SignRequest {
+	const uint8_t* sk;     // 32 bytes each, as for schnorrq_sign
+	const uint8_t* prefix;
+	const uint8_t* pk;
+	std::span<const uint8_t> msg;
+	uint8_t* sig;          // 64 bytes out
+};
+
+// schnorrq_sign for every request, ok[i] its result. The two hashes of each signature go
+// through Sha512::hashMany, several signatures per SHA-512 compression.
+void schnorrq_sign_many(std::span<const SignRequest> reqs, bool* ok);
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,278 @@
+#include "fourq_scratch.hpp"
+#include "fourq_internal.hpp"
+
+#include <algorithm> // For std::max, std::min
+#include <new>       // For std::bad_alloc, std::align_val_t
+
+#if defined(FASTECC_HEAP_CHECK)
+#include <cstdio>  // For fprintf
+#include <cstdlib> // For malloc, aligned_alloc, free, abort
+#endif
+
+
+namespace Curve {
+namespace FourQ {
+
+// Header at the start of every block; the block's storage follows it
+struct ScratchArena::Block {
+	Block* next;
+	std::byte* data;
+	size_t size;
+	bool owned; // Taken from upstream (not the caller's buffer)
+};
+
+namespace {
+
+// Bytes reserved for the Block header; keeps the storage max_align_t aligned
+constexpr size_t kHeader = 32;
+
+size_t padding(const std::byte* p, size_t alignment) {
+	const uintptr_t a = (uintptr_t)p;
+	return (alignment - a % alignment) % alignment;
+}
+
+// The resource ScratchScope installed on this thread, if any
+struct ThreadScratch {
+	std::pmr::memory_resource* resource = nullptr;
+	ScratchArena* arena = nullptr;
+};
+thread_local ThreadScratch t_scratch;
+
+} // anonymous namespace
+
+
+// --- ScratchArena ---
+
+ScratchArena::ScratchArena(size_t blockSize, std::pmr::memory_resource* upstream)
+	: _upstream(upstream), _blockSize(std::max(blockSize, kHeader + alignof(std::max_align_t))) {}
+
+ScratchArena::ScratchArena(std::span<std::byte> buffer, std::pmr::memory_resource* upstream)
+	: ScratchArena(kDefaultBlockSize, upstream)
+{
+	static_assert(sizeof(Block) <= kHeader && kHeader % alignof(std::max_align_t) == 0);
+	std::byte* p = buffer.data();
+	const size_t pad = padding(p, alignof(Block));
+	if (buffer.size() < pad + kHeader + 1) {
+		return; // Too small to hold anything: behaves like an arena without a buffer
+	}
+	_head = ::new (p + pad) Block{nullptr, p + pad + kHeader, buffer.size() - pad - kHeader, false};
+	_capacity = _head->size;
+}
+
+ScratchArena::~ScratchArena() {
+	release();
+}
+
+void ScratchArena::rewind(const Mark& m) {
+	_current = static_cast<Block*>(const_cast<void*>(m.block));
+	_offset = m.offset;
+	_base = m.base;
+}
+
+void ScratchArena::release() {
+	Block* keep = (_head != nullptr && !_head->owned) ? _head : nullptr;
+	for (Block* b = keep != nullptr ? keep->next : _head; b != nullptr;) {
+		Block* next = b->next;
+		_upstream->deallocate(b, kHeader + b->size, alignof(std::max_align_t));
+		b = next;
+	}
+	_head = keep;
+	if (keep != nullptr) {
+		keep->next = nullptr;
+	}
+	_current = nullptr;
+	_offset = 0;
+	_base = 0;
+	_capacity = keep != nullptr ? keep->size : 0;
+	_blocks = 0;
+}
+
+// Appended at the tail, so blocks kept by an earlier rewind are still tried first
+ScratchArena::Block* ScratchArena::grow(size_t bytes, size_t alignment) {
+	const size_t size = std::max(_blockSize - kHeader, bytes + alignment);
+	void* p = _upstream->allocate(kHeader + size, alignof(std::max_align_t)); // Throws std::bad_alloc
+	Block* b = ::new (p) Block{nullptr, static_cast<std::byte*>(p) + kHeader, size, true};
+	if (_head == nullptr) {
+		_head = b;
+	} else {
+		Block* tail = _head;
+		while (tail->next != nullptr) {
+			tail = tail->next;
+		}
+		tail->next = b;
+	}
+	_capacity += size;
+	_blocks++;
+	if (_blockSize < kMaxBlockSize) {
+		_blockSize = std::min(2 * _blockSize, kMaxBlockSize);
+	}
+	return b;
+}
+
+void* ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+	Block* b = _current;
+	size_t offset = _offset;
+	size_t base = _base;
+	if (b == nullptr) {
+		b = _head;
+		offset = 0;
+		base = 0;
+	}
+	for (;;) {
+		if (b == nullptr) {
+			grow(bytes, alignment);
+			b = _head;
+			offset = 0;
+			base = 0;
+			continue; // Walks to the new block at the tail
+		}
+		const size_t pad = padding(b->data + offset, alignment);
+		if (pad + bytes <= b->size - offset) {
+			_current = b;
+			_offset = offset + pad + bytes;
+			_base = base;
+			_highWater = std::max(_highWater, used());
+			return b->data + offset + pad;
+		}
+		// Skipped space in a block stays unused until a rewind past it
+		if (b->next == nullptr) {
+			grow(bytes, alignment);
+		}
+		base += b->size;
+		b = b->next;
+		offset = 0;
+	}
+}
+
+// Only the latest allocation can be taken back (e.g. the old buffer of a growing vector)
+void ScratchArena::do_deallocate(void* p, size_t bytes, size_t) {
+	if (_current != nullptr && static_cast<std::byte*>(p) + bytes == _current->data + _offset) {
+		_offset = (size_t)(static_cast<std::byte*>(p) - _current->data);
+	}
+}
+
+ScratchArena& threadScratch() {
+	thread_local ScratchArena arena;
+	return arena;
+}
+
+
+// --- ScratchScope ---
+
+ScratchScope::ScratchScope(std::pmr::memory_resource& resource)
+	: _previous(t_scratch.resource), _previousArena(t_scratch.arena)
+{
+	t_scratch.resource = &resource;
+	t_scratch.arena = dynamic_cast<ScratchArena*>(&resource);
+}
+
+ScratchScope::~ScratchScope() {
+	t_scratch.resource = _previous;
+	t_scratch.arena = _previousArena;
+}
+
+std::pmr::memory_resource* detail::scratch_resource(ScratchArena*& arena) {
+	if (t_scratch.resource == nullptr) {
+		arena = &threadScratch();
+		return arena;
+	}
+	arena = t_scratch.arena;
+	return t_scratch.resource;
+}
+
+} // namespace FourQ
+} // namespace Curve
+
+
+// --- Heap Check ---
+
+namespace {
+
+// Plain thread_local data (constant initialized), safe to touch from operator new at any time
+struct HeapCheckState {
+	uint64_t allocations = 0;
+	unsigned scopes = 0;
+	unsigned aborting = 0; // Scopes with Action::Abort
+};
+thread_local HeapCheckState t_heap;
+
+} // anonymous namespace
+
+namespace Curve {
+namespace FourQ {
+
+NoHeapScope::NoHeapScope(Action action) : _start(t_heap.allocations), _action(action) {
+	t_heap.scopes++;
+	if (action == Action::Abort) {
+		t_heap.aborting++;
+	}
+}
+
+NoHeapScope::~NoHeapScope() {
+	t_heap.scopes--;
+	if (_action == Action::Abort) {
+		t_heap.aborting--;
+	}
+}
+
+uint64_t NoHeapScope::allocations() const {
+	return t_heap.allocations - _start;
+}
+
+} // namespace FourQ
+} // namespace Curve
+
+#if defined(FASTECC_HEAP_CHECK)
+
+// Replacements for the global allocation functions. The array, nothrow and sized forms of
+// the standard library forward to these.
+namespace {
+
+void note_allocation(size_t size) {
+	if (t_heap.scopes == 0) {
+		return;
+	}
+	t_heap.allocations++;
+	if (t_heap.aborting != 0) {
+		std::fprintf(stderr, "fastecc: operator new(%zu) inside a NoHeapScope\n", size);
+		std::abort();
+	}
+}
+
+} // anonymous namespace
+
+void* operator new(size_t size) {
+	note_allocation(size);
+	if (void* p = std::malloc(size != 0 ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	note_allocation(size);
+	const size_t a = (size_t)alignment;
+	const size_t rounded = (std::max<size_t>(size, 1) + a - 1) / a * a; // aligned_alloc wants a multiple
+	if (void* p = std::aligned_alloc(a, rounded)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+	std::free(p);
+}
+
+#endif // FASTECC_HEAP_CHECK
@@ -0,0 +1,143 @@
+#pragma once // 头文件保护
+
+// Scratch memory for the wrapper's internal temporaries, and an optional check that the
+// hot paths stay off the global heap.
+//
+// Batch and sign/verify calls (SchnorrQVerifyBatch, SigningKey::signBatch, MultiMul,
+// encodeAll, normalizeAll, invertBatch, ...) take their temporary arrays from the calling
+// thread's scratch resource instead of operator new. By default that is a per-thread
+// ScratchArena: a bump allocator whose blocks are kept across calls, so once a thread has
+// run its largest batch it allocates nothing more and never touches a lock shared with
+// other threads. The parallel MultiMul takes its shared tables from the calling thread and
+// each task's buckets from the thread running it. ScratchScope routes the temporaries to
+// a caller-provided resource instead.
+//
+// Built with the CMake option FASTECC_HEAP_CHECK (defines FASTECC_HEAP_CHECK=1), the
+// library also replaces the global operator new so that NoHeapScope can assert that a
+// region allocates nothing; otherwise NoHeapScope does nothing.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+
+namespace Curve {
+namespace FourQ {
+
+#if defined(FASTECC_HEAP_CHECK)
+constexpr bool kHeapCheckEnabled = true;
+#else
+constexpr bool kHeapCheckEnabled = false;
+#endif
+
+// --- ScratchArena Class Declaration ---
+// Bump allocator over a list of blocks (implementation in fourq_scratch.cpp). deallocate()
+// only takes back the most recent allocation; everything else is reclaimed by rewind() to
+// an earlier mark(), which keeps the blocks for reuse. Not thread safe: one arena per thread.
+class ScratchArena final : public std::pmr::memory_resource {
+public:
+	static constexpr size_t kDefaultBlockSize = 64 * 1024;
+	static constexpr size_t kMaxBlockSize = 4 * 1024 * 1024; // Later blocks double up to this
+
+	// Position to rewind to; only valid for marks taken after the last release()
+	struct Mark {
+		const void* block = nullptr;
+		size_t offset = 0;
+		size_t base = 0; // Bytes in the blocks before `block`
+	};
+
+	// Blocks of at least blockSize bytes from upstream, allocated on first use
+	explicit ScratchArena(size_t blockSize = kDefaultBlockSize,
+		std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+	// Starts in the caller's buffer (which must outlive the arena) and only goes to upstream
+	// once it is full; with the default null_memory_resource() an allocation that does not
+	// fit throws std::bad_alloc
+	explicit ScratchArena(std::span<std::byte> buffer,
+		std::pmr::memory_resource* upstream = std::pmr::null_memory_resource());
+	~ScratchArena() override;
+
+	ScratchArena(const ScratchArena&) = delete;
+	ScratchArena& operator=(const ScratchArena&) = delete;
+
+	Mark mark() const { return {_current, _offset, _base}; }
+	void rewind(const Mark& m); // Frees everything allocated since m
+	void reset() { rewind(Mark{}); }
+	// Returns every block taken from upstream; nothing allocated from the arena may be live
+	void release();
+
+	size_t used() const { return _base + _offset; }  // Bytes in use, alignment padding included
+	size_t capacity() const { return _capacity; }    // Bytes in all blocks
+	size_t highWater() const { return _highWater; }  // Largest used() seen
+	size_t blocks() const { return _blocks; }        // Blocks from upstream (the buffer not counted)
+
+private:
+	struct Block;
+
+	void* do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+	bool do_is_equal(const std::pmr::memory_resource& that) const noexcept override { return this == &that; }
+
+	Block* grow(size_t bytes, size_t alignment);
+
+	std::pmr::memory_resource* _upstream;
+	size_t _blockSize;
+	Block* _head = nullptr;
+	Block* _current = nullptr; // Null: nothing allocated yet
+	size_t _offset = 0;        // Bytes used in _current
+	size_t _base = 0;          // Bytes in the blocks before _current
+	size_t _capacity = 0;
+	size_t _highWater = 0;
+	size_t _blocks = 0;
+	std::byte* _buffer = nullptr; // Caller's buffer, the head block's storage when set
+	size_t _bufferSize = 0;
+};
+
+// The calling thread's default arena (created on first use, freed when the thread exits)
+ScratchArena& threadScratch();
+
+// --- ScratchScope Class Declaration ---
+// While alive, the library's temporaries on this thread come from `resource` instead of
+// threadScratch(). Scopes nest. A ScratchArena is rewound after each call; any other
+// resource sees matching deallocate() calls. The resource must not be used by another
+// thread at the same time.
+class ScratchScope {
+public:
+	explicit ScratchScope(std::pmr::memory_resource& resource);
+	~ScratchScope();
+
+	ScratchScope(const ScratchScope&) = delete;
+	ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+	std::pmr::memory_resource* _previous;
+	ScratchArena* _previousArena;
+};
+
+// --- NoHeapScope Class Declaration ---
+// Asserts that the calling thread makes no global operator new call while the scope is
+// alive (other threads are not checked). Only active with FASTECC_HEAP_CHECK; malloc
+// calls from C code are not seen. Warm up first: the first call on a thread fills its
+// arena, builds the fixed-base comb and seeds the thread's RNG.
+class NoHeapScope {
+public:
+	enum class Action {
+		Abort, // Print the allocation size to stderr and std::abort()
+		Count, // Only count, see allocations()
+	};
+
+	explicit NoHeapScope(Action action = Action::Abort);
+	~NoHeapScope();
+
+	NoHeapScope(const NoHeapScope&) = delete;
+	NoHeapScope& operator=(const NoHeapScope&) = delete;
+
+	// operator new calls on this thread since the scope opened (0 without FASTECC_HEAP_CHECK)
+	uint64_t allocations() const;
+
+private:
+	uint64_t _start;
+	Action _action;
+};
+
+} // namespace FourQ
+} // namespace Curve
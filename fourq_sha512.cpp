@@ -0,0 +1,344 @@
+#include "fourq_sha512.hpp"
+#include "fourq.hpp" // For cpuFeatures, clear_words
+#include "fourq_sha512_mb.hpp"
+
+#include <algorithm> // For std::min, std::max
+#include <atomic>
+#include <cstring>   // For memcpy, memset
+#include <stdexcept> // For std::invalid_argument
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+constexpr uint64_t kInitialState[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+inline uint64_t rotr(uint64_t x, unsigned n) {
+	return (x >> n) | (x << (64 - n));
+}
+
+inline uint64_t load_be64(const uint8_t* p) {
+	uint64_t v = 0;
+	for (int i = 0; i < 8; i++) {
+		v = (v << 8) | p[i];
+	}
+	return v;
+}
+
+inline void store_be64(uint8_t* p, uint64_t v) {
+	for (int i = 7; i >= 0; i--) {
+		p[i] = static_cast<uint8_t>(v);
+		v >>= 8;
+	}
+}
+
+using Curve::FourQ::Sha512;
+using Curve::FourQ::Sha512Backend;
+
+Sha512Backend best_backend() {
+	if (Curve::FourQ::sha512BackendSupported(Sha512Backend::AVX512)) {
+		return Sha512Backend::AVX512;
+	}
+	if (Curve::FourQ::sha512BackendSupported(Sha512Backend::AVX2)) {
+		return Sha512Backend::AVX2;
+	}
+	return Sha512Backend::Portable;
+}
+
+std::atomic<Sha512Backend>& active_backend() {
+	static std::atomic<Sha512Backend> backend{best_backend()};
+	return backend;
+}
+
+// Kernel of the active backend, nullptr for the portable path
+const Curve::FourQ::detail::Sha512LaneKernel* active_kernel() {
+	switch (active_backend().load(std::memory_order_relaxed)) {
+#if defined(FASTECC_LANES_AVX512F)
+	case Sha512Backend::AVX512:
+		return &Curve::FourQ::detail::kSha512Avx512;
+#endif
+#if defined(FASTECC_LANES_AVX2)
+	case Sha512Backend::AVX2:
+		return &Curve::FourQ::detail::kSha512Avx2;
+#endif
+	default:
+		return nullptr;
+	}
+}
+
+uint64_t message_length(const Sha512::Message& m) {
+	uint64_t n = 0;
+	for (const auto& part : m) {
+		n += part.size();
+	}
+	return n;
+}
+
+// Padded length in blocks: message, 0x80, zeros, 128-bit bit length
+uint64_t block_count(uint64_t length) {
+	return (length + 17 + Sha512::kBlockSize - 1) / Sha512::kBlockSize;
+}
+
+// Block b of the padded message: a pointer into the message when the whole block lies
+// inside one piece, otherwise assembled in buf
+const uint8_t* message_block(const Sha512::Message& m, uint64_t length, uint64_t b, uint8_t* buf) {
+	const uint64_t begin = b * Sha512::kBlockSize, end = begin + Sha512::kBlockSize;
+	uint64_t pos = 0;
+	for (const auto& part : m) {
+		const uint64_t part_end = pos + part.size();
+		if (pos <= begin && end <= part_end) {
+			return part.data() + (begin - pos);
+		}
+		pos = part_end;
+	}
+
+	std::memset(buf, 0, Sha512::kBlockSize);
+	pos = 0;
+	for (const auto& part : m) {
+		const uint64_t from = std::max(pos, begin), to = std::min(pos + part.size(), end);
+		if (from < to) {
+			std::memcpy(buf + (from - begin), part.data() + (from - pos), (size_t)(to - from));
+		}
+		pos += part.size();
+	}
+	if (begin <= length && length < end) {
+		buf[length - begin] = 0x80;
+	}
+	if (b + 1 == block_count(length)) {
+		store_be64(buf + Sha512::kBlockSize - 16, length >> 61);
+		store_be64(buf + Sha512::kBlockSize - 8, length << 3);
+	}
+	return buf;
+}
+
+// Multi-buffer scheduler: every lane hashes its own message, and a lane whose message is
+// done picks up the next one, so unequal lengths only idle lanes at the very end
+void hash_lanes(const Curve::FourQ::detail::Sha512LaneKernel& k, std::span<const Sha512::Message> msgs, std::span<Sha512::Digest> out) {
+	constexpr size_t kMaxLanes = 8;
+	const size_t L = k.lanes;
+	alignas(64) uint64_t state[8 * kMaxLanes];
+	alignas(64) uint8_t bufs[kMaxLanes][Sha512::kBlockSize] = {};
+	const uint8_t* blocks[kMaxLanes];
+	struct Lane {
+		size_t msg;
+		uint64_t length, block, blocks;
+	} lanes[kMaxLanes];
+
+	size_t next = 0, active = 0;
+	const auto start = [&](size_t l) {
+		if (next == msgs.size()) {
+			lanes[l].msg = SIZE_MAX;
+			return;
+		}
+		lanes[l] = {next, message_length(msgs[next]), 0, 0};
+		lanes[l].blocks = block_count(lanes[l].length);
+		for (size_t j = 0; j < 8; j++) {
+			state[j * L + l] = kInitialState[j];
+		}
+		next++;
+		active++;
+	};
+	for (size_t l = 0; l < L; l++) {
+		start(l);
+	}
+
+	while (active > 0) {
+		for (size_t l = 0; l < L; l++) {
+			const Lane& lane = lanes[l];
+			blocks[l] = lane.msg == SIZE_MAX ? bufs[l] : message_block(msgs[lane.msg], lane.length, lane.block, bufs[l]);
+		}
+		k.compress(state, blocks);
+		for (size_t l = 0; l < L; l++) {
+			Lane& lane = lanes[l];
+			if (lane.msg == SIZE_MAX || ++lane.block < lane.blocks) {
+				continue;
+			}
+			for (size_t j = 0; j < 8; j++) {
+				store_be64(out[lane.msg].data() + 8 * j, state[j * L + l]);
+			}
+			active--;
+			start(l);
+		}
+	}
+	// Don't leave message bytes or chaining values behind (the signing path hashes the
+	// nonce prefix); clear_words writes through volatile, so it is not dropped as dead stores
+	clear_words(bufs, (digit_t)(sizeof(bufs) / sizeof(unsigned int)));
+	clear_words(state, (digit_t)(sizeof(state) / (sizeof(unsigned int)))); // Bytes over word size (parenthesized for -Wsizeof-array-div)
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+bool sha512BackendSupported(Sha512Backend backend) {
+	switch (backend) {
+	case Sha512Backend::Portable:
+		return true;
+	case Sha512Backend::AVX2:
+#if defined(FASTECC_LANES_AVX2)
+		return cpuFeatures().avx2;
+#else
+		return false;
+#endif
+	case Sha512Backend::AVX512:
+#if defined(FASTECC_LANES_AVX512F)
+		return cpuFeatures().avx512f;
+#else
+		return false;
+#endif
+	}
+	return false;
+}
+
+Sha512Backend sha512Backend() {
+	return active_backend().load(std::memory_order_relaxed);
+}
+
+bool setSha512Backend(Sha512Backend backend) {
+	if (!sha512BackendSupported(backend)) {
+		return false;
+	}
+	active_backend().store(backend, std::memory_order_relaxed);
+	return true;
+}
+
+const char* sha512BackendName() {
+	switch (sha512Backend()) {
+	case Sha512Backend::AVX2:
+		return "avx2x4";
+	case Sha512Backend::AVX512:
+		return "avx512x8";
+	case Sha512Backend::Portable:
+	default:
+		return "portable";
+	}
+}
+
+void Sha512::reset() {
+	std::memcpy(_h.data(), kInitialState, sizeof(kInitialState));
+	_buffered = 0;
+	_length = 0;
+}
+
+void Sha512::compress(const uint8_t* block) {
+	uint64_t w[80];
+	for (int t = 0; t < 16; t++) {
+		w[t] = load_be64(block + 8 * t);
+	}
+	for (int t = 16; t < 80; t++) {
+		uint64_t s0 = rotr(w[t - 15], 1) ^ rotr(w[t - 15], 8) ^ (w[t - 15] >> 7);
+		uint64_t s1 = rotr(w[t - 2], 19) ^ rotr(w[t - 2], 61) ^ (w[t - 2] >> 6);
+		w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+	}
+
+	uint64_t a = _h[0], b = _h[1], c = _h[2], d = _h[3];
+	uint64_t e = _h[4], f = _h[5], g = _h[6], h = _h[7];
+	for (int t = 0; t < 80; t++) {
+		uint64_t S1 = rotr(e, 14) ^ rotr(e, 18) ^ rotr(e, 41);
+		uint64_t ch = (e & f) ^ (~e & g);
+		uint64_t t1 = h + S1 + ch + Curve::FourQ::detail::kSha512RoundConstants[t] + w[t];
+		uint64_t S0 = rotr(a, 28) ^ rotr(a, 34) ^ rotr(a, 39);
+		uint64_t maj = (a & b) ^ (a & c) ^ (b & c);
+		uint64_t t2 = S0 + maj;
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	_h[0] += a; _h[1] += b; _h[2] += c; _h[3] += d;
+	_h[4] += e; _h[5] += f; _h[6] += g; _h[7] += h;
+}
+
+Sha512& Sha512::update(std::span<const uint8_t> data) {
+	if (data.empty()) {
+		return *this; // data() may be null (e.g. an unused Message part); memcpy must not see it
+	}
+	const uint8_t* p = data.data();
+	size_t n = data.size();
+	_length += n;
+
+	if (_buffered > 0) {
+		size_t take = kBlockSize - _buffered;
+		if (take > n) {
+			take = n;
+		}
+		std::memcpy(_buf.data() + _buffered, p, take);
+		_buffered += take;
+		p += take;
+		n -= take;
+		if (_buffered < kBlockSize) {
+			return *this;
+		}
+		compress(_buf.data());
+		_buffered = 0;
+	}
+	for (; n >= kBlockSize; p += kBlockSize, n -= kBlockSize) {
+		compress(p); // Full blocks straight from the caller's buffer
+	}
+	if (n > 0) {
+		std::memcpy(_buf.data(), p, n);
+		_buffered = n;
+	}
+	return *this;
+}
+
+void Sha512::final(uint8_t* out) {
+	// Padding: 0x80, zeros, then the 128-bit big-endian bit length
+	const uint64_t bits_hi = _length >> 61;
+	const uint64_t bits_lo = _length << 3;
+	_buf[_buffered++] = 0x80;
+	if (_buffered > kBlockSize - 16) {
+		std::memset(_buf.data() + _buffered, 0, kBlockSize - _buffered);
+		compress(_buf.data());
+		_buffered = 0;
+	}
+	std::memset(_buf.data() + _buffered, 0, kBlockSize - 16 - _buffered);
+	store_be64(_buf.data() + kBlockSize - 16, bits_hi);
+	store_be64(_buf.data() + kBlockSize - 8, bits_lo);
+	compress(_buf.data());
+
+	for (int i = 0; i < 8; i++) {
+		store_be64(out + 8 * i, _h[(size_t)i]);
+	}
+	// As in hash_lanes: no message bytes or chaining values left behind
+	clear_words(_buf.data(), (digit_t)(_buf.size() / sizeof(unsigned int)));
+	clear_words(_h.data(), (digit_t)(sizeof(_h) / sizeof(unsigned int)));
+	_buffered = 0;
+}
+
+void Sha512::hash(std::span<const uint8_t> data, uint8_t* out) {
+	Sha512 ctx;
+	ctx.update(data);
+	ctx.final(out);
+}
+
+void Sha512::hashMany(std::span<const Message> msgs, std::span<Digest> out) {
+	if (msgs.size() != out.size()) {
+		throw std::invalid_argument("Sha512::hashMany: msgs and out must have the same length");
+	}
+	const detail::Sha512LaneKernel* k = active_kernel();
+	if (k != nullptr && msgs.size() > 1) {
+		hash_lanes(*k, msgs, out);
+		return;
+	}
+	Sha512 ctx;
+	for (size_t i = 0; i < msgs.size(); i++) {
+		ctx.reset();
+		for (const auto& part : msgs[i]) {
+			ctx.update(part);
+		}
+		ctx.final(out[i].data());
+	}
+}
+
+} // namespace FourQ
+} // namespace Curve
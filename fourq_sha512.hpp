@@ -0,0 +1,68 @@
+#pragma once // 头文件保护
+
+// Incremental SHA-512 (FIPS 180-4). FourQlib's crypto_sha512 only hashes one contiguous
+// buffer, which forces SchnorrQ to copy R || A || M into a scratch allocation; this context
+// lets the pieces be fed in place. Output is identical to crypto_sha512.
+//
+// hashMany() hashes many independent messages at once with a multi-buffer backend (4 or 8
+// messages per vector instruction), picked at run time like the lane kernels behind addAll.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Curve {
+namespace FourQ {
+
+// Multi-buffer backends for Sha512::hashMany
+enum class Sha512Backend {
+	Portable, // One message at a time through Sha512
+	AVX2,     // 4 messages per compression
+	AVX512,   // 8 messages per compression (AVX512F)
+};
+
+// Built in (CMake FASTECC_LANES) and runnable on this CPU
+bool sha512BackendSupported(Sha512Backend backend);
+// The fastest supported backend unless changed with setSha512Backend
+Sha512Backend sha512Backend();
+const char* sha512BackendName();
+// Process-wide; returns false and changes nothing if the backend is not supported. Meant
+// for tests and benchmarks, not to be called while other threads hash.
+bool setSha512Backend(Sha512Backend backend);
+
+class Sha512 {
+public:
+	static constexpr size_t kDigestSize = 64;
+	static constexpr size_t kBlockSize = 128;
+
+	using Digest = std::array<uint8_t, kDigestSize>;
+	// A message given as pieces hashed back to back, e.g. R || A || M; unused ones empty
+	using Message = std::array<std::span<const uint8_t>, 3>;
+
+	Sha512() { reset(); }
+
+	void reset();
+	Sha512& update(std::span<const uint8_t> data);
+	// Writes the 64-byte digest; the context must be reset() before it is reused
+	void final(uint8_t* out);
+
+	// One-shot convenience
+	static void hash(std::span<const uint8_t> data, uint8_t* out);
+
+	// out[i] = SHA-512 of msgs[i]. Messages of any mix of lengths share the vector lanes:
+	// a lane that finishes takes the next message, and a block lying inside one piece is
+	// read in place. Throws std::invalid_argument if the sizes differ.
+	static void hashMany(std::span<const Message> msgs, std::span<Digest> out);
+
+private:
+	void compress(const uint8_t* block);
+
+	std::array<uint64_t, 8> _h;
+	std::array<uint8_t, kBlockSize> _buf;
+	size_t _buffered;
+	uint64_t _length; // Total bytes hashed so far
+};
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,46 @@
+// 4-lane SHA-512 compression on AVX2, built with -mavx2 (CMake FASTECC_LANES). Only
+// reached through detail::kSha512Avx2 after cpuFeatures().avx2 has been checked.
+
+#include "fourq_sha512_mb.hpp"
+
+#include <immintrin.h>
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+struct Avx2Words {
+	static constexpr size_t kLanes = 4;
+	using T = __m256i;
+
+	static T load(const uint64_t* p) { return _mm256_load_si256(reinterpret_cast<const __m256i*>(p)); }
+	static void store(uint64_t* p, T a) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), a); }
+	static T set1(uint64_t v) { return _mm256_set1_epi64x((long long)v); }
+	static T add(T a, T b) { return _mm256_add_epi64(a, b); }
+	// No 64-bit rotate before AVX-512
+	template<int n>
+	static T rotr(T a) { return _mm256_or_si256(_mm256_srli_epi64(a, n), _mm256_slli_epi64(a, 64 - n)); }
+	template<int n>
+	static T shr(T a) { return _mm256_srli_epi64(a, n); }
+	static T xor3(T a, T b, T c) { return _mm256_xor_si256(_mm256_xor_si256(a, b), c); }
+	// (e & f) ^ (~e & g) as g ^ (e & (f ^ g))
+	static T ch(T e, T f, T g) { return _mm256_xor_si256(g, _mm256_and_si256(e, _mm256_xor_si256(f, g))); }
+	// (a & b) ^ (a & c) ^ (b & c) as (a & b) | (c & (a | b))
+	static T maj(T a, T b, T c) { return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_or_si256(a, b))); }
+};
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+const Sha512LaneKernel kSha512Avx2 = {
+	Avx2Words::kLanes,
+	&sha512_lanes::compress<Avx2Words>,
+};
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
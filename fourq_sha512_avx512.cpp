@@ -0,0 +1,44 @@
+// 8-lane SHA-512 compression on AVX-512F, built with -mavx512f (CMake FASTECC_LANES). Only
+// reached through detail::kSha512Avx512 after cpuFeatures().avx512f has been checked.
+
+#include "fourq_sha512_mb.hpp"
+
+#include <immintrin.h>
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+struct Avx512Words {
+	static constexpr size_t kLanes = 8;
+	using T = __m512i;
+
+	static T load(const uint64_t* p) { return _mm512_load_si512(p); }
+	static void store(uint64_t* p, T a) { _mm512_store_si512(p, a); }
+	static T set1(uint64_t v) { return _mm512_set1_epi64((long long)v); }
+	static T add(T a, T b) { return _mm512_add_epi64(a, b); }
+	template<int n>
+	static T rotr(T a) { return _mm512_ror_epi64(a, n); }
+	template<int n>
+	static T shr(T a) { return _mm512_srli_epi64(a, n); }
+	// VPTERNLOGQ truth tables over (a, b, c) = (0xF0, 0xCC, 0xAA)
+	static T xor3(T a, T b, T c) { return _mm512_ternarylogic_epi64(a, b, c, 0x96); }
+	static T ch(T e, T f, T g) { return _mm512_ternarylogic_epi64(e, f, g, 0xCA); }
+	static T maj(T a, T b, T c) { return _mm512_ternarylogic_epi64(a, b, c, 0xE8); }
+};
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+const Sha512LaneKernel kSha512Avx512 = {
+	Avx512Words::kLanes,
+	&sha512_lanes::compress<Avx512Words>,
+};
+
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,112 @@
+#pragma once // 头文件保护
+
+// Internal multi-buffer SHA-512 behind Sha512::hashMany (fourq_sha512.hpp). Not part of
+// the public wrapper API.
+//
+// A kernel runs the SHA-512 compression function on kLanes independent states at once,
+// one 64-bit word per vector lane: 4 lanes with AVX2, 8 with AVX-512F (VPRORQ and
+// VPTERNLOGQ for the rotations and the Ch/Maj/Sigma combinations).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Curve {
+namespace FourQ {
+namespace detail {
+
+inline constexpr uint64_t kSha512RoundConstants[80] = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+	0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+	0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+	0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+	0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+	0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+	0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+	0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+	0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+	0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+	0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+	0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+	0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+	0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+// Compresses one 128-byte block into each of the kLanes states. state is word-major
+// (word j of lane l at state[j * lanes + l]) and 64-byte aligned; blocks[l] is lane l's
+// block, any alignment.
+using Sha512LaneFn = void (*)(uint64_t* state, const uint8_t* const* blocks);
+
+struct Sha512LaneKernel {
+	size_t lanes;
+	Sha512LaneFn compress;
+};
+
+// Compiled only when the build has the corresponding kernels (FASTECC_LANES_AVX2 /
+// FASTECC_LANES_AVX512F); the caller checks the CPU before using them.
+extern const Sha512LaneKernel kSha512Avx2;   // fourq_sha512_avx2.cpp
+extern const Sha512LaneKernel kSha512Avx512; // fourq_sha512_avx512.cpp
+
+namespace sha512_lanes {
+
+// The compression function over a vector policy V: kLanes, T, load/store (aligned, kLanes
+// words), set1, add, rotr<n>, shr<n>, xor3, ch, maj
+template<typename V>
+inline void compress(uint64_t* state, const uint8_t* const* blocks) {
+	using T = typename V::T;
+	constexpr size_t L = V::kLanes;
+
+	T w[16];
+	for (size_t t = 0; t < 16; t++) {
+		alignas(64) uint64_t words[L];
+		for (size_t l = 0; l < L; l++) {
+			const uint8_t* p = blocks[l] + 8 * t;
+			uint64_t v = 0;
+			for (int i = 0; i < 8; i++) {
+				v = (v << 8) | p[i]; // Big-endian message words
+			}
+			words[l] = v;
+		}
+		w[t] = V::load(words);
+	}
+
+	T s[8];
+	for (size_t j = 0; j < 8; j++) {
+		s[j] = V::load(state + j * L);
+	}
+	T a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+	for (size_t t = 0; t < 80; t++) {
+		if (t >= 16) {
+			const T w15 = w[(t - 15) & 15], w2 = w[(t - 2) & 15];
+			const T s0 = V::xor3(V::template rotr<1>(w15), V::template rotr<8>(w15), V::template shr<7>(w15));
+			const T s1 = V::xor3(V::template rotr<19>(w2), V::template rotr<61>(w2), V::template shr<6>(w2));
+			w[t & 15] = V::add(V::add(w[t & 15], s0), V::add(w[(t - 7) & 15], s1));
+		}
+		const T S1 = V::xor3(V::template rotr<14>(e), V::template rotr<18>(e), V::template rotr<41>(e));
+		const T t1 = V::add(V::add(h, S1), V::add(V::ch(e, f, g), V::add(V::set1(kSha512RoundConstants[t]), w[t & 15])));
+		const T S0 = V::xor3(V::template rotr<28>(a), V::template rotr<34>(a), V::template rotr<39>(a));
+		const T t2 = V::add(S0, V::maj(a, b, c));
+		h = g;
+		g = f;
+		f = e;
+		e = V::add(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = V::add(t1, t2);
+	}
+	const T out[8] = {a, b, c, d, e, f, g, h};
+	for (size_t j = 0; j < 8; j++) {
+		V::store(state + j * L, V::add(s[j], out[j]));
+	}
+}
+
+} // namespace sha512_lanes
+} // namespace detail
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,168 @@
+#include "fourq_soa.hpp"
+#include "fourq_internal.hpp"
+
+#include <stdexcept> // For std::invalid_argument, std::runtime_error
+#include <vector>
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+// point_affine and fourq_scalar_t are read and written as plain word arrays
+static_assert(sizeof(point_affine) == Curve::FourQ::PointBatch::kLimbs * sizeof(digit_t), "point_affine layout");
+static_assert(sizeof(Curve::FourQ::fourq_scalar_t) == Curve::FourQ::ScalarBatch::kLimbs * sizeof(digit_t), "scalar layout");
+
+constexpr std::array<digit_t, 4 * NWORDS_FIELD> kIdentityLimbs = [] {
+	std::array<digit_t, 4 * NWORDS_FIELD> w{};
+	w[2 * NWORDS_FIELD] = 1; // y = 1
+	return w;
+}();
+
+// Like Point's cast of spans, see the layout static_asserts in fourq.hpp
+point_extproj* extproj(Curve::FourQ::Point& p) {
+	return reinterpret_cast<point_extproj*>(&p);
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+// --- PointBatch ---
+
+PointBatch::PointBatch() : LimbArrays(kIdentityLimbs) {}
+
+PointBatch::PointBatch(std::span<const Point> points) : PointBatch() {
+	assign(points);
+}
+
+void PointBatch::assign(std::span<const Point> points) {
+	clear();
+	append(points);
+}
+
+void PointBatch::append(std::span<const Point> points) {
+	detail::Scratch scratch;
+	auto affine = scratch.vector<point_affine>(points.size());
+	detail::batch_to_affine({reinterpret_cast<const point_extproj*>(points.data()), points.size()}, affine.data());
+	const size_t base = size();
+	grow_to(base + points.size());
+	for (size_t i = 0; i < points.size(); i++) {
+		scatter(base + i, reinterpret_cast<const digit_t*>(&affine[i]));
+	}
+}
+
+void PointBatch::assignEncoded(std::span<const EccDataType> raw) {
+	detail::Scratch scratch;
+	auto affine = scratch.vector<point_affine>(raw.size());
+	for (size_t i = 0; i < raw.size(); i++) {
+		FASTECC_STAT_SCOPE(Decode);
+		point_extproj_t P;
+		if (::decode(raw[i].data(), &affine[i]) != ECCRYPTO_SUCCESS) {
+			throw std::runtime_error("PointBatch::assignEncoded: point decoding failed");
+		}
+		point_setup(&affine[i], P);
+		if (!ecc_point_validate(P)) {
+			throw std::runtime_error("PointBatch::assignEncoded: point not on curve or invalid");
+		}
+	}
+	clear();
+	grow_to(raw.size());
+	for (size_t i = 0; i < raw.size(); i++) {
+		scatter(i, reinterpret_cast<const digit_t*>(&affine[i]));
+	}
+}
+
+Point PointBatch::get(size_t i) const {
+	point_affine P;
+	gather(i, reinterpret_cast<digit_t*>(&P));
+	Point ret;
+	point_setup(&P, extproj(ret));
+	return ret;
+}
+
+void PointBatch::set(size_t i, const Point& p) {
+	point_affine P;
+	detail::to_affine(reinterpret_cast<const point_extproj*>(&p), &P);
+	scatter(i, reinterpret_cast<const digit_t*>(&P));
+}
+
+EccDataType PointBatch::getRaw(size_t i) const {
+	point_affine P;
+	gather(i, reinterpret_cast<digit_t*>(&P));
+	FASTECC_STAT_SCOPE(Encode);
+	digit_t encoded[NWORDS_ORDER]; // encode() writes through digit_t*
+	encode(&P, reinterpret_cast<unsigned char*>(encoded));
+	EccDataType raw;
+	std::memcpy(raw.data(), encoded, ECC_KEY_LENGTH);
+	return raw;
+}
+
+void PointBatch::encodeAll(std::span<EccDataType> out) const {
+	if (out.size() != size()) {
+		throw std::invalid_argument("PointBatch::encodeAll: out must have size() entries");
+	}
+	for (size_t i = 0; i < out.size(); i++) {
+		out[i] = getRaw(i);
+	}
+}
+
+void PointBatch::toPoints(std::span<Point> out) const {
+	if (out.size() != size()) {
+		throw std::invalid_argument("PointBatch::toPoints: out must have size() entries");
+	}
+	for (size_t i = 0; i < out.size(); i++) {
+		out[i] = get(i);
+	}
+}
+
+
+// --- ScalarBatch ---
+
+ScalarBatch::ScalarBatch() : LimbArrays({}) {}
+
+ScalarBatch::ScalarBatch(std::span<const Scalar> scalars) : ScalarBatch() {
+	assign(scalars);
+}
+
+void ScalarBatch::assign(std::span<const Scalar> scalars) {
+	clear();
+	append(scalars);
+}
+
+void ScalarBatch::append(std::span<const Scalar> scalars) {
+	const size_t base = size();
+	grow_to(base + scalars.size());
+	for (size_t i = 0; i < scalars.size(); i++) {
+		set(base + i, scalars[i]);
+	}
+}
+
+Scalar ScalarBatch::get(size_t i) const {
+	Scalar k;
+	gather(i, reinterpret_cast<digit_t*>(&k));
+	return k;
+}
+
+void ScalarBatch::set(size_t i, const Scalar& k) {
+	scatter(i, reinterpret_cast<const digit_t*>(&k));
+}
+
+void ScalarBatch::toScalars(std::span<Scalar> out) const {
+	if (out.size() != size()) {
+		throw std::invalid_argument("ScalarBatch::toScalars: out must have size() entries");
+	}
+	for (size_t i = 0; i < out.size(); i++) {
+		out[i] = get(i);
+	}
+}
+
+} // namespace FourQ
+} // namespace Curve
@@ -0,0 +1,231 @@
+#pragma once // 头文件保护
+
+// Structure-of-arrays containers for large point and scalar sets.
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <vector>
+
+#include "fourq.hpp"
+
+namespace Curve {
+namespace FourQ {
+
+namespace detail {
+
+// Allocator returning storage aligned to Align bytes
+template<typename T, size_t Align>
+struct AlignedAllocator {
+	using value_type = T;
+	template<typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Align>;
+	};
+
+	AlignedAllocator() = default;
+	template<typename U>
+	AlignedAllocator(const AlignedAllocator<U, Align>&) {}
+
+	T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align))); }
+	void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Align)); }
+
+	friend bool operator==(const AlignedAllocator&, const AlignedAllocator&) { return true; }
+};
+
+// Limbs words per element, stored limb-major: word j of element i is limb(j)[i]. Every limb
+// array is padded to a multiple of kLanes elements and starts on a kAlignment boundary, so
+// lane-parallel code can load any group of kLanes elements with aligned vector loads.
+// Padding lanes always hold the `pad` element. Shared by PointBatch and ScalarBatch.
+template<unsigned Limbs>
+class LimbArrays {
+public:
+	static constexpr size_t kLanes = 8;
+	static constexpr size_t kAlignment = 64;
+	static constexpr unsigned kLimbs = Limbs;
+	static_assert(kLanes * sizeof(digit_t) % kAlignment == 0, "limb arrays must stay aligned");
+
+	size_t size() const { return _n; }
+	bool empty() const { return _n == 0; }
+	// Length of each limb array: size() rounded up to a multiple of kLanes, or more after reserve()
+	size_t stride() const { return _stride; }
+
+	const digit_t* limb(unsigned j) const { return _limbs.data() + (size_t)j * _stride; }
+	digit_t* limb(unsigned j) { return _limbs.data() + (size_t)j * _stride; }
+
+	void reserve(size_t n) {
+		if (n > _stride) {
+			relayout(round_up(n));
+		}
+	}
+
+	void clear() {
+		for (size_t i = 0; i < _n; i++) {
+			scatter(i, _pad.data());
+		}
+		_n = 0;
+	}
+
+protected:
+	explicit LimbArrays(const std::array<digit_t, Limbs>& pad) : _pad(pad) {}
+
+	// Grows to n elements; new elements hold the pad value
+	void grow_to(size_t n) {
+		if (n > _stride) {
+			relayout(round_up(n > 2 * _stride ? n : 2 * _stride));
+		}
+		_n = n;
+	}
+
+	void gather(size_t i, digit_t* words) const {
+		for (unsigned j = 0; j < Limbs; j++) {
+			words[j] = limb(j)[i];
+		}
+	}
+
+	void scatter(size_t i, const digit_t* words) {
+		for (unsigned j = 0; j < Limbs; j++) {
+			limb(j)[i] = words[j];
+		}
+	}
+
+private:
+	static size_t round_up(size_t n) { return (n + kLanes - 1) / kLanes * kLanes; }
+
+	void relayout(size_t stride) {
+		std::vector<digit_t, AlignedAllocator<digit_t, kAlignment>> limbs((size_t)Limbs * stride);
+		for (unsigned j = 0; j < Limbs; j++) {
+			digit_t* dst = limbs.data() + (size_t)j * stride;
+			if (_stride != 0) {
+				std::memcpy(dst, limb(j), _stride * sizeof(digit_t));
+			}
+			for (size_t i = _stride; i < stride; i++) {
+				dst[i] = _pad[j];
+			}
+		}
+		_limbs.swap(limbs);
+		_stride = stride;
+	}
+
+	std::array<digit_t, Limbs> _pad;
+	size_t _n = 0, _stride = 0;
+	std::vector<digit_t, AlignedAllocator<digit_t, kAlignment>> _limbs;
+};
+
+} // namespace detail
+
+// --- PointBatch Class Declaration ---
+// Points kept normalized, as affine (x, y) in structure-of-arrays form (implementation in
+// fourq_soa.cpp). Limbs 0-3 are the four 64-bit words of x (real part low/high, then
+// imaginary part), limbs 4-7 those of y. At 64 bytes per point this is 2.5 times smaller
+// than a Point (five extended coordinates), and encoding needs no inversion. Padding
+// lanes hold the identity (0, 1).
+class PointBatch : public detail::LimbArrays<4 * NWORDS_FIELD> {
+public:
+	PointBatch();
+	// Normalizes all points with one shared field inversion (see normalizeAll)
+	explicit PointBatch(std::span<const Point> points);
+
+	void assign(std::span<const Point> points);
+	void append(std::span<const Point> points);
+	// Decodes and validates 32-byte encodings. Throws std::runtime_error on the first
+	// invalid one, leaving the batch unchanged.
+	void assignEncoded(std::span<const EccDataType> raw);
+
+	Point get(size_t i) const;
+	void set(size_t i, const Point& p); // One inversion unless p is normalized
+	EccDataType getRaw(size_t i) const;
+
+	// The spans must have size() entries, otherwise std::invalid_argument
+	void encodeAll(std::span<EccDataType> out) const;
+	void toPoints(std::span<Point> out) const;
+};
+
+// --- ScalarBatch Class Declaration ---
+// Scalars in structure-of-arrays form: limb j holds word j (little-endian) of every
+// scalar (implementation in fourq_soa.cpp). Padding lanes hold zero.
+class ScalarBatch : public detail::LimbArrays<NWORDS_ORDER> {
+public:
+	ScalarBatch();
+	explicit ScalarBatch(std::span<const Scalar> scalars);
+
+	void assign(std::span<const Scalar> scalars);
+	void append(std::span<const Scalar> scalars);
+
+	Scalar get(size_t i) const;
+	void set(size_t i, const Scalar& k);
+
+	// out must have size() entries, otherwise std::invalid_argument
+	void toScalars(std::span<Scalar> out) const;
+};
+
+// sum(scalars[i] * points[i]) over the batches, same result as Point::MultiMul
+// (implementation in fourq_msm.cpp). Throws std::invalid_argument if the sizes differ.
+Point MultiMul(const ScalarBatch& scalars, const PointBatch& points);
+
+// --- Lane-parallel point arithmetic ---
+// Element-wise addition and doubling over whole sets of independent points (implementation
+// in fourq_lanes.cpp). With a SIMD backend, groups of 4 (AVX2) or 8 (AVX-512 IFMA) points
+// go through the same formulas as eccmadd/eccdouble with one field element per vector lane;
+// a remainder shorter than a group, and the Scalar backend, use FourQlib itself. Results
+// equal the Point operators', only the representation of the projective coordinates may
+// differ.
+enum class LaneBackend {
+	Scalar,     // FourQlib, one point at a time
+	AVX2,       // 4 lanes, radix 2^26
+	AVX512IFMA, // 8 lanes, radix 2^52 (AVX512F + AVX512IFMA)
+};
+
+// Built in (CMake FASTECC_LANES) and runnable on this CPU
+bool laneBackendSupported(LaneBackend backend);
+// The fastest supported backend unless changed with setLaneBackend
+LaneBackend laneBackend();
+const char* laneBackendName();
+// Process-wide; returns false and changes nothing if the backend is not supported. Meant
+// for tests and benchmarks, not to be called while other threads use addAll/doubleAll.
+bool setLaneBackend(LaneBackend backend);
+
+// acc[i] += addends.get(i) as a mixed addition (the batch is affine). Throws
+// std::invalid_argument if the sizes differ.
+void addAll(std::span<Point> acc, const PointBatch& addends);
+// points[i] = 2^times * points[i]
+void doubleAll(std::span<Point> points, unsigned times = 1);
+
+namespace detail {
+// Implementation in schnorrq_batch.cpp
+bool schnorrq_verify_batch(const PointBatch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results);
+bool schnorrq_verify_batch(const PointBatch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs);
+} // namespace detail
+
+// SchnorrQVerifyBatch against a PointBatch of public keys, same contract as the
+// std::span<const Point> overloads. The keys are already affine, so their encodings cost
+// no inversion. Templates only so that SchnorrQVerifyBatch({}, {}, {}) keeps resolving to
+// the span overload.
+template<std::same_as<PointBatch> Batch>
+bool SchnorrQVerifyBatch(const Batch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results)
+{
+	return detail::schnorrq_verify_batch(pubkeys, msgs, sigs, results);
+}
+
+template<std::same_as<PointBatch> Batch>
+bool SchnorrQVerifyBatch(const Batch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs)
+{
+	return detail::schnorrq_verify_batch(pubkeys, msgs, sigs);
+}
+
+} // namespace FourQ
+} // namespace Curve
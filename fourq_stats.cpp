@@ -0,0 +1,262 @@
+#include "fourq_stats.hpp"
+
+#include <bit>     // For std::bit_width
+#include <cmath>   // For std::ceil
+#include <cstdio>  // For snprintf
+
+#if defined(FASTECC_STATS)
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#endif
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::LatencyHistogram;
+using Curve::FourQ::StatsSnapshot;
+using Curve::FourQ::kStatOpCount;
+
+constexpr const char* kOpNames[kStatOpCount] = {
+	"normalize", "batch_normalize", "decode", "encode", "mul", "mul_base", "mul_double",
+	"multi_mul", "schnorrq_sign", "schnorrq_verify", "schnorrq_verify_batch",
+};
+
+#if defined(FASTECC_STATS)
+
+// One thread's counters. Only the owning thread writes them, so an increment is a relaxed
+// load and store rather than a locked read-modify-write; snapshots read them concurrently.
+struct OpCells {
+	std::atomic<uint64_t> calls{0}, items{0}, sumNs{0};
+	std::array<std::atomic<uint64_t>, LatencyHistogram::kBuckets> buckets{};
+};
+
+struct ThreadBlock {
+	std::array<OpCells, kStatOpCount> ops;
+};
+
+inline void bump(std::atomic<uint64_t>& cell, uint64_t v) {
+	cell.store(cell.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+}
+
+void accumulate(StatsSnapshot& s, const ThreadBlock& b) {
+	for (size_t op = 0; op < kStatOpCount; op++) {
+		const OpCells& c = b.ops[op];
+		Curve::FourQ::OpStats& o = s.ops[op];
+		o.calls += c.calls.load(std::memory_order_relaxed);
+		o.items += c.items.load(std::memory_order_relaxed);
+		o.latency.sumNs += c.sumNs.load(std::memory_order_relaxed);
+		for (size_t i = 0; i < LatencyHistogram::kBuckets; i++) {
+			const uint64_t n = c.buckets[i].load(std::memory_order_relaxed);
+			o.latency.buckets[i] += n;
+			o.latency.count += n;
+		}
+	}
+}
+
+// Every counter only grows, so subtracting an earlier total cannot underflow
+void subtract(StatsSnapshot& s, const StatsSnapshot& base) {
+	for (size_t op = 0; op < kStatOpCount; op++) {
+		Curve::FourQ::OpStats& o = s.ops[op];
+		const Curve::FourQ::OpStats& b = base.ops[op];
+		o.calls -= b.calls;
+		o.items -= b.items;
+		o.latency.count -= b.latency.count;
+		o.latency.sumNs -= b.latency.sumNs;
+		for (size_t i = 0; i < LatencyHistogram::kBuckets; i++) {
+			o.latency.buckets[i] -= b.latency.buckets[i];
+		}
+	}
+}
+
+struct Registry {
+	std::mutex mutex;
+	std::vector<const ThreadBlock*> live;
+	StatsSnapshot retired;  // Totals of threads that have exited
+	StatsSnapshot baseline; // Totals at the last resetStats()
+
+	StatsSnapshot total() {
+		StatsSnapshot s = retired;
+		for (const ThreadBlock* b : live) {
+			accumulate(s, *b);
+		}
+		return s;
+	}
+};
+
+// Never destroyed: threads may still exit (and retire their block) during static destruction
+Registry& registry() {
+	static Registry* r = new Registry;
+	return *r;
+}
+
+// Registers the thread's block on first use and folds it into the retired totals on exit
+struct ThreadHandle {
+	std::unique_ptr<ThreadBlock> block = std::make_unique<ThreadBlock>();
+
+	ThreadHandle() {
+		Registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		r.live.push_back(block.get());
+	}
+	~ThreadHandle() {
+		Registry& r = registry();
+		std::lock_guard<std::mutex> lock(r.mutex);
+		accumulate(r.retired, *block);
+		std::erase(r.live, block.get());
+	}
+};
+
+ThreadBlock& thread_block() {
+	thread_local ThreadHandle handle;
+	return *handle.block;
+}
+
+#endif // FASTECC_STATS
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+const char* statOpName(StatOp op) {
+	return (size_t)op < kStatOpCount ? kOpNames[(size_t)op] : "unknown";
+}
+
+// --- LatencyHistogram Implementations ---
+
+size_t LatencyHistogram::bucketFor(uint64_t ns) {
+	constexpr uint64_t kSub = (uint64_t)1 << kSubBucketBits;
+	if (ns < 2 * kSub) {
+		return (size_t)ns;
+	}
+	const unsigned e = (unsigned)std::bit_width(ns) - 1; // ns in [2^e, 2^(e+1))
+	if (e >= kMaxBits) {
+		return kBuckets - 1;
+	}
+	const unsigned shift = e - kSubBucketBits;
+	return (size_t)(((uint64_t)shift << kSubBucketBits) + (ns >> shift));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t i) {
+	constexpr size_t kSub = (size_t)1 << kSubBucketBits;
+	if (i < 2 * kSub) {
+		return i;
+	}
+	const unsigned shift = (unsigned)(i >> kSubBucketBits) - 1;
+	return (uint64_t)(kSub + (i & (kSub - 1))) << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t i) {
+	return i + 1 < kBuckets ? bucketLowerBound(i + 1) : (uint64_t)1 << kMaxBits;
+}
+
+double LatencyHistogram::meanNs() const {
+	return count == 0 ? 0.0 : (double)sumNs / (double)count;
+}
+
+uint64_t LatencyHistogram::percentile(double q) const {
+	if (count == 0) {
+		return 0;
+	}
+	q = q < 0 ? 0 : (q > 1 ? 1 : q);
+	uint64_t rank = (uint64_t)std::ceil(q * (double)count);
+	rank = rank == 0 ? 1 : (rank > count ? count : rank);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < kBuckets; i++) {
+		seen += buckets[i];
+		if (seen >= rank) {
+			return bucketUpperBound(i);
+		}
+	}
+	return bucketUpperBound(kBuckets - 1);
+}
+
+// --- Collection and export ---
+
+void detail::stats_record(StatOp op, uint64_t items, uint64_t ns) {
+#if defined(FASTECC_STATS)
+	OpCells& c = thread_block().ops[(size_t)op];
+	bump(c.calls, 1);
+	bump(c.items, items);
+	bump(c.sumNs, ns);
+	bump(c.buckets[LatencyHistogram::bucketFor(ns)], 1);
+#else
+	(void)op;
+	(void)items;
+	(void)ns;
+#endif
+}
+
+StatsSnapshot statsSnapshot() {
+#if defined(FASTECC_STATS)
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	StatsSnapshot s = r.total();
+	subtract(s, r.baseline);
+	return s;
+#else
+	return StatsSnapshot{};
+#endif
+}
+
+void resetStats() {
+#if defined(FASTECC_STATS)
+	Registry& r = registry();
+	std::lock_guard<std::mutex> lock(r.mutex);
+	r.baseline = r.total();
+#endif
+}
+
+std::string statsPrometheus(const StatsSnapshot& snapshot) {
+	std::string out;
+	char line[160];
+	auto each_op = [&](const char* metric, auto value) {
+		for (size_t op = 0; op < kStatOpCount; op++) {
+			snprintf(line, sizeof(line), "%s{op=\"%s\"} %llu\n", metric, kOpNames[op],
+				(unsigned long long)value(snapshot.ops[op]));
+			out += line;
+		}
+	};
+
+	out += "# HELP fastecc_calls_total Calls of each instrumented FourQ operation.\n";
+	out += "# TYPE fastecc_calls_total counter\n";
+	each_op("fastecc_calls_total", [](const OpStats& o) { return o.calls; });
+	out += "# HELP fastecc_items_total Points, terms or signatures handled by each operation.\n";
+	out += "# TYPE fastecc_items_total counter\n";
+	each_op("fastecc_items_total", [](const OpStats& o) { return o.items; });
+
+	out += "# HELP fastecc_latency_seconds Latency of each instrumented FourQ operation.\n";
+	out += "# TYPE fastecc_latency_seconds histogram\n";
+	for (size_t op = 0; op < kStatOpCount; op++) {
+		const LatencyHistogram& h = snapshot.ops[op].latency;
+		uint64_t cumulative = 0;
+		size_t i = 0;
+		// Power-of-two bounds from 32 ns fall on bucket edges; each counts the samples below it
+		for (unsigned e = LatencyHistogram::kSubBucketBits + 1; e <= LatencyHistogram::kMaxBits; e++) {
+			const size_t end = LatencyHistogram::bucketFor((uint64_t)1 << e);
+			for (; i < end; i++) {
+				cumulative += h.buckets[i];
+			}
+			snprintf(line, sizeof(line), "fastecc_latency_seconds_bucket{op=\"%s\",le=\"%.9g\"} %llu\n",
+				kOpNames[op], (double)((uint64_t)1 << e) * 1e-9, (unsigned long long)cumulative);
+			out += line;
+		}
+		snprintf(line, sizeof(line), "fastecc_latency_seconds_bucket{op=\"%s\",le=\"+Inf\"} %llu\n",
+			kOpNames[op], (unsigned long long)h.count);
+		out += line;
+		snprintf(line, sizeof(line), "fastecc_latency_seconds_sum{op=\"%s\"} %.9g\n",
+			kOpNames[op], (double)h.sumNs * 1e-9);
+		out += line;
+		snprintf(line, sizeof(line), "fastecc_latency_seconds_count{op=\"%s\"} %llu\n",
+			kOpNames[op], (unsigned long long)h.count);
+		out += line;
+	}
+	return out;
+}
+
+} // namespace FourQ
+} // namespace Curve
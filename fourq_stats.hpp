@@ -0,0 +1,90 @@
+#pragma once // 头文件保护
+
+// Optional call counters and latency histograms for the wrapper's hot paths.
+//
+// Built only with the CMake option FASTECC_STATS (defines FASTECC_STATS=1); otherwise the
+// instrumentation compiles to nothing and statsSnapshot() returns zeros. When on, every
+// thread records into its own block with relaxed single-writer atomics (no locks, no
+// shared cache lines on the hot path); a snapshot sums the live threads and those that
+// have exited.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Curve {
+namespace FourQ {
+
+#if defined(FASTECC_STATS)
+constexpr bool kStatsEnabled = true;
+#else
+constexpr bool kStatsEnabled = false;
+#endif
+
+// Instrumented operations; each maps to one FourQlib entry point or one SchnorrQ call
+enum class StatOp : uint8_t {
+	Normalize,          // eccnorm: one inversion taking a point to affine (Z == 1 skips it)
+	BatchNormalize,     // One shared inversion for items points (encodeAll, normalizeAll, ...)
+	Decode,             // decode + validation of a 32-byte encoding
+	Encode,             // encode of an affine point
+	Mul,                // ecc_mul: variable-base k*P (operator*=, KeyExchange)
+	MulBase,            // Fixed-base k*G (mulBase, comb or ecc_mul_fixed)
+	MulDouble,          // ecc_mul_double: a*G + b*P (MulAdd, SchnorrQVerify)
+	MultiMul,           // Point::MultiMul over items terms
+	SchnorrQSign,       // Signing of items messages (single or batched)
+	SchnorrQVerify,     // One signature against a decoded key
+	SchnorrQVerifyBatch // Combined check over items signatures
+};
+inline constexpr size_t kStatOpCount = 11;
+
+const char* statOpName(StatOp op); // Snake case, e.g. "mul_double"
+
+// --- LatencyHistogram ---
+// Log-linear (HDR style) buckets in nanoseconds: exact below 32 ns, then 16 buckets per
+// power of two (at most 1/16 relative error) up to 2^40 ns; longer samples land in the
+// last bucket.
+struct LatencyHistogram {
+	static constexpr unsigned kSubBucketBits = 4;
+	static constexpr unsigned kMaxBits = 40;
+	static constexpr size_t kBuckets = (size_t)(kMaxBits - kSubBucketBits + 1) << kSubBucketBits;
+
+	static size_t bucketFor(uint64_t ns);
+	static uint64_t bucketLowerBound(size_t i); // Smallest value in bucket i
+	static uint64_t bucketUpperBound(size_t i); // One past the largest value in bucket i
+
+	uint64_t count = 0;
+	uint64_t sumNs = 0;
+	std::array<uint64_t, kBuckets> buckets{};
+
+	double meanNs() const;
+	// Upper bound of the bucket holding the q-quantile (0 <= q <= 1), 0 when empty
+	uint64_t percentile(double q) const;
+};
+
+struct OpStats {
+	uint64_t calls = 0;
+	uint64_t items = 0; // Points, terms or signatures handled; calls for single operations
+	LatencyHistogram latency;
+};
+
+struct StatsSnapshot {
+	std::array<OpStats, kStatOpCount> ops;
+
+	const OpStats& operator[](StatOp op) const { return ops[(size_t)op]; }
+};
+
+// Totals since start (or the last resetStats) over all threads, exited ones included
+StatsSnapshot statsSnapshot();
+// Restarts the totals; threads keep recording without synchronizing with the reset
+void resetStats();
+// The snapshot in the Prometheus text format: fastecc_calls_total, fastecc_items_total and
+// the fastecc_latency_seconds histogram (buckets at powers of two), labelled op="<name>"
+std::string statsPrometheus(const StatsSnapshot& snapshot);
+
+namespace detail {
+void stats_record(StatOp op, uint64_t items, uint64_t ns);
+} // namespace detail
+
+} // namespace FourQ
+} // namespace Curve
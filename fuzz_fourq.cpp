@@ -0,0 +1,47 @@
+// 模糊测试目标：首字节选择 fourq_differential.hpp 中的 Check，其余字节作为该 Check 的输入；
+// 任一优化路径与参考实现不一致即 abort，由 libFuzzer 保存触发输入。
+//
+// 构建 FASTECC_FUZZ_REPLAY 时不依赖 libFuzzer，提供一个 main 逐个回放命令行给出的输入文件
+// （fastecc_diff_*.bin、模糊测试器的 crash-* 或语料库文件），任何编译器都可用。
+#include "fourq_differential.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+#include <string>
+
+#if defined(FASTECC_FUZZ_REPLAY)
+#include <fstream>
+#include <iterator>
+#include <vector>
+#endif
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const std::string error = Curve::FourQ::differential::run(std::span<const uint8_t>(data, size));
+    if (!error.empty()) {
+        std::fprintf(stderr, "fastecc differential mismatch: %s\n", error.c_str());
+        std::abort();
+    }
+    return 0;
+}
+
+#if defined(FASTECC_FUZZ_REPLAY)
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s input...\n", argv[0]);
+        return 2;
+    }
+    for (int i = 1; i < argc; i++) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::fprintf(stderr, "%s: cannot open\n", argv[i]);
+            return 2;
+        }
+        const std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+        std::printf("%s: ok\n", argv[i]);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,274 @@
+#include "fourq.hpp"
+#include "fourq_comb.hpp"
+#include "fourq_internal.hpp"
+#include "fourq_msm.hpp"
+#include "fourq_random.hpp"
+#include "fourq_sha512.hpp"
+#include "fourq_soa.hpp"
+
+#include <algorithm> // For std::fill
+#include <cstring>   // For memcpy, memcmp
+#include <stdexcept> // For std::invalid_argument
+#include <vector>
+#include <array>
+
+extern "C" {
+#include "FourQlib/FourQ_64bit_and_portable/FourQ.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_api.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_internal.h"
+#include "FourQlib/FourQ_64bit_and_portable/FourQ_params.h" // For curve_order
+}
+
+
+// --- Internal Helper Implementation ---
+namespace {
+
+using Curve::FourQ::EccDataType;
+using Curve::FourQ::fourq_scalar_t;
+
+fourq_scalar_t load_words(const uint8_t* in) {
+	fourq_scalar_t w;
+	std::memcpy(w.data(), in, sizeof(fourq_scalar_t));
+	return w;
+}
+
+// Same range checks SchnorrQ_Verify performs on the signature bytes
+bool signature_well_formed(const std::array<uint8_t, 64>& sig) {
+	return (sig[15] & 0x80) == 0 && sig[63] == 0 && (sig[62] & 0xC0) == 0;
+}
+
+} // anonymous namespace
+
+
+namespace Curve {
+namespace FourQ {
+
+namespace {
+
+// Batch verification core over the keys in R1 form and their encodings. pubraw is only
+// read when n > 1 (a lone signature is verified directly). results gets n flags (0 or 1);
+// the temporaries come from the thread's scratch arena.
+bool verify_batch(std::span<const point_extproj> pubkeys,
+	std::span<const EccDataType> pubraw,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	uint8_t* results)
+{
+	const size_t n = pubkeys.size();
+	FASTECC_STAT_SCOPE_N(SchnorrQVerifyBatch, n);
+	std::fill(results, results + n, 0);
+	detail::Scratch scratch;
+
+	// Random 128-bit coefficients, fetched with a single call. A lone signature (or a
+	// failing RNG) goes straight to the per-signature path below.
+	auto zbytes = scratch.vector<uint8_t>(16 * n);
+	const bool use_batch = n > 1 && randomBytes(zbytes);
+
+	auto scalars = scratch.vector<fourq_scalar_t>();
+	auto points = scratch.vector<point_extproj>();
+	auto candidates = scratch.vector<size_t>();
+	scalars.reserve(2 * n);
+	points.reserve(2 * n);
+	candidates.reserve(n);
+	fourq_scalar_t gsum{}; // sum(z_i * s_i) mod order
+
+	// R must decode and re-encode to exactly the bytes in the signature, matching the
+	// encoding comparison the single verifier does
+	auto R_affine = scratch.vector<point_affine>();
+	auto hash_inputs = scratch.vector<Sha512::Message>();
+	R_affine.reserve(use_batch ? n : 0);
+	hash_inputs.reserve(use_batch ? n : 0);
+	for (size_t i = 0; use_batch && i < n; i++) {
+		const auto& sig = sigs[i];
+		if (!signature_well_formed(sig)) {
+			continue; // Rejected outright, never part of the batch
+		}
+		point_affine R;
+		digit_t R_check[NWORDS_ORDER]; // encode() writes through digit_t*
+		if (::decode(sig.data(), &R) != ECCRYPTO_SUCCESS) {
+			continue;
+		}
+		encode(&R, reinterpret_cast<unsigned char*>(R_check));
+		if (std::memcmp(R_check, sig.data(), 32) != 0) {
+			continue;
+		}
+		R_affine.push_back(R);
+		hash_inputs.push_back({std::span<const uint8_t>(sig.data(), 32), pubraw[i], msgs[i]});
+		candidates.push_back(i);
+	}
+
+	// h = H(R || A || M) for all candidates, several messages per SHA-512 compression
+	auto hashes = scratch.vector<Sha512::Digest>(candidates.size());
+	Sha512::hashMany(hash_inputs, hashes);
+
+	for (size_t c = 0; c < candidates.size(); c++) {
+		const size_t i = candidates[c];
+		const auto& sig = sigs[i];
+		fourq_scalar_t z{}, zm, hw = load_words(hashes[c].data()), sw = load_words(sig.data() + 32), t;
+		std::memcpy(z.data(), zbytes.data() + 16 * i, 16);
+		// A unit mod the cofactor 392 = 2^3 * 7^2 (odd, not a multiple of 7), so a small-order
+		// component of one term alone cannot vanish from the sum; 2^64 = 2 mod 7
+		z[0] |= 1;
+		if ((z[0] % 7 + 2 * (z[1] % 7)) % 7 == 0) {
+			z[0] += 2;
+			if (z[0] < 2 && ++z[1] == 0) {
+				z[2] = 1;
+			}
+		}
+		modulo_order(hw.data(), hw.data());
+		modulo_order(sw.data(), sw.data());
+		to_Montgomery(z.data(), zm.data());
+
+		// G coefficient: z*s
+		Montgomery_multiply_mod_order(zm.data(), sw.data(), t.data());
+		add_mod_order(gsum.data(), t.data(), gsum.data());
+
+		// A coefficient: z*h
+		Montgomery_multiply_mod_order(zm.data(), hw.data(), t.data());
+		scalars.push_back(t);
+		points.emplace_back();
+		std::memcpy(&points.back(), &pubkeys[i], sizeof(point_extproj));
+
+		// R coefficient: -z, applied as z on -R so the scalar stays 128 bits
+		fp2neg1271(R_affine[c].x);
+		scalars.push_back(z);
+		points.emplace_back();
+		point_setup(&R_affine[c], &points.back());
+	}
+
+	bool batch_ok = false;
+	if (!candidates.empty()) {
+		point_t G_affine;
+		point_extproj_t acc, sG;
+		point_extproj_precomp_t sG_precomp;
+		detail::multi_mul(scalars, points, acc);
+		if (detail::mul_fixed_base(gsum.data(), G_affine)) {
+			point_setup(G_affine, sG);
+			R1_to_R2(sG, sG_precomp);
+			eccadd(sG_precomp, acc);
+			// Projective identity check (X == 0, Y == Z), no inversion
+			batch_ok = reinterpret_cast<const Point&>(acc[0]).isZero();
+		}
+	}
+
+	if (batch_ok && candidates.size() == n) {
+		std::fill(results, results + n, 1);
+		return true;
+	}
+	if (batch_ok) {
+		for (size_t i : candidates) {
+			results[i] = 1;
+		}
+		return false;
+	}
+
+	// Combined check failed (or was skipped): find the bad signatures one by one
+	bool all_ok = true;
+	for (size_t i = 0; i < n; i++) {
+		// Point wraps exactly one point_extproj, see the layout static_asserts in fourq.hpp
+		results[i] = SchnorrQVerify(reinterpret_cast<const Point&>(pubkeys[i]), msgs[i], sigs[i]);
+		all_ok = all_ok && results[i];
+	}
+	return all_ok;
+}
+
+void check_lengths(size_t n, size_t msgs, size_t sigs) {
+	if (msgs != n || sigs != n) {
+		throw std::invalid_argument("SchnorrQVerifyBatch: pubkeys, msgs and sigs must have the same length");
+	}
+}
+
+// Keeps the caller's capacity: assign() does not reallocate once results is large enough
+void copy_results(const uint8_t* valid, size_t n, std::vector<bool>& results) {
+	results.assign(n, false);
+	for (size_t i = 0; i < n; i++) {
+		results[i] = valid[i] != 0;
+	}
+}
+
+bool verify_points(std::span<const Point> pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	uint8_t* results)
+{
+	const size_t n = pubkeys.size();
+	detail::Scratch scratch;
+	// All key encodings with one shared inversion instead of one getRaw() each
+	auto pubraw = scratch.vector<EccDataType>(n > 1 ? n : 0);
+	if (n > 1) {
+		encodeAll(pubkeys, pubraw);
+	}
+	return verify_batch({reinterpret_cast<const point_extproj*>(pubkeys.data()), n}, pubraw, msgs, sigs, results);
+}
+
+} // anonymous namespace
+
+bool SchnorrQVerifyBatch(std::span<const Point> pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results)
+{
+	const size_t n = pubkeys.size();
+	check_lengths(n, msgs.size(), sigs.size());
+	detail::Scratch scratch;
+	auto valid = scratch.vector<uint8_t>(n);
+	const bool all = verify_points(pubkeys, msgs, sigs, valid.data());
+	copy_results(valid.data(), n, results);
+	return all;
+}
+
+bool SchnorrQVerifyBatch(std::span<const Point> pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs)
+{
+	check_lengths(pubkeys.size(), msgs.size(), sigs.size());
+	detail::Scratch scratch;
+	auto valid = scratch.vector<uint8_t>(pubkeys.size());
+	return verify_points(pubkeys, msgs, sigs, valid.data());
+}
+
+namespace {
+
+bool verify_point_batch(const PointBatch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	uint8_t* results)
+{
+	const size_t n = pubkeys.size();
+	check_lengths(n, msgs.size(), sigs.size());
+	detail::Scratch scratch;
+	auto points = scratch.vector<point_extproj>(n);
+	auto pubraw = scratch.vector<EccDataType>(n);
+	for (size_t i = 0; i < n; i++) {
+		const Point P = pubkeys.get(i);
+		std::memcpy(&points[i], &P, sizeof(point_extproj));
+	}
+	pubkeys.encodeAll(pubraw); // Affine already, no inversion
+	return verify_batch(points, pubraw, msgs, sigs, results);
+}
+
+} // anonymous namespace
+
+bool detail::schnorrq_verify_batch(const PointBatch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs,
+	std::vector<bool>& results)
+{
+	detail::Scratch scratch;
+	auto valid = scratch.vector<uint8_t>(pubkeys.size());
+	const bool all = verify_point_batch(pubkeys, msgs, sigs, valid.data());
+	copy_results(valid.data(), pubkeys.size(), results);
+	return all;
+}
+
+bool detail::schnorrq_verify_batch(const PointBatch& pubkeys,
+	std::span<const std::span<const uint8_t>> msgs,
+	std::span<const std::array<uint8_t, 64>> sigs)
+{
+	detail::Scratch scratch;
+	auto valid = scratch.vector<uint8_t>(pubkeys.size());
+	return verify_point_batch(pubkeys, msgs, sigs, valid.data());
+}
+
+} // namespace FourQ
+} // namespace Curve
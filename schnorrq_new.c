@@ -19,6 +19,11 @@
 #include <string.h>
 
 
+// Byte buffers such as SecretKey, Signature or the hash output are never accessed through
+// (digit_t*) casts: scalars and hashes live in digit_t arrays and are copied in and out with
+// memcpy, and points are encoded into a digit_t buffer first. This keeps the code free of
+// strict-aliasing and alignment UB so it can be built at any optimization level.
+
 ECCRYPTO_STATUS SchnorrQ_KeyGeneration(const unsigned char* SecretKey, unsigned char* PublicKey)
 { // SchnorrQ public key generation
   // It produces a public key PublicKey, which is the encoding of P = s*G, where G is the generator and
@@ -26,8 +31,7 @@ ECCRYPTO_STATUS SchnorrQ_KeyGeneration(const unsigned char* SecretKey, unsigned
   // Input:  32-byte SecretKey
   // Output: 32-byte PublicKey
 	point_t P;
-	unsigned char k[64];
-	ECCRYPTO_STATUS Status = ECCRYPTO_ERROR_UNKNOWN;
+	digit_t k[NWORDS_ORDER], encoded[NWORDS_ORDER];
   
 	/* XXX We directly use secret key to generate k
 	if (CryptoHashFunction(SecretKey, 32, k) != 0) {   
@@ -35,19 +39,14 @@ ECCRYPTO_STATUS SchnorrQ_KeyGeneration(const unsigned char* SecretKey, unsigned
 		goto cleanup;
 	}
 	*/
-    memset(k, 0x00, 64);
 	memcpy(k, SecretKey, 32);
 	
-	ecc_mul_fixed((digit_t*)k, P);          // Compute public key                                       
-	encode(P, PublicKey);                   // Encode public key
+	ecc_mul_fixed(k, P);                    // Compute public key                                       
+	encode(P, (unsigned char*)encoded);     // Encode public key
+	memcpy(PublicKey, encoded, 32);
 
+	clear_words((unsigned int*)k, 256/(sizeof(unsigned int)*8));
 	return ECCRYPTO_SUCCESS;
-
-cleanup:
-	clear_words((unsigned int*)k, 512/(sizeof(unsigned int)*8));
-	clear_words((unsigned int*)PublicKey, 256/(sizeof(unsigned int)*8));
-
-	return Status;
 }
 
 
@@ -83,10 +82,11 @@ ECCRYPTO_STATUS SchnorrQ_Sign(const unsigned char* SecretKey, const unsigned cha
   // It produces the signature Signature of a message Message of size SizeMessage in bytes
   // Inputs: 32-byte SecretKey, 32-byte PublicKey, and Message of size SizeMessage in bytes
   // Output: 64-byte Signature 
+  // The secret scalar is SecretKey itself (so PublicKey = SecretKey*G), while the nonce prefix
+  // is the upper half of H(SecretKey), as in the reference SchnorrQ key expansion.
 	point_t R;
-	unsigned char k[64], r[64], h[64], *temp = NULL;
-	digit_t* H = (digit_t*)h;
-	digit_t* S = (digit_t*)(Signature+32);
+	digit_t k[NWORDS_ORDER], kh[2*NWORDS_ORDER], r[2*NWORDS_ORDER], h[2*NWORDS_ORDER], S[NWORDS_ORDER], encoded[NWORDS_ORDER];
+	unsigned char *temp = NULL;
 	ECCRYPTO_STATUS Status = ECCRYPTO_ERROR_UNKNOWN;
 
 	/* XXX WE Directly use secret key to generate k
@@ -95,10 +95,15 @@ ECCRYPTO_STATUS SchnorrQ_Sign(const unsigned char* SecretKey, const unsigned cha
 		goto cleanup;
 	}
 	*/
-	memset(k, 0x00, 64);
 	memcpy(k, SecretKey, 32);
-	memset(r, 0x00, 64);
-	memset(h, 0x00, 64);
+	memset(kh, 0x00, sizeof(kh));
+	memset(r, 0x00, sizeof(r));
+	memset(h, 0x00, sizeof(h));
+
+	if (CryptoHashFunction(SecretKey, 32, (unsigned char*)kh) != 0) {   
+		Status = ECCRYPTO_ERROR;
+		goto cleanup;
+	}
 	
 	temp = (unsigned char*)calloc(1, SizeMessage+64);
 	if (temp == NULL) {
@@ -106,36 +111,39 @@ ECCRYPTO_STATUS SchnorrQ_Sign(const unsigned char* SecretKey, const unsigned cha
 		goto cleanup;
 	}
 	
-	memmove(temp+32, k+32, 32);
+	memmove(temp+32, (unsigned char*)kh+32, 32);
 	memmove(temp+64, Message, SizeMessage);
   
-	if (CryptoHashFunction(temp+32, SizeMessage+32, r) != 0) {   
+	if (CryptoHashFunction(temp+32, SizeMessage+32, (unsigned char*)r) != 0) {   
 		Status = ECCRYPTO_ERROR;
 		goto cleanup;
 	}
 	
-	ecc_mul_fixed((digit_t*)r, R); 
-	encode(R, Signature);                   // Encode lowest 32 bytes of signature
+	ecc_mul_fixed(r, R); 
+	encode(R, (unsigned char*)encoded);     // Encode lowest 32 bytes of signature
+	memcpy(Signature, encoded, 32);
 	memmove(temp, Signature, 32);
 	memmove(temp+32, PublicKey, 32);
   
-	if (CryptoHashFunction(temp, SizeMessage+64, h) != 0) {   
+	if (CryptoHashFunction(temp, SizeMessage+64, (unsigned char*)h) != 0) {   
 		Status = ECCRYPTO_ERROR;
 		goto cleanup;
 	}	
-	modulo_order((digit_t*)r, (digit_t*)r);
-	modulo_order(H, H);
-	to_Montgomery((digit_t*)k, S);          // Converting to Montgomery representation
-	to_Montgomery(H, H);                    // Converting to Montgomery representation
-	Montgomery_multiply_mod_order(S, H, S);
+	modulo_order(r, r);
+	modulo_order(h, h);
+	to_Montgomery(k, S);                    // Converting to Montgomery representation
+	to_Montgomery(h, h);                    // Converting to Montgomery representation
+	Montgomery_multiply_mod_order(S, h, S);
 	from_Montgomery(S, S);                  // Converting back to standard representation
-	subtract_mod_order((digit_t*)r, S, S);
+	subtract_mod_order(r, S, S);
+	memcpy(Signature+32, S, 32);
 	Status = ECCRYPTO_SUCCESS;
 	
 cleanup:
 	if (temp != NULL)
 		free(temp);
-	clear_words((unsigned int*)k, 512/(sizeof(unsigned int)*8));
+	clear_words((unsigned int*)k, 256/(sizeof(unsigned int)*8));
+	clear_words((unsigned int*)kh, 512/(sizeof(unsigned int)*8));
 	clear_words((unsigned int*)r, 512/(sizeof(unsigned int)*8));
 	
 	return Status;
@@ -148,8 +156,8 @@ ECCRYPTO_STATUS SchnorrQ_Verify(const unsigned char* PublicKey, const unsigned c
   // Inputs: 32-byte PublicKey, 64-byte Signature, and Message of size SizeMessage in bytes
   // Output: true (valid signature) or false (invalid signature)
 	point_t A;
-	unsigned char *temp, h[64];
-	unsigned int i;
+	digit_t h[2*NWORDS_ORDER], s[NWORDS_ORDER], encoded[NWORDS_ORDER];
+	unsigned char *temp;
 	ECCRYPTO_STATUS Status = ECCRYPTO_ERROR_UNKNOWN;  
 
 	*valid = false;
@@ -174,22 +182,21 @@ ECCRYPTO_STATUS SchnorrQ_Verify(const unsigned char* PublicKey, const unsigned c
 	memmove(temp+32, PublicKey, 32);
 	memmove(temp+64, Message, SizeMessage);
   
-	if (CryptoHashFunction(temp, SizeMessage+64, h) != 0) {   
+	if (CryptoHashFunction(temp, SizeMessage+64, (unsigned char*)h) != 0) {   
 		Status = ECCRYPTO_ERROR;
 		goto cleanup;
 	}
 
-	Status = ecc_mul_double((digit_t*)(Signature+32), A, (digit_t*)h, A);      
+	memcpy(s, Signature+32, 32);
+	Status = ecc_mul_double(s, A, h, A) ? ECCRYPTO_SUCCESS : ECCRYPTO_ERROR;
 	if (Status != ECCRYPTO_SUCCESS) {                                                
 		goto cleanup;
 	}
 	
-	encode(A, (unsigned char*)A);
+	encode(A, (unsigned char*)encoded);
 
-	for (i = 0; i < NWORDS_ORDER; i++) {
-		if (((digit_t*)A)[i] != ((digit_t*)Signature)[i]) {
-			goto cleanup;   
-		}
+	if (memcmp(encoded, Signature, 32) != 0) {
+		goto cleanup;   
 	}
 	*valid = true;
 
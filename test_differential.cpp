@@ -0,0 +1,111 @@
+// 差分测试：每条优化路径（端同态、汇编后端、SIMD 通道、MSM、批量验证、惰性规范化）
+// 与 fourq_differential.hpp 中的朴素参考实现逐一比对。
+//
+// 每个 Check 用随机字节跑若干轮；轮数乘以环境变量 FASTECC_DIFF_ITERATIONS（默认 1）。
+// 失败时把输入写到 fastecc_diff_<Check>.bin，可用 fastecc_fuzz_replay 或模糊测试器复现。
+#include "gtest/gtest.h"
+#include "fourq_differential.hpp"
+#include "fourq_random.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Curve::FourQ::differential::Check;
+
+// 每个 Check 的默认轮数（按单轮耗时粗调，Debug 构建下整套在数秒内完成）
+struct CheckCase {
+    Check check;
+    unsigned iterations;
+};
+
+constexpr CheckCase kCases[] = {
+    {Check::Scalar, 400},
+    {Check::ScalarMul, 30},
+    {Check::Normalization, 40},
+    {Check::MultiMul, 12},
+    {Check::Lanes, 40},
+    {Check::Sha512, 150},
+    {Check::Signatures, 8},
+    {Check::Decode, 150},
+};
+
+unsigned iterationScale() {
+    const char* env = std::getenv("FASTECC_DIFF_ITERATIONS");
+    if (env == nullptr) {
+        return 1;
+    }
+    const long v = std::strtol(env, nullptr, 10);
+    return v > 0 ? (unsigned)v : 1;
+}
+
+// 输入带上首字节（Check 编号），与模糊测试器的格式一致
+std::string saveInput(Check check, const std::vector<uint8_t>& input) {
+    const std::string path = std::string("fastecc_diff_") + Curve::FourQ::differential::checkName(check) + ".bin";
+    std::ofstream out(path, std::ios::binary);
+    const char id = (char)check;
+    out.write(&id, 1);
+    out.write(reinterpret_cast<const char*>(input.data()), (std::streamsize)input.size());
+    return path;
+}
+
+class DifferentialTest : public ::testing::TestWithParam<CheckCase> {};
+
+} // anonymous namespace
+
+// 随机输入：各路径结果必须一致
+TEST_P(DifferentialTest, RandomInputs) {
+    const CheckCase c = GetParam();
+    const unsigned n = c.iterations * iterationScale();
+    std::vector<uint8_t> input(1024); // 远多于任何 Check 会读取的字节
+    for (unsigned i = 0; i < n; i++) {
+        ASSERT_TRUE(Curve::FourQ::randomBytes(input));
+        Curve::FourQ::differential::FuzzInput in(input);
+        const std::string error = Curve::FourQ::differential::run(c.check, in);
+        if (!error.empty()) {
+            FAIL() << error << " (iteration " << i << ", input saved to " << saveInput(c.check, input) << ")";
+        }
+    }
+}
+
+// 边界输入：空输入（全部读作 0）、全 0xFF、截断的随机输入
+TEST_P(DifferentialTest, EdgeInputs) {
+    const CheckCase c = GetParam();
+    std::vector<uint8_t> random(24);
+    ASSERT_TRUE(Curve::FourQ::randomBytes(random));
+    const std::vector<std::vector<uint8_t>> inputs = {
+        {},
+        std::vector<uint8_t>(1024, 0xFF),
+        random,
+    };
+    for (const std::vector<uint8_t>& input : inputs) {
+        Curve::FourQ::differential::FuzzInput in(input);
+        const std::string error = Curve::FourQ::differential::run(c.check, in);
+        EXPECT_TRUE(error.empty()) << error << " (input saved to " << saveInput(c.check, input) << ")";
+    }
+}
+
+// 模糊测试入口：任意字节串都不应报不一致（首字节选择 Check）
+TEST(DifferentialFuzzEntry, ArbitraryBytes) {
+    std::vector<uint8_t> input(96);
+    for (unsigned i = 0; i < 64; i++) {
+        ASSERT_TRUE(Curve::FourQ::randomBytes(input));
+        input[0] = (uint8_t)(i % Curve::FourQ::differential::kCheckCount);
+        const std::string error = Curve::FourQ::differential::run(input);
+        EXPECT_TRUE(error.empty()) << error;
+    }
+    EXPECT_TRUE(Curve::FourQ::differential::run(std::span<const uint8_t>()).empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(Checks, DifferentialTest, ::testing::ValuesIn(kCases),
+    [](const ::testing::TestParamInfo<CheckCase>& param) {
+        return std::string(Curve::FourQ::differential::checkName(param.param.check));
+    });
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -1,9 +1,39 @@
 #include "gtest/gtest.h"
 #include "fourq.hpp" // 这会包含 utils.hpp 和 .c 文件
+#include "fourq_async_verifier.hpp"
+#include "fourq_batch_engine.hpp"
+#include "fourq_comb.hpp"
+#include "fourq_decode_cache.hpp"
+#include "fourq_kex.hpp"
+#include "fourq_keystore.hpp"
+#include "fourq_msm.hpp"
+#include "fourq_random.hpp"
+#include "fourq_scratch.hpp"
+#include "fourq_sha512.hpp"
+#include "fourq_soa.hpp"
+#include "fourq_stats.hpp"
+#include "FourQlib/sha512/sha512.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdio>
+#include <fstream>
+#include <future>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <span>
 #include <string>
 #include <vector>
 #include <stdexcept>
 #include <system_error> // 包含 std::errc
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/wait.h> // fork/waitpid
+#include <unistd.h>
+#endif
 
 // 用于 FourQ 测试的 Test Fixture
 class FourQTest : public ::testing::Test {
@@ -51,6 +81,66 @@ protected:
     }
 };
 
+// 朴素倍加求 k*P：ecc_mul 假定 P 在素数阶子群中，不能用于带小阶分量的点
+static Curve::FourQ::Point plainMul(const Curve::FourQ::Point& P, const Curve::FourQ::EccDataType& k) {
+    Curve::FourQ::Point acc;
+    for (int bit = 255; bit >= 0; --bit) {
+        acc.dbl();
+        if ((k[bit / 8] >> (bit % 8)) & 1) {
+            acc += P;
+        }
+    }
+    return acc;
+}
+
+// 2 阶或 7 阶点：曲线上随机点 P 的 N*P 阶整除 392 = 8*49，乘 49 留下 2 的部分、乘 8 留下 7 的部分，
+// 再乘 order 直到下一次为零
+static Curve::FourQ::Point smallOrderPoint(uint8_t order) {
+    const Curve::FourQ::EccDataType order_minus_one = Curve::FourQ::Scalar::kOrderMinusOne.getRaw();
+    Curve::FourQ::EccDataType other{}, k{};
+    other[0] = order == 2 ? 49 : 8;
+    k[0] = order;
+    for (;;) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        Curve::FourQ::Point P;
+        try {
+            P = Curve::FourQ::Point(raw);
+        } catch (const std::runtime_error&) {
+            continue;
+        }
+        Curve::FourQ::Point Q = plainMul(plainMul(P, order_minus_one) + P, other);
+        if (Q.isZero()) {
+            continue;
+        }
+        for (Curve::FourQ::Point next = plainMul(Q, k); !next.isZero(); next = plainMul(Q, k)) {
+            Q = next;
+        }
+        return Q;
+    }
+}
+
+// R' = r*G + T 的签名：s = r - h*a，h 按 R' 的编码计算。s*G + h*A = r*G != R'，SchnorrQVerify 必定拒绝，
+// 而组合校验里只剩 -z*T
+static std::array<uint8_t, 64> torsionSignature(const Curve::FourQ::Scalar& a, const Curve::FourQ::Point& T,
+        std::span<const uint8_t> msg) {
+    Curve::FourQ::EccDataType rx;
+    ::random_bytes(rx.data(), 32);
+    const Curve::FourQ::Scalar r(rx);
+    const Curve::FourQ::EccDataType R = (Curve::FourQ::Point::mulBase(r) + T).getRaw();
+    const Curve::FourQ::EccDataType A = Curve::FourQ::Point::mulBase(a).getRaw();
+    uint8_t digest[64];
+    Curve::FourQ::Sha512 ctx;
+    ctx.update(R).update(A).update(msg).final(digest);
+    Curve::FourQ::EccDataType hx;
+    std::memcpy(hx.data(), digest, 32);
+    const Curve::FourQ::Scalar s = r - Curve::FourQ::Scalar(hx) * a;
+    std::array<uint8_t, 64> sig;
+    std::memcpy(sig.data(), R.data(), 32);
+    std::memcpy(sig.data() + 32, s.getRaw().data(), 32);
+    return sig;
+}
+
 // --- Scalar Tests ---
 
 TEST_F(FourQTest, ScalarDefaultConstructor) {
@@ -121,7 +211,7 @@ TEST_F(FourQTest, ScalarAssignment) {
 
 TEST_F(FourQTest, ScalarComparison) {
     Curve::FourQ::Scalar s_copy = s_known;
-    Curve::FourQ::Scalar s_one_copy = s_one;
+    [[maybe_unused]] Curve::FourQ::Scalar s_one_copy = s_one;
     EXPECT_TRUE(s_known == s_copy);
     EXPECT_FALSE(s_known == s_one);
     EXPECT_TRUE(s_known != s_one);
@@ -305,7 +395,7 @@ TEST_F(FourQTest, PointAssignment) {
 // 应比较规范化坐标或原始字节数据
 TEST_F(FourQTest, PointComparison) {
     Curve::FourQ::Point p_copy = p_known;
-    Curve::FourQ::Point p_base_copy = p_base;
+    [[maybe_unused]] Curve::FourQ::Point p_base_copy = p_base;
     // 主要测试: 比较原始字节数据
     EXPECT_TRUE(p_known.getRaw() == p_copy.getRaw());
     EXPECT_FALSE(p_known.getRaw() == p_base.getRaw());
@@ -445,6 +535,33 @@ TEST_F(FourQTest, PointMulAdd) {
 
 }
 
+// 变量基点乘（USE_ENDO 开启时走自同态分解路径）与固定基点乘结果一致，覆盖分解的边界标量
+TEST_F(FourQTest, PointVariableBaseEdgeScalars) {
+    RecordProperty("kUseEndomorphism", Curve::FourQ::kUseEndomorphism ? 1 : 0); // 写入 XML 报告，不打印到标准输出
+
+    Curve::FourQ::Scalar minus_one = Curve::FourQ::Scalar::negate(s_one);
+    Curve::FourQ::Scalar half_order = Curve::FourQ::Point::getOrder() / Curve::FourQ::Scalar(2);
+    std::vector<Curve::FourQ::Scalar> edge = {
+        Curve::FourQ::Scalar(0), s_one, Curve::FourQ::Scalar(2), minus_one,
+        minus_one - s_one, half_order, half_order + s_one, s_known,
+        Curve::FourQ::Scalar("ffffffffffffffffffffffffffffffff00000000000000000000000000000000"),
+        Curve::FourQ::Scalar("0000000000000000000000000000000000000000000000000000000000000001"),
+    };
+    for (int i = 0; i < 8; ++i) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        edge.emplace_back(raw);
+    }
+
+    Curve::FourQ::Scalar m(123457);
+    Curve::FourQ::Point mG = Curve::FourQ::Point::mulBase(m);
+    for (const auto& k : edge) {
+        EXPECT_EQ((k * p_base).getRaw(), Curve::FourQ::Point::mulBase(k).getRaw()) << k;
+        EXPECT_EQ((k * mG).getRaw(), Curve::FourQ::Point::mulBase(k * m).getRaw()) << k;
+        EXPECT_EQ(mG.MulAdd(k, k).getRaw(), Curve::FourQ::Point::mulBase(k + k * m).getRaw()) << k;
+    }
+}
+
 // 新增测试用例：打印 0-100 的标量及其对应的点
 TEST_F(FourQTest, PrintScalarsAndPoints) {
     std::cout << "--- Printing Scalars and Base Points (0 to 100) ---" << std::endl;
@@ -520,6 +637,2002 @@ TEST_F(FourQTest, SchnorrQSign) {
     
 }
 
+// 标量按小端字节序序列化，与主机字节序无关
+TEST_F(FourQTest, ScalarByteOrder) {
+    Curve::FourQ::Scalar s(0x01020304u);
+    Curve::FourQ::EccDataType expected{};
+    expected[0] = 0x04; expected[1] = 0x03; expected[2] = 0x02; expected[3] = 0x01;
+    EXPECT_EQ(s.getRaw(), expected);
+
+    Curve::FourQ::EccDataType raw;
+    ::random_bytes(raw.data(), 32);
+    raw[31] = 0; // 保证小于阶，避免被约减
+    raw[30] &= 0x0F;
+    EXPECT_EQ(Curve::FourQ::Scalar(raw).getRaw(), raw);
+}
+
+// 不同私钥对同一消息签名时 nonce（即 R）必须不同
+TEST_F(FourQTest, SchnorrQNonceDependsOnKey) {
+    std::string msg = "same message";
+    std::array<uint8_t, 64> sig1, sig2, sig1_again;
+    Curve::FourQ::EccDataType skx1, skx2;
+    ::random_bytes(skx1.data(), 32);
+    ::random_bytes(skx2.data(), 32);
+    Curve::FourQ::Scalar sk1(skx1), sk2(skx2);
+
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk1, msg, sig1));
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk2, msg, sig2));
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk1, msg, sig1_again));
+    EXPECT_FALSE(std::equal(sig1.begin(), sig1.begin() + 32, sig2.begin()));
+    EXPECT_EQ(sig1, sig1_again); // 仍是确定性签名
+}
+
+// C 接口使用非对齐缓冲区：配合 FASTECC_SANITIZERS=address,undefined 检查对齐/别名 UB
+TEST_F(FourQTest, SchnorrQUnalignedBuffers) {
+    std::vector<uint8_t> buf(1 + 32 + 32 + 64 + 1 + 13);
+    uint8_t* sk = buf.data() + 1;
+    uint8_t* pk = sk + 32;
+    uint8_t* sig = pk + 32;
+    uint8_t* msg = sig + 64 + 1;
+    unsigned int valid = 0;
+
+    Curve::FourQ::EccDataType skx;
+    ::random_bytes(skx.data(), 32);
+    Curve::FourQ::Scalar s(skx);
+    auto skraw = s.getRaw();
+    std::copy(skraw.begin(), skraw.end(), sk);
+    std::fill(msg, msg + 13, 0x5A);
+
+    ASSERT_EQ(::SchnorrQ_KeyGeneration(sk, pk), ECCRYPTO_SUCCESS);
+    EXPECT_TRUE(std::equal(pk, pk + 32, Curve::FourQ::Point::mulBase(s).getRaw().begin()));
+    ASSERT_EQ(::SchnorrQ_Sign(sk, pk, msg, 13, sig), ECCRYPTO_SUCCESS);
+    ASSERT_EQ(::SchnorrQ_Verify(pk, msg, 13, sig, &valid), ECCRYPTO_SUCCESS);
+    EXPECT_TRUE(valid);
+
+    std::array<uint8_t, 64> aligned_sig;
+    std::vector<uint8_t> aligned_msg(msg, msg + 13);
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(s, aligned_msg, aligned_sig));
+    EXPECT_TRUE(std::equal(sig, sig + 64, aligned_sig.begin()));
+
+    sig[40] ^= 0x01;
+    ::SchnorrQ_Verify(pk, msg, 13, sig, &valid);
+    EXPECT_FALSE(valid);
+}
+
+// 编译选定的域运算后端必须能在当前 CPU 上运行
+TEST_F(FourQTest, FieldBackend) {
+    RecordProperty("fieldBackend", Curve::FourQ::fieldBackendName());
+    ASSERT_TRUE(Curve::FourQ::fieldBackendSupported());
+    if (Curve::FourQ::kFieldBackend == Curve::FourQ::FieldBackend::X64AsmMulx) {
+        EXPECT_TRUE(Curve::FourQ::cpuFeatures().bmi2 && Curve::FourQ::cpuFeatures().adx);
+    }
+
+    // 不同后端的结果必须一致：变量基点乘、双标量乘与固定基点乘互相对照
+    Curve::FourQ::Scalar k("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcd0f");
+    Curve::FourQ::Point P = Curve::FourQ::Point::mulBase(k);
+    EXPECT_EQ(k * Curve::FourQ::Point::getBase(), P);
+    EXPECT_EQ(P.MulAdd(k, Curve::FourQ::Scalar(2)), Curve::FourQ::Point::mulBase(k + k + k));
+}
+
+// 射影坐标下的比较与单位元判断（不做求逆），以及 normalize 缓存仿射形式
+TEST_F(FourQTest, PointLazyNormalization) {
+    Curve::FourQ::Scalar a("1111111111111111111111111111111111111111111111111111111111111100");
+    Curve::FourQ::Scalar b(12345);
+    Curve::FourQ::Point G = Curve::FourQ::Point::getBase();
+    Curve::FourQ::Point P = Curve::FourQ::Point::mulBase(a) + Curve::FourQ::Point::mulBase(b);
+    Curve::FourQ::Point Q = Curve::FourQ::Point::mulBase(a + b);
+
+    EXPECT_TRUE(Q.isNormalized());
+    EXPECT_FALSE(P.isNormalized()); // 加法结果 Z != 1
+    EXPECT_TRUE(P == Q);
+    EXPECT_FALSE(P != Q);
+    EXPECT_FALSE(P == G);
+    EXPECT_EQ(P.getRaw(), Q.getRaw());
+
+    // 单位元：P - P 与 (0, 1) 射影相等，且 -G (x 取负) 不是单位元
+    Curve::FourQ::Point Z = P - P;
+    EXPECT_TRUE(Z.isZero());
+    EXPECT_TRUE(Z == Curve::FourQ::Point::getZero());
+    EXPECT_FALSE(P.isZero());
+    EXPECT_FALSE(Curve::FourQ::Point::negate(G).isZero());
+
+    // normalize 不改变点的值，之后的编码与标量乘结果保持一致
+    Curve::FourQ::Point P2 = P;
+    P2.normalize();
+    EXPECT_TRUE(P2.isNormalized());
+    EXPECT_TRUE(P2 == P);
+    EXPECT_EQ(P2.getRaw(), P.getRaw());
+    EXPECT_EQ(P2.toString(), Q.toString());
+    EXPECT_EQ(b * P2, b * P);
+    EXPECT_EQ(P2.MulAdd(a, b), P.MulAdd(a, b));
+    Z.normalize();
+    EXPECT_TRUE(Z.isZero());
+
+    // std::set 排序仍按编码比较
+    EXPECT_FALSE(P < Q);
+    EXPECT_FALSE(Q < P);
+}
+
+// 批量规范化/编码：共享一次求逆，结果必须与逐个 getRaw 一致
+TEST_F(FourQTest, PointEncodeAll) {
+    Curve::FourQ::Points ps;
+    Curve::FourQ::Point G = Curve::FourQ::Point::getBase();
+    Curve::FourQ::Point acc = G;
+    for (uint32_t i = 0; i < 20; ++i) {
+        acc += G;                                                  // Z != 1
+        ps.push_back(acc);
+        ps.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i + 7))); // Z == 1
+    }
+    ps.push_back(Curve::FourQ::Point::getZero());
+    ps.push_back(acc - acc); // 非规范化的单位元
+
+    std::vector<Curve::FourQ::EccDataType> out(ps.size());
+    Curve::FourQ::encodeAll(ps, out);
+    for (size_t i = 0; i < ps.size(); ++i) {
+        EXPECT_EQ(out[i], ps[i].getRaw()) << "index " << i;
+    }
+
+    Curve::FourQ::Points normalized = ps;
+    Curve::FourQ::normalizeAll(normalized);
+    for (size_t i = 0; i < ps.size(); ++i) {
+        EXPECT_TRUE(normalized[i].isNormalized());
+        EXPECT_TRUE(normalized[i] == ps[i]);
+    }
+
+    // 空输入与长度不匹配
+    std::vector<Curve::FourQ::EccDataType> none;
+    EXPECT_NO_THROW(Curve::FourQ::encodeAll(std::span<const Curve::FourQ::Point>(), none));
+    EXPECT_THROW(Curve::FourQ::encodeAll(ps, none), std::invalid_argument);
+}
+
+// 批量求逆：结果与逐个 invert 一致；含零时抛异常且不修改输入
+TEST_F(FourQTest, ScalarInvertBatch) {
+    Curve::FourQ::Scalars xs;
+    for (int i = 0; i < 17; ++i) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        xs.emplace_back(raw);
+    }
+    xs.push_back(Curve::FourQ::Scalar(1));
+
+    Curve::FourQ::Scalars inv = xs;
+    Curve::FourQ::Scalar::invertBatch(inv);
+    for (size_t i = 0; i < xs.size(); ++i) {
+        EXPECT_EQ(inv[i], Curve::FourQ::Scalar::invert(xs[i])) << "index " << i;
+        EXPECT_EQ(inv[i] * xs[i], Curve::FourQ::Scalar(1));
+    }
+
+    Curve::FourQ::Scalars single = {Curve::FourQ::Scalar(3)};
+    Curve::FourQ::Scalar::invertBatch(single);
+    EXPECT_EQ(single[0], Curve::FourQ::Scalar::invert(Curve::FourQ::Scalar(3)));
+    EXPECT_NO_THROW(Curve::FourQ::Scalar::invertBatch(std::span<Curve::FourQ::Scalar>()));
+
+    Curve::FourQ::Scalars with_zero = xs;
+    with_zero[5] = Curve::FourQ::Scalar();
+    Curve::FourQ::Scalars before = with_zero;
+    EXPECT_THROW(Curve::FourQ::Scalar::invertBatch(with_zero), std::runtime_error);
+    EXPECT_EQ(with_zero, before);
+}
+
+// MontScalar：Montgomery 域内的链式运算与普通 Scalar 结果一致
+TEST_F(FourQTest, MontScalarArithmetic) {
+    Curve::FourQ::Scalar a("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcd0f");
+    Curve::FourQ::Scalar b(987654321), c(42);
+    Curve::FourQ::MontScalar ma(a), mb(b), mc(c);
+
+    EXPECT_EQ(ma.toScalar(), a);
+    EXPECT_EQ((ma + mb).toScalar(), a + b);
+    EXPECT_EQ((ma - mb).toScalar(), a - b);
+    EXPECT_EQ((ma * mb).toScalar(), a * b);
+    EXPECT_EQ((Curve::FourQ::MontScalar::one() * ma), ma);
+    EXPECT_TRUE(Curve::FourQ::MontScalar().isZero());
+    EXPECT_EQ(Curve::FourQ::MontScalar::invert(mb).toScalar(), Curve::FourQ::Scalar::invert(b));
+    EXPECT_THROW(Curve::FourQ::MontScalar::invert(Curve::FourQ::MontScalar()), std::runtime_error);
+
+    // Horner 求值 p(x) = a*x^2 + b*x + c
+    Curve::FourQ::MontScalar x(Curve::FourQ::Scalar(1000003));
+    Curve::FourQ::MontScalar acc = ma;
+    acc *= x;
+    acc += mb;
+    acc *= x;
+    acc += mc;
+    Curve::FourQ::Scalar sx(1000003);
+    EXPECT_EQ(acc.toScalar(), (a * sx + b) * sx + c);
+
+    Curve::FourQ::MontScalars ms = {ma, mb, mc, x};
+    Curve::FourQ::MontScalar::invertBatch(ms);
+    EXPECT_EQ(ms[0] * ma, Curve::FourQ::MontScalar::one());
+    EXPECT_EQ(ms[3].toScalar(), Curve::FourQ::Scalar::invert(sx));
+}
+
+// 预计算表的长期公钥：标量乘、MulAdd 与验签结果必须与普通 Point 一致
+TEST_F(FourQTest, PreparedPoint) {
+    Curve::FourQ::EccDataType skx;
+    ::random_bytes(skx.data(), 32);
+    Curve::FourQ::Scalar sk(skx);
+    Curve::FourQ::Point pk = Curve::FourQ::Point::mulBase(sk);
+    Curve::FourQ::Point nonaffine = pk + Curve::FourQ::Point::getBase();
+
+    Curve::FourQ::Scalar k("0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcd0f");
+    Curve::FourQ::Scalar mG(31337);
+    Curve::FourQ::Scalar kmax = Curve::FourQ::Point::getOrder() - Curve::FourQ::Scalar(1);
+
+    // 不同 (teeth, tables) 组合，包括最后一个块不满的情况
+    const std::vector<std::pair<unsigned, unsigned>> shapes = {{5, 2}, {1, 1}, {4, 3}, {8, 1}, {3, 8}};
+    for (const auto& [teeth, tables] : shapes) {
+        Curve::FourQ::PreparedPoint pp(nonaffine, teeth, tables);
+        EXPECT_EQ(pp.tableSize(), (size_t)tables * ((1u << teeth) - 1));
+        EXPECT_EQ(pp.getRaw(), nonaffine.getRaw());
+        EXPECT_EQ(pp.mul(k), k * nonaffine) << teeth << "x" << tables;
+        EXPECT_EQ(pp.mul(kmax), kmax * nonaffine);
+        EXPECT_TRUE(pp.mul(Curve::FourQ::Scalar()).isZero());
+        EXPECT_EQ(pp.MulAdd(mG, k), nonaffine.MulAdd(mG, k));
+    }
+    EXPECT_THROW(Curve::FourQ::PreparedPoint(pk, 0, 2), std::invalid_argument);
+    EXPECT_THROW(Curve::FourQ::PreparedPoint(pk, 5, 9), std::invalid_argument);
+
+    Curve::FourQ::PreparedPoint prepared(pk);
+    std::string msg = "prepared verify";
+    std::array<uint8_t, 64> sig;
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msg, sig));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(prepared, msg, sig));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(prepared, std::vector<uint8_t>(msg.begin(), msg.end()), sig));
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(prepared, std::string("prepared verify!"), sig));
+
+    auto bad = sig;
+    bad[40] ^= 0x01;
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(prepared, msg, bad));
+    bad = sig;
+    bad[63] = 0x01; // s 超出范围
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(prepared, msg, bad));
+
+    Curve::FourQ::PreparedPoint other(Curve::FourQ::Point::getBase());
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(other, msg, sig));
+}
+
+// 增量 SHA-512：与 FourQlib 的 crypto_sha512 一致（含各种分段方式与块边界长度）
+TEST_F(FourQTest, Sha512Streaming) {
+    uint8_t digest[64], expected[64];
+    const std::string abc = "abc";
+    Curve::FourQ::Sha512::hash(Curve::FourQ::detail::message_bytes(abc), digest);
+    EXPECT_EQ(bytes_to_hex_string(std::vector<uint8_t>(digest, digest + 64)),
+        "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+        "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+
+    std::vector<uint8_t> data(600);
+    ::random_bytes(data.data(), (unsigned int)data.size());
+    for (size_t len : {0, 1, 111, 112, 127, 128, 129, 239, 240, 256, 300, 600}) {
+        crypto_sha512(data.data(), len, expected);
+        Curve::FourQ::Sha512::hash(std::span<const uint8_t>(data.data(), len), digest);
+        EXPECT_EQ(0, memcmp(digest, expected, 64)) << "len " << len;
+
+        // 以不规则长度分段喂入
+        Curve::FourQ::Sha512 ctx;
+        size_t pos = 0, step = 1;
+        while (pos < len) {
+            size_t n = std::min(step, len - pos);
+            ctx.update(std::span<const uint8_t>(data.data() + pos, n));
+            pos += n;
+            step = step * 3 + 1;
+        }
+        ctx.final(digest);
+        EXPECT_EQ(0, memcmp(digest, expected, 64)) << "chunked len " << len;
+    }
+}
+
+// 多路 SHA-512：各后端与 crypto_sha512 一致（长度不一、分段跨块边界、条数不是路数的倍数）
+TEST_F(FourQTest, Sha512HashMany) {
+    std::vector<uint8_t> data(3000);
+    ::random_bytes(data.data(), (unsigned int)data.size());
+    const size_t lens[] = {0, 1, 32, 111, 112, 127, 128, 129, 200, 239, 240, 256, 1000, 2900};
+
+    std::vector<Curve::FourQ::Sha512::Message> msgs;
+    std::vector<Curve::FourQ::Sha512::Digest> expected;
+    for (size_t i = 0; i < 37; i++) {
+        const size_t len = lens[i % std::size(lens)];
+        const uint8_t* p = data.data() + i;
+        // 三段：R(32) || A(32) || M 的形状，以及各段为空的情况
+        const size_t a = std::min<size_t>(len, i % 3 == 0 ? 0 : 32);
+        const size_t b = std::min<size_t>(len - a, i % 4 == 0 ? 0 : 32);
+        msgs.push_back({std::span<const uint8_t>(p, a), std::span<const uint8_t>(p + a, b),
+            std::span<const uint8_t>(p + a + b, len - a - b)});
+        expected.emplace_back();
+        crypto_sha512(p, len, expected.back().data());
+    }
+
+    const Curve::FourQ::Sha512Backend original = Curve::FourQ::sha512Backend();
+    EXPECT_TRUE(Curve::FourQ::sha512BackendSupported(original));
+    for (Curve::FourQ::Sha512Backend backend : {Curve::FourQ::Sha512Backend::Portable, Curve::FourQ::Sha512Backend::AVX2,
+             Curve::FourQ::Sha512Backend::AVX512}) {
+        if (!Curve::FourQ::setSha512Backend(backend)) {
+            EXPECT_FALSE(Curve::FourQ::sha512BackendSupported(backend));
+            continue;
+        }
+        SCOPED_TRACE(Curve::FourQ::sha512BackendName());
+        for (size_t count : {size_t(37), size_t(2), size_t(1), size_t(0)}) {
+            std::vector<Curve::FourQ::Sha512::Digest> out(count);
+            Curve::FourQ::Sha512::hashMany(std::span(msgs).first(count), out);
+            for (size_t i = 0; i < count; i++) {
+                EXPECT_EQ(out[i], expected[i]) << "count " << count << " index " << i;
+            }
+        }
+        std::vector<Curve::FourQ::Sha512::Digest> shorter(3);
+        EXPECT_THROW(Curve::FourQ::Sha512::hashMany(msgs, shorter), std::invalid_argument);
+    }
+    EXPECT_TRUE(Curve::FourQ::setSha512Backend(original));
+}
+
+// RFC 8439 2.3.2 的 ChaCha20 分组测试向量
+TEST_F(FourQTest, ChaCha20BlockVector) {
+    uint32_t key[8];
+    for (uint32_t i = 0; i < 8; i++) {
+        key[i] = (4 * i) | ((4 * i + 1) << 8) | ((4 * i + 2) << 16) | ((4 * i + 3) << 24);
+    }
+    const uint32_t nonce[3] = {0x09000000, 0x4a000000, 0x00000000};
+    uint8_t out[64];
+    Curve::FourQ::detail::chacha20_block(key, 1, nonce, out);
+    const std::string expected =
+        "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+        "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e";
+    char hex[129];
+    for (int i = 0; i < 64; i++) {
+        snprintf(hex + 2 * i, 3, "%02x", out[i]);
+    }
+    EXPECT_EQ(std::string(hex, 128), expected);
+}
+
+// randomBytes：连续读取、跨缓冲区边界与跨重播种间隔的读取都不重复，不同线程的输出不同
+TEST_F(FourQTest, RandomBytes) {
+    std::array<uint8_t, 32> a{}, b{};
+    ASSERT_TRUE(Curve::FourQ::randomBytes(a));
+    ASSERT_TRUE(Curve::FourQ::randomBytes(b));
+    EXPECT_NE(a, b);
+
+    // 奇数长度读取，累计超过 1 MB 以触发重播种
+    std::vector<uint8_t> big(1000003);
+    size_t off = 0;
+    for (size_t len = 1; off < big.size(); len = len * 3 + 1) {
+        const size_t take = std::min(len % 4099, big.size() - off);
+        ASSERT_TRUE(Curve::FourQ::randomBytes(std::span<uint8_t>(big.data() + off, take)));
+        off += take;
+    }
+    ASSERT_TRUE(Curve::FourQ::randomBytes(big));
+    size_t zeros = std::count(big.begin(), big.end(), (uint8_t)0);
+    EXPECT_LT(zeros, big.size() / 128); // 期望约 1/256
+    EXPECT_TRUE(Curve::FourQ::randomBytes(std::span<uint8_t>()));
+
+    std::array<uint8_t, 32> c{};
+    std::thread t([&] { ASSERT_TRUE(Curve::FourQ::randomBytes(c)); });
+    t.join();
+    EXPECT_NE(a, c);
+    EXPECT_NE(b, c);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// fork 之后子进程重新播种，不会复现父进程接下来的输出
+TEST_F(FourQTest, RandomBytesAfterFork) {
+    std::array<uint8_t, 32> warm{};
+    ASSERT_TRUE(Curve::FourQ::randomBytes(warm)); // 确保父进程生成器已初始化且缓冲区有余量
+
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        std::array<uint8_t, 32> out{};
+        const bool ok = Curve::FourQ::randomBytes(out);
+        const ssize_t w = write(fds[1], out.data(), out.size());
+        _exit(ok && w == (ssize_t)out.size() ? 0 : 1);
+    }
+    close(fds[1]);
+    std::array<uint8_t, 32> child{};
+    size_t got = 0;
+    while (got < child.size()) {
+        const ssize_t r = read(fds[0], child.data() + got, child.size() - got);
+        if (r <= 0) {
+            break;
+        }
+        got += (size_t)r;
+    }
+    close(fds[0]);
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    ASSERT_EQ(got, child.size());
+
+    std::array<uint8_t, 32> parent{};
+    ASSERT_TRUE(Curve::FourQ::randomBytes(parent));
+    EXPECT_NE(parent, child);
+}
+#endif
+
+// Scalar::random / randomBatch：非零、小于群阶、互不相同
+TEST_F(FourQTest, ScalarRandom) {
+    const uint64_t order[4] = {0x2FB2540EC7768CE7, 0xDFBD004DFE0F7999, 0xF05397829CBC14E5, 0x0029CBC14E5E0A72};
+    auto below_order = [&](const Curve::FourQ::Scalar& s) {
+        const Curve::FourQ::EccDataType raw = s.getRaw();
+        uint64_t w[4];
+        std::memcpy(w, raw.data(), sizeof(w));
+        for (int i = 3; i >= 0; i--) {
+            if (w[i] != order[i]) {
+                return w[i] < order[i];
+            }
+        }
+        return false;
+    };
+
+    const Curve::FourQ::Scalar a = Curve::FourQ::Scalar::random();
+    const Curve::FourQ::Scalar b = Curve::FourQ::Scalar::random();
+    EXPECT_FALSE(a.isZero());
+    EXPECT_TRUE(below_order(a));
+    EXPECT_NE(a, b);
+
+    std::vector<Curve::FourQ::Scalar> batch(256);
+    Curve::FourQ::Scalar::randomBatch(batch);
+    for (const auto& s : batch) {
+        EXPECT_FALSE(s.isZero());
+        EXPECT_TRUE(below_order(s));
+    }
+    std::sort(batch.begin(), batch.end());
+    EXPECT_EQ(std::adjacent_find(batch.begin(), batch.end()), batch.end());
+    Curve::FourQ::Scalar::randomBatch(std::span<Curve::FourQ::Scalar>());
+
+    // 可直接作为私钥使用
+    const Curve::FourQ::Point pk = Curve::FourQ::Point::mulBase(a);
+    std::array<uint8_t, 64> sig{};
+    const std::string msg = "random key";
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(a, msg, sig));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(pk, msg, sig));
+}
+
+// KeyExchange：公钥与共享密钥与 FourQlib 的 kex.c 逐字节一致，双方结果相同
+TEST_F(FourQTest, KeyExchange) {
+    const Curve::FourQ::KeyExchange alice = Curve::FourQ::KeyExchange::generate();
+    const Curve::FourQ::Scalar bob_sk("0700000000000000000000000000000000000000000000000000000000000000");
+    const Curve::FourQ::KeyExchange bob(bob_sk);
+
+    // 公钥 = CompressedPublicKeyGeneration
+    Curve::FourQ::EccDataType bob_raw = bob_sk.getRaw(), bob_pk{};
+    ASSERT_EQ(CompressedPublicKeyGeneration(bob_raw.data(), bob_pk.data()), ECCRYPTO_SUCCESS);
+    EXPECT_EQ(bob.publicKeyRaw(), bob_pk);
+    EXPECT_EQ(bob.publicKey(), Curve::FourQ::Point::mulBase(bob_sk));
+
+    Curve::FourQ::EccDataType ab{}, ba{}, expected{};
+    ASSERT_TRUE(alice.sharedSecret(bob.publicKeyRaw(), ab));
+    ASSERT_TRUE(bob.sharedSecret(alice.publicKeyRaw(), ba));
+    EXPECT_EQ(ab, ba);
+    ASSERT_EQ(CompressedSecretAgreement(bob_raw.data(), alice.publicKeyRaw().data(), expected.data()), ECCRYPTO_SUCCESS);
+    EXPECT_EQ(ba, expected);
+
+    // Point 与缓存形式结果相同
+    Curve::FourQ::EccDataType via_point{}, via_cache{};
+    ASSERT_TRUE(bob.sharedSecret(alice.publicKey(), via_point));
+    EXPECT_EQ(via_point, expected);
+    Curve::FourQ::DecodeCache cache(64);
+    ASSERT_TRUE(bob.sharedSecret(cache, alice.publicKeyRaw(), via_cache));
+    EXPECT_EQ(via_cache, expected);
+
+    // 拒绝：第 127 位置位、无法解码、单位元
+    Curve::FourQ::EccDataType flagged = alice.publicKeyRaw();
+    flagged[15] |= 0x80;
+    Curve::FourQ::EccDataType bad{};
+    bad[0] = 2; // y = 2 不在曲线上
+    const Curve::FourQ::EccDataType identity = Curve::FourQ::Point().getRaw();
+    for (const auto& peer : {flagged, bad, identity}) {
+        Curve::FourQ::EccDataType secret;
+        secret.fill(0xAA);
+        EXPECT_FALSE(bob.sharedSecret(peer, secret));
+        EXPECT_EQ(secret, Curve::FourQ::EccDataType{});
+        secret.fill(0xAA);
+        EXPECT_FALSE(bob.sharedSecret(cache, peer, secret));
+        EXPECT_EQ(secret, Curve::FourQ::EccDataType{});
+    }
+    EXPECT_FALSE(bob.sharedSecret(Curve::FourQ::Point(), via_point));
+}
+
+// 批量：一个临时密钥对多个对端，重复的对端命中解码缓存，无效对端单独标记
+TEST_F(FourQTest, KeyExchangeBatch) {
+    const Curve::FourQ::KeyExchange eph = Curve::FourQ::KeyExchange::generate();
+    std::vector<Curve::FourQ::EccDataType> peers;
+    for (uint32_t i = 0; i < 8; i++) {
+        peers.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i * 17 + 3)).getRaw());
+    }
+    for (uint32_t i = 0; i < 8; i++) {
+        peers.push_back(peers[i]);
+    }
+    Curve::FourQ::EccDataType bad{};
+    bad[0] = 2;
+    peers.insert(peers.begin() + 5, bad);
+
+    Curve::FourQ::DecodeCache cache(64);
+    std::vector<Curve::FourQ::EccDataType> secrets(peers.size());
+    std::vector<bool> results;
+    EXPECT_FALSE(eph.sharedSecretBatch(cache, peers, secrets, results));
+    ASSERT_EQ(results.size(), peers.size());
+    for (size_t i = 0; i < peers.size(); i++) {
+        Curve::FourQ::EccDataType expected{};
+        const bool ok = eph.sharedSecret(peers[i], expected);
+        EXPECT_EQ(results[i], ok) << "index " << i;
+        EXPECT_EQ(secrets[i], expected) << "index " << i;
+    }
+    EXPECT_FALSE(results[5]);
+    EXPECT_EQ(cache.stats().hits, 8u);
+    EXPECT_EQ(cache.size(), 8u);
+
+    peers.erase(peers.begin() + 5);
+    secrets.resize(peers.size());
+    EXPECT_TRUE(eph.sharedSecretBatch(cache, peers, secrets));
+    std::vector<Curve::FourQ::EccDataType> shorter(3);
+    EXPECT_THROW(eph.sharedSecretBatch(cache, peers, shorter), std::invalid_argument);
+}
+
+// 直方图分桶：32 ns 以下精确，之后每个 2 的幂 16 个桶，桶边界首尾相接
+TEST_F(FourQTest, StatsHistogramBuckets) {
+    using H = Curve::FourQ::LatencyHistogram;
+    for (uint64_t v = 0; v < 32; v++) {
+        EXPECT_EQ(H::bucketFor(v), v);
+    }
+    EXPECT_EQ(H::bucketLowerBound(0), 0u);
+    for (size_t i = 0; i + 1 < H::kBuckets; i++) {
+        const uint64_t lo = H::bucketLowerBound(i), hi = H::bucketUpperBound(i);
+        ASSERT_LT(lo, hi) << "bucket " << i;
+        ASSERT_EQ(H::bucketFor(lo), i);
+        ASSERT_EQ(H::bucketFor(hi - 1), i);
+        ASSERT_EQ(H::bucketFor(hi), i + 1);
+        ASSERT_LE((hi - lo) * 16, std::max<uint64_t>(lo, 16)); // 相对误差至多 1/16
+    }
+    EXPECT_EQ(H::bucketFor(~0ull), H::kBuckets - 1);
+    EXPECT_EQ(H::bucketFor((uint64_t)1 << 40), H::kBuckets - 1);
+
+    H h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    for (uint64_t v : {10ull, 1000ull, 1000ull, 100000ull}) {
+        h.buckets[H::bucketFor(v)]++;
+        h.count++;
+        h.sumNs += v;
+    }
+    EXPECT_EQ(h.percentile(0.0), 11u);
+    EXPECT_EQ(h.percentile(0.5), H::bucketUpperBound(H::bucketFor(1000)));
+    EXPECT_EQ(h.percentile(1.0), H::bucketUpperBound(H::bucketFor(100000)));
+    EXPECT_DOUBLE_EQ(h.meanNs(), 102010.0 / 4);
+}
+
+// 计数与快照：FASTECC_STATS 关闭时快照全为零；打开时统计各线程（含已退出线程）的调用
+TEST_F(FourQTest, StatsCounters) {
+    using Curve::FourQ::StatOp;
+    Curve::FourQ::resetStats();
+    Curve::FourQ::Point p = Curve::FourQ::Point::mulBase(s_known); // 已规范化
+    Curve::FourQ::Point q = p + p;                                 // 未规范化
+    const Curve::FourQ::EccDataType raw = q.getRaw();              // 一次求逆 + 编码
+    (void)Curve::FourQ::Point(raw);
+    std::thread t([&] {
+        Curve::FourQ::Point r = p;
+        r *= s_known;
+    });
+    t.join();
+    std::vector<Curve::FourQ::Point> pts(5, q);
+    Curve::FourQ::normalizeAll(pts);
+
+    const Curve::FourQ::StatsSnapshot s = Curve::FourQ::statsSnapshot();
+    if (!Curve::FourQ::kStatsEnabled) {
+        for (const auto& op : s.ops) {
+            EXPECT_EQ(op.calls, 0u);
+            EXPECT_EQ(op.latency.count, 0u);
+        }
+        return;
+    }
+    EXPECT_EQ(s[StatOp::MulBase].calls, 1u);
+    EXPECT_GE(s[StatOp::Normalize].calls, 1u);
+    EXPECT_GE(s[StatOp::Encode].calls, 1u);
+    EXPECT_EQ(s[StatOp::Decode].calls, 1u);
+    EXPECT_EQ(s[StatOp::Mul].calls, 1u); // 来自已退出的线程
+    EXPECT_EQ(s[StatOp::BatchNormalize].calls, 1u);
+    EXPECT_EQ(s[StatOp::BatchNormalize].items, 5u);
+    EXPECT_EQ(s[StatOp::MulBase].latency.count, 1u);
+    EXPECT_GT(s[StatOp::MulBase].latency.sumNs, 0u);
+
+    Curve::FourQ::resetStats();
+    EXPECT_EQ(Curve::FourQ::statsSnapshot()[StatOp::MulBase].calls, 0u);
+}
+
+// Prometheus 文本格式：每个操作都有计数、累积桶与 +Inf/sum/count
+TEST_F(FourQTest, StatsPrometheus) {
+    Curve::FourQ::StatsSnapshot s;
+    auto& mul = s.ops[(size_t)Curve::FourQ::StatOp::Mul];
+    mul.calls = 3;
+    mul.items = 3;
+    mul.latency.count = 3;
+    mul.latency.sumNs = 3000;
+    mul.latency.buckets[Curve::FourQ::LatencyHistogram::bucketFor(1000)] = 3;
+    const std::string text = Curve::FourQ::statsPrometheus(s);
+    EXPECT_NE(text.find("# TYPE fastecc_calls_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_calls_total{op=\"mul\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_calls_total{op=\"schnorrq_verify_batch\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_latency_seconds_bucket{op=\"mul\",le=\"5.12e-07\"} 0\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_latency_seconds_bucket{op=\"mul\",le=\"1.024e-06\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_latency_seconds_bucket{op=\"mul\",le=\"+Inf\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_latency_seconds_sum{op=\"mul\"} 3e-06\n"), std::string::npos);
+    EXPECT_NE(text.find("fastecc_latency_seconds_count{op=\"mul\"} 3\n"), std::string::npos);
+    EXPECT_STREQ(Curve::FourQ::statOpName(Curve::FourQ::StatOp::MulDouble), "mul_double");
+}
+
+// 临时内存池：按块分配、回退到标记处复用、对齐、只收回最后一次分配，以及调用方提供的缓冲区
+TEST_F(FourQTest, ScratchArena) {
+    Curve::FourQ::ScratchArena arena(4096);
+    EXPECT_EQ(arena.blocks(), 0u); // 首次分配时才申请
+    void* a = arena.allocate(100, 8);
+    const Curve::FourQ::ScratchArena::Mark m = arena.mark();
+    void* b = arena.allocate(5000, 16); // 放不进第一块
+    EXPECT_EQ(arena.blocks(), 2u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 16, 0u);
+    EXPECT_GE(arena.used(), 5100u);
+    arena.rewind(m);
+    EXPECT_LT(arena.used(), 5000u);
+    EXPECT_EQ(arena.allocate(5000, 16), b); // 块被保留并复用
+    EXPECT_EQ(arena.blocks(), 2u);
+    const size_t high = arena.highWater();
+    EXPECT_GE(high, 5100u);
+
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.allocate(100, 8), a);
+    void* c = arena.allocate(64, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 64, 0u);
+    const size_t before = arena.used();
+    void* d = arena.allocate(200, 8);
+    arena.deallocate(d, 200, 8); // 最后一次分配可以收回
+    EXPECT_EQ(arena.used(), before);
+    EXPECT_EQ(arena.allocate(200, 8), d);
+    EXPECT_EQ(arena.highWater(), high);
+    arena.reset();
+    arena.release();
+    EXPECT_EQ(arena.blocks(), 0u);
+    EXPECT_EQ(arena.capacity(), 0u);
+
+    // 固定缓冲区，上游为 null_memory_resource：放不下时抛 bad_alloc，绝不访问堆
+    alignas(64) std::array<std::byte, 1024> buffer;
+    Curve::FourQ::ScratchArena fixed(buffer);
+    void* e = fixed.allocate(512, 8);
+    EXPECT_GE(static_cast<std::byte*>(e), buffer.data());
+    EXPECT_LE(static_cast<std::byte*>(e) + 512, buffer.data() + buffer.size());
+    EXPECT_THROW((void)fixed.allocate(1024, 8), std::bad_alloc);
+    EXPECT_EQ(fixed.blocks(), 0u);
+    EXPECT_GT(fixed.capacity(), 900u);
+}
+
+namespace {
+
+// 统计分配次数与未释放字节数的内存资源
+struct CountingResource : std::pmr::memory_resource {
+    size_t allocations = 0;
+    size_t live = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        live += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        live -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& that) const noexcept override { return this == &that; }
+};
+
+} // anonymous namespace
+
+// 批量接口的临时数组来自当前线程的临时内存：默认为每线程内存池，ScratchScope 可换成调用方的资源
+TEST_F(FourQTest, ScratchScope) {
+    const size_t n = 16;
+    std::vector<Curve::FourQ::Point> pks;
+    std::vector<Curve::FourQ::Scalar> ks;
+    std::vector<std::vector<uint8_t>> msgs(n);
+    std::vector<std::span<const uint8_t>> spans;
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    for (size_t i = 0; i < n; i++) {
+        const Curve::FourQ::Scalar sk = Curve::FourQ::Scalar::random();
+        ks.push_back(sk);
+        pks.push_back(Curve::FourQ::Point::mulBase(sk));
+        msgs[i].assign(32, (uint8_t)i);
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msgs[i]), sigs[i]));
+    }
+    for (const auto& m : msgs) {
+        spans.emplace_back(m);
+    }
+    const Curve::FourQ::Point expected = Curve::FourQ::Point::MultiMul(ks, pks);
+
+    // 默认：每线程内存池，调用结束后回退
+    Curve::FourQ::ScratchArena& local = Curve::FourQ::threadScratch();
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs));
+    EXPECT_EQ(local.used(), 0u);
+    EXPECT_GT(local.highWater(), 0u);
+
+    // 调用方的通用资源：每次分配都有对应的释放
+    CountingResource counting;
+    {
+        Curve::FourQ::ScratchScope scope(counting);
+        std::vector<bool> results;
+        EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs, results));
+        EXPECT_EQ(results, std::vector<bool>(n, true));
+        EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, pks), expected);
+    }
+    EXPECT_GT(counting.allocations, 0u);
+    EXPECT_EQ(counting.live, 0u);
+
+    // 调用方的固定缓冲区：结果不变，调用结束后回退；缓冲区太小时抛 bad_alloc
+    std::vector<std::byte> buffer(256 * 1024);
+    Curve::FourQ::ScratchArena fixed(buffer);
+    {
+        Curve::FourQ::ScratchScope scope(fixed);
+        EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs));
+        EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, pks), expected);
+        std::vector<Curve::FourQ::Point> copy = pks;
+        Curve::FourQ::normalizeAll(copy);
+        EXPECT_EQ(copy, pks);
+    }
+    EXPECT_EQ(fixed.used(), 0u);
+    EXPECT_GT(fixed.highWater(), 0u);
+    EXPECT_EQ(fixed.blocks(), 0u);
+
+    std::array<std::byte, 256> tiny;
+    Curve::FourQ::ScratchArena small(tiny);
+    {
+        Curve::FourQ::ScratchScope scope(small);
+        EXPECT_THROW(Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs), std::bad_alloc);
+    }
+    EXPECT_EQ(small.used(), 0u);
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs)); // 作用域结束后恢复默认
+}
+
+// 热路径不分配堆内存：预热一次后，签名、验签、批量验签、多标量乘（含并行版）与批量规范化均不调用 operator new
+// （只有 -DFASTECC_HEAP_CHECK=ON 构建才真正检查）
+TEST_F(FourQTest, NoHeapHotPaths) {
+    const size_t n = 64;
+    std::vector<Curve::FourQ::Point> pks;
+    std::vector<Curve::FourQ::Scalar> ks;
+    std::vector<std::vector<uint8_t>> msgs(n);
+    std::vector<std::span<const uint8_t>> spans;
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    for (size_t i = 0; i < n; i++) {
+        ks.push_back(Curve::FourQ::Scalar::random());
+        pks.push_back(Curve::FourQ::Point::mulBase(ks[i]));
+        msgs[i].assign(48, (uint8_t)(i + 1));
+        spans.emplace_back(msgs[i]);
+    }
+    const Curve::FourQ::SigningKey key(ks[0]);
+    std::vector<Curve::FourQ::Point> big(300, pks[1]); // Pippenger 路径
+    std::vector<Curve::FourQ::Scalar> bigk(300, ks[2]);
+    // 并行版：调用线程的表取自其临时内存，任务经 std::cref 交给执行器，不复制闭包
+    const Curve::FourQ::Executor executor = Curve::FourQ::Executor::threads(2);
+    std::vector<Curve::FourQ::Point> huge(Curve::FourQ::detail::kParallelMsmThreshold, pks[3]);
+    std::vector<Curve::FourQ::Scalar> hugek(huge.size(), ks[4]);
+    std::vector<Curve::FourQ::EccDataType> raw(n);
+    std::vector<bool> results;
+
+    std::vector<std::array<uint8_t, 64>> keysigs(n);
+    bool ok = true;
+    const auto hot = [&] {
+        for (size_t i = 0; i < n; i++) {
+            ok = Curve::FourQ::SchnorrQSign(ks[i], spans[i], sigs[i]) && ok;
+        }
+        ok = Curve::FourQ::SchnorrQVerify(pks[0], spans[0], sigs[0]) && ok;
+        ok = Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs, results) && ok;
+        ok = Curve::FourQ::SchnorrQVerifyBatch(pks, spans, sigs) && ok;
+        ok = key.signBatch(spans, keysigs) && ok;
+        ok = key.signBatch(spans, keysigs, results) && ok;
+        (void)Curve::FourQ::Point::MultiMul(ks, pks);
+        (void)Curve::FourQ::Point::MultiMul(bigk, big);
+        (void)Curve::FourQ::Point::MultiMul(hugek, huge, executor);
+        Curve::FourQ::encodeAll(pks, raw);
+        Curve::FourQ::normalizeAll(big);
+        Curve::FourQ::Scalar::invertBatch(ks);
+        Curve::FourQ::Scalar::invertBatch(ks);
+    };
+    hot(); // 预热：填满每线程内存池、建立 comb 表并为随机数生成器播种
+    ASSERT_TRUE(ok);
+
+    Curve::FourQ::NoHeapScope scope(Curve::FourQ::NoHeapScope::Action::Count);
+    hot();
+    const uint64_t hot_allocations = scope.allocations();
+    int* volatile probe = new int[100]; // 作为对照
+    delete[] probe;
+    const uint64_t total = scope.allocations();
+
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(hot_allocations, 0u);
+    EXPECT_EQ(total, Curve::FourQ::kHeapCheckEnabled ? 1u : 0u);
+    if (Curve::FourQ::kHeapCheckEnabled) {
+        // 默认的 Action::Abort 直接终止进程
+        EXPECT_DEATH({
+            Curve::FourQ::NoHeapScope strict;
+            int* volatile p = new int(1);
+            delete p;
+        }, "inside a NoHeapScope");
+    }
+}
+
+// span 签名/验签与 C 接口逐字节一致，可直接传 string/vector/span，且不受 unsigned int 长度限制影响
+TEST_F(FourQTest, SchnorrQSpanApi) {
+    Curve::FourQ::EccDataType skx;
+    ::random_bytes(skx.data(), 32);
+    Curve::FourQ::Scalar sk(skx);
+    Curve::FourQ::Point pk = Curve::FourQ::Point::mulBase(sk);
+    auto skraw = sk.getRaw();
+    auto pkraw = pk.getRaw();
+
+    for (size_t len : {1, 63, 64, 65, 1000, 70000}) {
+        std::vector<uint8_t> msg(len);
+        ::random_bytes(msg.data(), (unsigned int)len);
+
+        std::array<uint8_t, 64> sig_cpp, sig_c;
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, std::span<const uint8_t>(msg), sig_cpp));
+        ASSERT_EQ(::SchnorrQ_Sign(skraw.data(), pkraw.data(), msg.data(), (unsigned int)len, sig_c.data()), ECCRYPTO_SUCCESS);
+        EXPECT_EQ(sig_cpp, sig_c) << "len " << len;
+
+        EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(pk, msg, sig_cpp));
+        unsigned int valid = 0;
+        ::SchnorrQ_Verify(pkraw.data(), msg.data(), (unsigned int)len, sig_cpp.data(), &valid);
+        EXPECT_TRUE(valid);
+
+        msg[len / 2] ^= 0x01;
+        EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(pk, std::span<const uint8_t>(msg), sig_cpp));
+    }
+
+    std::string text = "span api";
+    std::array<uint8_t, 64> sig;
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, text, sig));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(pk, std::span<const char>(text), sig));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(pk, std::vector<uint8_t>(text.begin(), text.end()), sig));
+    EXPECT_FALSE(Curve::FourQ::SchnorrQSign(sk, std::string(), sig)); // 空消息仍然拒绝
+}
+
+// 最简协程类型：立即开始执行、结束后自行销毁，用于测试 AsyncVerifier::verify
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+static DetachedTask AwaitVerify(Curve::FourQ::AsyncVerifier& verifier, Curve::FourQ::EccDataType pk, std::vector<uint8_t> msg,
+    std::array<uint8_t, 64> sig, std::promise<bool>& done) {
+    const bool ok = co_await verifier.verify(pk, msg, sig);
+    done.set_value(ok);
+}
+
+// 异步验签：按批量大小或截止时间分批，逐个返回结果；future 与协程两种接口
+TEST_F(FourQTest, AsyncVerifier) {
+    using Curve::FourQ::AsyncVerifier;
+    const size_t n = 24;
+    std::vector<Curve::FourQ::EccDataType> pks(n);
+    std::vector<std::vector<uint8_t>> msgs(n);
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Curve::FourQ::Scalar sk = Curve::FourQ::Scalar::random();
+        pks[i] = Curve::FourQ::Point::mulBase(sk).getRaw();
+        msgs[i].assign(10 + i, (uint8_t)i);
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msgs[i], sigs[i]));
+    }
+    sigs[5][40] ^= 0x01;   // 错误签名
+    pks[9].fill(0xFF);     // 无法解码的公钥
+    msgs[13][0] ^= 0x01;   // 消息被改动
+    auto expected = [](size_t i) { return i != 5 && i != 9 && i != 13; };
+
+    // 按批量大小分发：截止时间很长，凑满 8 个即验证
+    {
+        AsyncVerifier::Options options;
+        options.maxBatch = 8;
+        options.maxDelay = std::chrono::seconds(30);
+        options.threads = 2;
+        AsyncVerifier verifier(options);
+        std::vector<std::future<bool>> results;
+        for (size_t i = 0; i < n; ++i) {
+            results.push_back(verifier.submit(pks[i], msgs[i], sigs[i]));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_EQ(results[i].wait_for(std::chrono::seconds(10)), std::future_status::ready) << i;
+            EXPECT_EQ(results[i].get(), expected(i)) << i;
+        }
+        EXPECT_EQ(verifier.stats().submitted, n);
+        EXPECT_EQ(verifier.stats().batches, n / 8);
+    }
+
+    // 按截止时间分发：不足一批的提交在 maxDelay 后验证；协程在工作线程上恢复
+    {
+        Curve::FourQ::DecodeCache cache;
+        AsyncVerifier::Options options;
+        options.maxDelay = std::chrono::milliseconds(2);
+        options.cache = &cache;
+        AsyncVerifier verifier(options);
+        std::vector<std::promise<bool>> done(4);
+        const size_t picks[4] = {0, 5, 9, 20};
+        for (size_t j = 0; j < 4; ++j) {
+            AwaitVerify(verifier, pks[picks[j]], msgs[picks[j]], sigs[picks[j]], done[j]);
+        }
+        std::future<bool> f = verifier.submit(pks[13], msgs[13], sigs[13]);
+        for (size_t j = 0; j < 4; ++j) {
+            std::future<bool> r = done[j].get_future();
+            ASSERT_EQ(r.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+            EXPECT_EQ(r.get(), expected(picks[j])) << picks[j];
+        }
+        EXPECT_FALSE(f.get());
+        EXPECT_GE(verifier.stats().batches, 1u);
+        EXPECT_EQ(verifier.pending(), 0u);
+    }
+
+    // 背压：队列满时 trySubmit 失败，析构时验证剩余提交
+    std::vector<std::future<bool>> queued;
+    {
+        AsyncVerifier::Options options;
+        options.maxBatch = 8;
+        options.maxQueue = 4;
+        options.maxDelay = std::chrono::seconds(30);
+        AsyncVerifier verifier(options);
+        for (size_t i = 0; i < 4; ++i) {
+            std::optional<std::future<bool>> f = verifier.trySubmit(pks[i], msgs[i], sigs[i]);
+            ASSERT_TRUE(f.has_value());
+            queued.push_back(std::move(*f));
+        }
+        EXPECT_FALSE(verifier.trySubmit(pks[4], msgs[4], sigs[4]).has_value());
+        EXPECT_EQ(verifier.pending(), 4u);
+        EXPECT_EQ(verifier.stats().rejected, 1u);
+        EXPECT_EQ(queued[0].wait_for(std::chrono::milliseconds(20)), std::future_status::timeout);
+    }
+    for (auto& f : queued) {
+        EXPECT_TRUE(f.get());
+    }
+
+    // 阻塞的 submit 在队列腾出空间后返回
+    {
+        AsyncVerifier::Options options;
+        options.maxBatch = 2;
+        options.maxQueue = 1;
+        options.maxDelay = std::chrono::milliseconds(5);
+        AsyncVerifier verifier(options);
+        std::vector<std::future<bool>> results;
+        for (size_t i = 0; i < 6; ++i) {
+            results.push_back(verifier.submit(pks[i], msgs[i], sigs[i]));
+        }
+        for (size_t i = 0; i < 6; ++i) {
+            EXPECT_EQ(results[i].get(), expected(i)) << i;
+        }
+        EXPECT_EQ(verifier.stats().rejected, 0u);
+    }
+
+    AsyncVerifier::Options bad;
+    bad.maxBatch = 0;
+    EXPECT_THROW(AsyncVerifier{bad}, std::invalid_argument);
+}
+
+// Exact 模式逐个验签：两个 R 带同一 2 阶分量的签名在组合校验中抵消，Exact 下与 SchnorrQVerify 一致被拒绝
+TEST_F(FourQTest, AsyncVerifierExact) {
+    using Curve::FourQ::AsyncVerifier;
+    const Curve::FourQ::Point T = smallOrderPoint(2);
+    const size_t n = 4;
+    std::vector<Curve::FourQ::EccDataType> pks(n);
+    std::vector<std::vector<uint8_t>> msgs(n);
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    for (size_t i = 0; i < n; ++i) {
+        const Curve::FourQ::Scalar sk = Curve::FourQ::Scalar::random();
+        pks[i] = Curve::FourQ::Point::mulBase(sk).getRaw();
+        msgs[i].assign(10 + i, (uint8_t)i);
+        if (i == 0 || i == 3) {
+            sigs[i] = torsionSignature(sk, T, msgs[i]);
+        } else {
+            ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msgs[i], sigs[i]));
+        }
+    }
+
+    for (Curve::FourQ::BatchVerification mode : {Curve::FourQ::BatchVerification::Combined, Curve::FourQ::BatchVerification::Exact}) {
+        SCOPED_TRACE((int)mode);
+        AsyncVerifier::Options options;
+        options.maxBatch = n; // 4 个提交凑成一批
+        options.maxDelay = std::chrono::seconds(30);
+        options.verification = mode;
+        AsyncVerifier verifier(options);
+        EXPECT_EQ(verifier.options().verification, mode);
+        std::vector<std::future<bool>> results;
+        for (size_t i = 0; i < n; ++i) {
+            results.push_back(verifier.submit(pks[i], msgs[i], sigs[i]));
+        }
+        for (size_t i = 0; i < n; ++i) {
+            const bool crafted = i == 0 || i == 3;
+            EXPECT_EQ(results[i].get(), mode == Curve::FourQ::BatchVerification::Combined || !crafted) << "index " << i;
+        }
+        EXPECT_EQ(verifier.stats().batches, 1u);
+    }
+}
+
+TEST_F(FourQTest, SchnorrQBatchEngine) {
+    // 3 个私钥轮流签 40 条消息，分片大小 7，多线程与单线程结果一致
+    std::vector<Curve::FourQ::Scalar> sks;
+    for (int k = 0; k < 3; ++k) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        sks.emplace_back(raw);
+    }
+    const size_t n = 40;
+    std::vector<std::vector<uint8_t>> msgs(n);
+    std::vector<Curve::FourQ::SchnorrQBatchEngine::SignJob> signJobs;
+    for (size_t i = 0; i < n; ++i) {
+        msgs[i].resize(1 + i * 13);
+        ::random_bytes(msgs[i].data(), (unsigned int)msgs[i].size());
+        signJobs.push_back({sks[i % 3], msgs[i]});
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        Curve::FourQ::SchnorrQBatchEngine engine(threads, 7);
+        EXPECT_EQ(engine.threads(), threads);
+
+        std::vector<std::array<uint8_t, 64>> sigs(n);
+        std::vector<bool> signed_ok = engine.sign(signJobs, sigs);
+        ASSERT_EQ(signed_ok.size(), n);
+        std::vector<Curve::FourQ::SchnorrQBatchEngine::VerifyJob> verifyJobs;
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_TRUE(signed_ok[i]);
+            std::array<uint8_t, 64> expected;
+            ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sks[i % 3], msgs[i], expected));
+            EXPECT_EQ(sigs[i], expected) << "job " << i; // 确定性签名，结果应逐字节相同
+            verifyJobs.push_back({Curve::FourQ::Point::mulBase(sks[i % 3]).getRaw(), msgs[i], sigs[i]});
+        }
+
+        std::vector<bool> verified = engine.verify(verifyJobs);
+        ASSERT_EQ(verified.size(), n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_TRUE(verified[i]) << "job " << i;
+        }
+
+        // 篡改签名、换错公钥、无效公钥编码：只有对应任务失败
+        verifyJobs[5].sig[40] ^= 0x01;
+        verifyJobs[11].pubkey = Curve::FourQ::Point::mulBase(sks[(11 + 1) % 3]).getRaw();
+        verifyJobs[23].pubkey.fill(0xFF);
+        verified = engine.verify(verifyJobs);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(verified[i], i != 5 && i != 11 && i != 23) << "job " << i;
+        }
+
+        // 空消息与单线程 SchnorrQSign 一样返回 false
+        std::vector<Curve::FourQ::SchnorrQBatchEngine::SignJob> withEmpty = {{sks[0], msgs[0]}, {sks[1], std::span<const uint8_t>()}};
+        std::vector<std::array<uint8_t, 64>> two(2);
+        std::vector<bool> r = engine.sign(withEmpty, two);
+        EXPECT_TRUE(r[0]);
+        EXPECT_FALSE(r[1]);
+
+        EXPECT_TRUE(engine.verify({}).empty());
+        EXPECT_THROW(engine.sign(signJobs, std::span<std::array<uint8_t, 64>>(two)), std::invalid_argument);
+    }
+    EXPECT_THROW(Curve::FourQ::SchnorrQBatchEngine(2, 0), std::invalid_argument);
+}
+
+TEST_F(FourQTest, SchnorrQBatchEngineExact) {
+    // 同一分片里两个 R 带同一 2 阶分量的签名：z_1 + z_2 为偶数，组合校验中相互抵消而被放行；
+    // Exact 模式与 SchnorrQVerify 一致，都拒绝
+    const Curve::FourQ::Point T = smallOrderPoint(2);
+    const size_t n = 6;
+    std::vector<Curve::FourQ::Scalar> sks;
+    std::vector<std::string> msgs;
+    std::vector<Curve::FourQ::SchnorrQBatchEngine::VerifyJob> jobs(n);
+    for (size_t i = 0; i < n; ++i) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        sks.emplace_back(raw);
+        msgs.push_back("engine torsion #" + std::to_string(i));
+    }
+    for (size_t i = 0; i < n; ++i) {
+        const std::span<const uint8_t> msg(reinterpret_cast<const uint8_t*>(msgs[i].data()), msgs[i].size());
+        jobs[i].pubkey = Curve::FourQ::Point::mulBase(sks[i]).getRaw();
+        jobs[i].msg = msg;
+        if (i == 1 || i == 4) {
+            jobs[i].sig = torsionSignature(sks[i], T, msg);
+            EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(Curve::FourQ::Point(jobs[i].pubkey), msgs[i], jobs[i].sig));
+        } else {
+            ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sks[i], msgs[i], jobs[i].sig));
+        }
+    }
+
+    Curve::FourQ::SchnorrQBatchEngine engine(2, n);
+    EXPECT_EQ(engine.verification(), Curve::FourQ::BatchVerification::Combined);
+    EXPECT_EQ(engine.verify(jobs), std::vector<bool>(n, true));
+
+    engine.setVerification(Curve::FourQ::BatchVerification::Exact);
+    const std::vector<bool> exact = engine.verify(jobs);
+    for (size_t i = 0; i < n; ++i) {
+        EXPECT_EQ(exact[i], i != 1 && i != 4) << "job " << i;
+    }
+    jobs[2].pubkey.fill(0xFF); // 无效公钥编码在 Exact 模式下同样判为无效
+    EXPECT_FALSE(engine.verify(jobs)[2]);
+}
+
+TEST_F(FourQTest, FixedBaseComb) {
+    // 不同 (W, V) 的 comb 与 FourQlib 的 ecc_mul_fixed 逐字节一致
+    std::vector<Curve::FourQ::Scalar> ks = {
+        Curve::FourQ::Scalar(0u), Curve::FourQ::Scalar(1u), Curve::FourQ::Scalar(2u),
+        Curve::FourQ::Point::getOrder(), // k = order 时结果为单位元
+        Curve::FourQ::Point::getOrder() - Curve::FourQ::Scalar(1u),
+    };
+    Curve::FourQ::EccDataType allOnes;
+    allOnes.fill(0xFF); // 未约简的 256 位标量
+    ks.emplace_back(allOnes);
+    for (int i = 0; i < 6; ++i) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        ks.emplace_back(raw);
+    }
+
+    const std::pair<unsigned, unsigned> params[] = {{2, 1}, {3, 16}, {4, 2}, {5, 5}, {6, 3}, {8, 1}};
+    for (auto [w, v] : params) {
+        Curve::FourQ::detail::FixedBaseComb comb(w, v);
+        EXPECT_EQ(comb.tableBytes(), (size_t)v * ((size_t)1 << (w - 1)) * sizeof(point_precomp));
+        for (const auto& k : ks) {
+            Curve::FourQ::EccDataType kb = k.getRaw();
+            digit_t kw[NWORDS_ORDER];
+            std::memcpy(kw, kb.data(), 32);
+            point_t expected, actual;
+            ASSERT_TRUE(::ecc_mul_fixed(kw, expected));
+            comb.mul(kw, actual);
+            unsigned char e1[32], e2[32];
+            ::encode(expected, e1);
+            ::encode(actual, e2);
+            EXPECT_EQ(std::memcmp(e1, e2, 32), 0) << "W=" << w << " V=" << v << " k=" << k;
+        }
+    }
+
+    EXPECT_THROW(Curve::FourQ::detail::FixedBaseComb(1, 1), std::invalid_argument);
+    EXPECT_THROW(Curve::FourQ::detail::FixedBaseComb(9, 1), std::invalid_argument);
+    EXPECT_THROW(Curve::FourQ::detail::FixedBaseComb(4, 0), std::invalid_argument);
+
+    // mulBase 使用构建时配置的方法，结果仍与 k*G 一致
+    EXPECT_EQ(Curve::FourQ::kMulBaseTableBytes, (size_t)Curve::FourQ::kMulBaseV * ((size_t)1 << (Curve::FourQ::kMulBaseW - 1)) * 96);
+    for (const auto& k : ks) {
+        EXPECT_EQ(Curve::FourQ::Point::mulBase(k), k * Curve::FourQ::Point::getBase()) << k;
+    }
+}
+
+TEST_F(FourQTest, SigningKey) {
+    Curve::FourQ::EccDataType skx;
+    ::random_bytes(skx.data(), 32);
+    Curve::FourQ::Scalar sk(skx);
+    Curve::FourQ::SigningKey key(sk);
+    EXPECT_EQ(key.publicKey(), Curve::FourQ::Point::mulBase(sk));
+    EXPECT_EQ(key.publicKeyRaw(), Curve::FourQ::Point::mulBase(sk).getRaw());
+
+    // 缓存公钥与 nonce 前缀后的签名与 SchnorrQSign 逐字节一致
+    std::vector<std::vector<uint8_t>> msgs;
+    for (size_t len : {1, 32, 200, 5000}) {
+        msgs.emplace_back(len);
+        ::random_bytes(msgs.back().data(), (unsigned int)len);
+    }
+    msgs.emplace_back(); // 空消息
+    std::vector<std::span<const uint8_t>> spans(msgs.begin(), msgs.end());
+    std::vector<std::array<uint8_t, 64>> sigs(msgs.size());
+    std::vector<bool> results;
+    EXPECT_FALSE(key.signBatch(spans, sigs, results)); // 空消息失败
+    ASSERT_EQ(results.size(), msgs.size());
+    for (size_t i = 0; i + 1 < msgs.size(); ++i) {
+        EXPECT_TRUE(results[i]);
+        std::array<uint8_t, 64> expected;
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msgs[i], expected));
+        EXPECT_EQ(sigs[i], expected);
+        EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(key.publicKey(), msgs[i], sigs[i]));
+    }
+    EXPECT_FALSE(results.back());
+    EXPECT_TRUE(key.signBatch(std::span<const std::span<const uint8_t>>(spans.data(), 2), std::span<std::array<uint8_t, 64>>(sigs.data(), 2)));
+    EXPECT_THROW(key.signBatch(spans, std::span<std::array<uint8_t, 64>>(sigs.data(), 1)), std::invalid_argument);
+
+    // 模板重载与拷贝
+    Curve::FourQ::SigningKey copy = key;
+    std::string text = "signing key";
+    std::array<uint8_t, 64> a, b;
+    ASSERT_TRUE(copy.sign(text, a));
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, text, b));
+    EXPECT_EQ(a, b);
+}
+
+TEST_F(FourQTest, HexCodecs) {
+    // 通用编解码：小写输出，大小写均可输入，可选字节反转
+    const std::array<uint8_t, 4> bytes = {0x00, 0x9f, 0xA5, 0xff};
+    char buf[8];
+    EXPECT_EQ(hex_encode(bytes, buf), 8u);
+    EXPECT_EQ(std::string(buf, 8), "009fa5ff");
+    hex_encode(bytes, buf, true);
+    EXPECT_EQ(std::string(buf, 8), "ffa59f00");
+    EXPECT_THROW(hex_encode(bytes, std::span<char>(buf, 7)), std::invalid_argument);
+
+    std::array<uint8_t, 4> back{};
+    EXPECT_TRUE(hex_decode("009FA5fF", back));
+    EXPECT_EQ(back, bytes);
+    EXPECT_TRUE(hex_decode("ffa59f00", back, true));
+    EXPECT_EQ(back, bytes);
+    EXPECT_FALSE(hex_decode("009fa5f", back));   // 长度错误
+    EXPECT_FALSE(hex_decode("009fa5fg", back));  // 非法字符
+    EXPECT_FALSE(hex_decode(std::string_view("00\0fa5ff", 8), back));
+    EXPECT_EQ(bytes_to_hex_string(bytes), "009fa5ff");
+
+    // Scalar / Point 的无分配接口与字符串接口一致
+    char hex[Curve::FourQ::kHexLength];
+    s_known.toHex(hex);
+    EXPECT_EQ(std::string(hex, sizeof(hex)), s_known.toString());
+    Curve::FourQ::Scalar s;
+    s.fromHex(std::string_view(hex, sizeof(hex)));
+    EXPECT_EQ(s, s_known);
+    EXPECT_THROW(s.fromHex("12"), std::runtime_error);
+    std::string upper = known_scalar_hex;
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    s.fromHex(upper);
+    EXPECT_EQ(s, s_known);
+
+    Curve::FourQ::Point p = p_known + p_base; // 射影坐标
+    p.toHex(hex);
+    EXPECT_EQ(std::string(hex, sizeof(hex)), p.toString());
+    Curve::FourQ::Point q;
+    q.fromHex(std::string_view(hex, sizeof(hex)));
+    EXPECT_EQ(q, p);
+    hex[10] = 'z';
+    EXPECT_THROW(q.fromHex(std::string_view(hex, sizeof(hex))), std::invalid_argument);
+    EXPECT_THROW(q.fromHex("00"), std::invalid_argument);
+}
+
+TEST_F(FourQTest, DecodeCache) {
+    // 容量 8（2 个分片各 4 个），16 个不同的公钥
+    Curve::FourQ::DecodeCache cache(8, 2);
+    EXPECT_EQ(cache.capacity(), 8u);
+    std::vector<Curve::FourQ::EccDataType> keys;
+    for (uint32_t i = 0; i < 16; ++i) {
+        keys.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i * 31 + 5)).getRaw());
+    }
+
+    Curve::FourQ::Point p = cache.decode(keys[0]);
+    EXPECT_EQ(p, Curve::FourQ::Point(keys[0]));
+    EXPECT_EQ(cache.decode(keys[0]), p);
+    auto st = cache.stats();
+    EXPECT_EQ(st.hits, 1u);
+    EXPECT_EQ(st.misses, 1u);
+
+    // 无效编码抛出（与 Point(EccDataType) 一致），且不进入缓存
+    Curve::FourQ::EccDataType bad{};
+    bad[0] = 2; // y = 2 不在曲线上
+    EXPECT_THROW(cache.decode(bad), std::runtime_error);
+    Curve::FourQ::Point untouched = p;
+    EXPECT_FALSE(cache.tryDecode(bad, untouched));
+    EXPECT_EQ(untouched, p);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // 超出容量时按 CLOCK 淘汰，结果始终正确，大小不超过容量
+    for (int round = 0; round < 3; ++round) {
+        for (const auto& k : keys) {
+            EXPECT_EQ(cache.decode(k), Curve::FourQ::Point(k));
+        }
+    }
+    EXPECT_LE(cache.size(), cache.capacity());
+    st = cache.stats();
+    EXPECT_GT(st.evictions, 0u);
+    EXPECT_EQ(st.hits + st.misses, 1u + 1u + 2u + 48u);
+
+    cache.resetStats();
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.stats().hits, 0u);
+    EXPECT_THROW(Curve::FourQ::DecodeCache(0, 1), std::invalid_argument);
+
+    // 多线程并发查询同一批公钥
+    Curve::FourQ::DecodeCache shared(64, 4);
+    std::vector<std::thread> threads;
+    std::atomic<int> wrong{0};
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int round = 0; round < 20; ++round) {
+                for (const auto& k : keys) {
+                    if (shared.decode(k).getRaw() != k) {
+                        wrong++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    EXPECT_EQ(wrong.load(), 0);
+    EXPECT_EQ(shared.stats().hits + shared.stats().misses, 4u * 20u * 16u);
+    EXPECT_GE(shared.stats().hits, 4u * 20u * 16u - 4u * 16u);
+
+    // 验签与批处理引擎经由缓存解码
+    Curve::FourQ::Scalar sk(7u);
+    std::string msg = "cached key";
+    std::array<uint8_t, 64> sig;
+    ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msg, sig));
+    auto pk = Curve::FourQ::Point::mulBase(sk).getRaw();
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerify(shared, pk, Curve::FourQ::detail::message_bytes(msg), sig));
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(shared, bad, Curve::FourQ::detail::message_bytes(msg), sig));
+
+    Curve::FourQ::SchnorrQBatchEngine engine(2, 4);
+    engine.setDecodeCache(&shared);
+    std::vector<Curve::FourQ::SchnorrQBatchEngine::VerifyJob> jobs(6, {pk, Curve::FourQ::detail::message_bytes(msg), sig});
+    jobs[3].pubkey = bad;
+    shared.resetStats();
+    std::vector<bool> ok = engine.verify(jobs);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        EXPECT_EQ(ok[i], i != 3);
+    }
+    EXPECT_EQ(shared.stats().hits, 1u); // 批内去重后 pk 只查询一次
+}
+
+// 取负只改 X 与 T：与 (order - 1) * P 一致，射影输入（Z != 1）下减法与加负元一致
+TEST_F(FourQTest, PointNegateNoScalarMul) {
+    Curve::FourQ::Scalar minus_one = Curve::FourQ::Scalar::negate(s_one);
+    Curve::FourQ::Point P = p_known + p_base; // 射影坐标
+    ASSERT_FALSE(P.isNormalized());
+
+    Curve::FourQ::Point negP = Curve::FourQ::Point::negate(P);
+    EXPECT_EQ(negP, minus_one * P);
+    EXPECT_EQ(negP.getRaw(), (minus_one * P).getRaw());
+    EXPECT_EQ(-P, negP);
+    EXPECT_EQ(Curve::FourQ::Point::negate(negP).getRaw(), P.getRaw());
+
+    // 单位元取负后编码不变（X 为 0 而不是 p）
+    Curve::FourQ::Point Z = Curve::FourQ::Point::negate(Curve::FourQ::Point::getZero());
+    EXPECT_EQ(Z.getRaw(), Curve::FourQ::Point::getZero().getRaw());
+    Curve::FourQ::Point Z2 = -(P - P);
+    EXPECT_TRUE(Z2.isZero());
+    EXPECT_EQ(Z2.getRaw(), Curve::FourQ::Point::getZero().getRaw());
+
+    // 减法：P - Q == P + (-Q) == (a - b) * G
+    Curve::FourQ::Scalar a(12345), b(678);
+    Curve::FourQ::Point A = Curve::FourQ::Point::mulBase(a);
+    Curve::FourQ::Point B = Curve::FourQ::Point::mulBase(b);
+    EXPECT_EQ(A - B, A + (-B));
+    EXPECT_EQ((A - B).getRaw(), Curve::FourQ::Point::mulBase(a - b).getRaw());
+    EXPECT_EQ((B - A).getRaw(), Curve::FourQ::Point::mulBase(b - a).getRaw());
+    EXPECT_EQ((A - Curve::FourQ::Point::getZero()).getRaw(), A.getRaw());
+    EXPECT_EQ((Curve::FourQ::Point::getZero() - A).getRaw(), (-A).getRaw());
+
+    // 连续累加/累减回到起点
+    Curve::FourQ::Point acc = P;
+    for (int i = 0; i < 16; i++) {
+        acc -= B;
+    }
+    for (int i = 0; i < 16; i++) {
+        acc += B;
+    }
+    EXPECT_EQ(acc.getRaw(), P.getRaw());
+}
+
+// 倍点与缓存加数：dbl() 与 P + P 一致；R2 形式与仿射（混合加法）形式的加减都与普通加减一致
+TEST_F(FourQTest, PointDoubleAndAddendCache) {
+    Curve::FourQ::Point P = p_known + p_base; // 射影坐标
+    Curve::FourQ::Point D = P;
+    D.dbl();
+    EXPECT_EQ(D, P + P);
+    EXPECT_EQ(D.getRaw(), (Curve::FourQ::Scalar(2) * P).getRaw());
+    Curve::FourQ::Point Z;
+    EXPECT_TRUE(Z.dbl().isZero());
+
+    Curve::FourQ::Point Q = Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(777)) + p_base; // Z != 1
+    ASSERT_FALSE(Q.isNormalized());
+    Curve::FourQ::AddendCache r2(Q);
+    Curve::FourQ::AddendCache mixed = Curve::FourQ::AddendCache::affine(Q);
+    EXPECT_FALSE(r2.isMixed());
+    EXPECT_TRUE(mixed.isMixed());
+    EXPECT_TRUE(Curve::FourQ::AddendCache(p_base).isMixed()); // 已规范化的点直接用仿射形式
+
+    Curve::FourQ::Point a = P, b = P;
+    a += r2;
+    b += mixed;
+    EXPECT_EQ(a, P + Q);
+    EXPECT_EQ(b, P + Q);
+    a -= r2;
+    b -= mixed;
+    EXPECT_EQ(a.getRaw(), P.getRaw());
+    EXPECT_EQ(b.getRaw(), P.getRaw());
+
+    // 单位元作为加数、以及 Q - Q
+    Curve::FourQ::Point c = P;
+    c += Curve::FourQ::AddendCache();
+    EXPECT_EQ(c, P);
+    Curve::FourQ::Point d = Q;
+    d -= mixed;
+    EXPECT_TRUE(d.isZero());
+
+    // 批量构造（共享一次求逆）：Pedersen 式累加
+    Curve::FourQ::Points gens;
+    for (uint32_t i = 1; i <= 8; i++) {
+        gens.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i)) + p_known);
+    }
+    std::vector<Curve::FourQ::AddendCache> cached = Curve::FourQ::AddendCache::affineBatch(gens);
+    ASSERT_EQ(cached.size(), gens.size());
+    Curve::FourQ::Point acc, ref;
+    for (int round = 0; round < 3; round++) {
+        for (size_t i = 0; i < gens.size(); i++) {
+            EXPECT_TRUE(cached[i].isMixed());
+            acc += cached[i];
+            ref += gens[i];
+        }
+    }
+    EXPECT_EQ(acc.getRaw(), ref.getRaw());
+    EXPECT_TRUE(Curve::FourQ::AddendCache::affineBatch({}).empty());
+}
+
+// SoA 容器：PointBatch 以仿射坐标按分量存放（64 字节/点），ScalarBatch 按字存放；批量接口直接接受它们
+TEST_F(FourQTest, PointBatchAndScalarBatch) {
+    static_assert(std::is_trivially_copyable_v<Curve::FourQ::Point>);
+    static_assert(std::is_trivially_copyable_v<Curve::FourQ::Scalar>);
+
+    // 自加（&that == this）不再依赖防御性拷贝
+    Curve::FourQ::Point self = p_known + p_base;
+    Curve::FourQ::Point twice = self;
+    twice.dbl();
+    self += self;
+    EXPECT_EQ(self, twice);
+    self -= self;
+    EXPECT_TRUE(self.isZero());
+
+    const size_t n = 21; // 不是 kLanes 的倍数
+    Curve::FourQ::Points ps;
+    Curve::FourQ::Scalars ks;
+    for (uint32_t i = 0; i < n; i++) {
+        ps.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i + 3)) + p_known); // 射影坐标
+        Curve::FourQ::EccDataType kx;
+        ::random_bytes(kx.data(), 32);
+        ks.emplace_back(kx);
+    }
+
+    Curve::FourQ::PointBatch pb(ps);
+    ASSERT_EQ(pb.size(), n);
+    EXPECT_EQ(pb.stride() % Curve::FourQ::PointBatch::kLanes, 0u);
+    for (unsigned j = 0; j < Curve::FourQ::PointBatch::kLimbs; j++) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pb.limb(j)) % Curve::FourQ::PointBatch::kAlignment, 0u);
+    }
+    std::vector<Curve::FourQ::EccDataType> raw(n);
+    pb.encodeAll(raw);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(raw[i], ps[i].getRaw());
+        EXPECT_EQ(pb.getRaw(i), ps[i].getRaw());
+        EXPECT_TRUE(pb.get(i).isNormalized());
+        EXPECT_EQ(pb.get(i), ps[i]);
+    }
+    // 填充位为单位元 (0, 1)
+    for (size_t i = n; i < pb.stride(); i++) {
+        EXPECT_EQ(pb.limb(0)[i], 0u);
+        EXPECT_EQ(pb.limb(4)[i], 1u);
+    }
+
+    // 从编码构造、追加与 set
+    Curve::FourQ::PointBatch decoded;
+    decoded.assignEncoded(raw);
+    EXPECT_EQ(decoded.get(7), ps[7]);
+    Curve::FourQ::EccDataType bad{};
+    bad[0] = 2;
+    std::vector<Curve::FourQ::EccDataType> with_bad = raw;
+    with_bad[5] = bad;
+    EXPECT_THROW(decoded.assignEncoded(with_bad), std::runtime_error);
+    EXPECT_EQ(decoded.size(), n); // 失败时保持不变
+    decoded.append(ps);
+    ASSERT_EQ(decoded.size(), 2 * n);
+    EXPECT_EQ(decoded.get(n + 2), ps[2]);
+    decoded.set(0, p_base);
+    EXPECT_EQ(decoded.getRaw(0), p_base.getRaw());
+    Curve::FourQ::Points back(decoded.size());
+    decoded.toPoints(back);
+    EXPECT_EQ(back[n + 20], ps[20]);
+    EXPECT_THROW(decoded.toPoints(ps), std::invalid_argument);
+    decoded.clear();
+    EXPECT_TRUE(decoded.empty());
+    EXPECT_EQ(decoded.limb(4)[0], 1u);
+
+    Curve::FourQ::ScalarBatch sb(ks);
+    ASSERT_EQ(sb.size(), n);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(sb.get(i), ks[i]);
+    }
+    EXPECT_EQ(sb.limb(0)[n], 0u);
+
+    // MultiMul 与 span 版本一致
+    EXPECT_EQ(Curve::FourQ::MultiMul(sb, pb), Curve::FourQ::Point::MultiMul(ks, ps));
+    EXPECT_THROW(Curve::FourQ::MultiMul(Curve::FourQ::ScalarBatch(std::span(ks).first(3)), pb), std::invalid_argument);
+
+    // 批量验签
+    std::vector<Curve::FourQ::Point> pks;
+    std::vector<std::string> msgs;
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    std::vector<std::span<const uint8_t>> spans;
+    for (size_t i = 0; i < n; i++) {
+        pks.push_back(Curve::FourQ::Point::mulBase(ks[i]));
+        msgs.push_back("soa message #" + std::to_string(i));
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(ks[i], msgs[i], sigs[i]));
+    }
+    for (const auto& m : msgs) {
+        spans.emplace_back(reinterpret_cast<const uint8_t*>(m.data()), m.size());
+    }
+    Curve::FourQ::PointBatch pkb(pks);
+    std::vector<bool> results;
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pkb, spans, sigs, results));
+    sigs[4][40] ^= 0x01;
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerifyBatch(pkb, spans, sigs, results));
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(results[i], i != 4) << "index " << i;
+    }
+    EXPECT_THROW(Curve::FourQ::SchnorrQVerifyBatch(pkb, std::span(spans).first(2), sigs), std::invalid_argument);
+}
+
+TEST_F(FourQTest, PointBatchLanes) {
+    const size_t n = 27; // 8 路分 3 组余 3，4 路分 6 组余 3
+    Curve::FourQ::Points acc, addends;
+    for (uint32_t i = 0; i < n; i++) {
+        acc.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(i + 5)) + p_known); // 射影坐标
+        addends.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(3 * i + 1)));
+    }
+    // 特殊情况：单位元作加数、单位元作累加器、P + (-P)、点加自身
+    addends[1] = Curve::FourQ::Point();
+    acc[2] = Curve::FourQ::Point();
+    addends[3] = -acc[3];
+    addends[9] = acc[9];
+    const Curve::FourQ::PointBatch batch(addends);
+
+    // 参考结果：逐点走 FourQlib
+    Curve::FourQ::Points sums(n), doubled(n);
+    for (size_t i = 0; i < n; i++) {
+        sums[i] = acc[i] + addends[i];
+        doubled[i] = sums[i];
+        doubled[i].dbl().dbl().dbl();
+    }
+
+    const Curve::FourQ::LaneBackend original = Curve::FourQ::laneBackend();
+    EXPECT_TRUE(Curve::FourQ::laneBackendSupported(original));
+    EXPECT_TRUE(Curve::FourQ::laneBackendSupported(Curve::FourQ::LaneBackend::Scalar));
+    for (Curve::FourQ::LaneBackend backend : {Curve::FourQ::LaneBackend::Scalar, Curve::FourQ::LaneBackend::AVX2,
+             Curve::FourQ::LaneBackend::AVX512IFMA}) {
+        if (!Curve::FourQ::setLaneBackend(backend)) {
+            EXPECT_FALSE(Curve::FourQ::laneBackendSupported(backend));
+            continue;
+        }
+        SCOPED_TRACE(Curve::FourQ::laneBackendName());
+        Curve::FourQ::Points pts = acc;
+        Curve::FourQ::addAll(pts, batch);
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(pts[i], sums[i]) << "index " << i;
+            EXPECT_EQ(pts[i].getRaw(), sums[i].getRaw()) << "index " << i;
+        }
+        EXPECT_TRUE(pts[3].isZero());
+        Curve::FourQ::doubleAll(pts, 3);
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(pts[i], doubled[i]) << "index " << i;
+        }
+        // 结果可以继续交给 FourQlib 运算
+        EXPECT_EQ(pts[5] - doubled[5] + p_base, p_base);
+        Curve::FourQ::doubleAll(pts, 0);
+        EXPECT_EQ(pts[7], doubled[7]);
+        EXPECT_THROW(Curve::FourQ::addAll(std::span(pts).first(5), batch), std::invalid_argument);
+    }
+    EXPECT_TRUE(Curve::FourQ::setLaneBackend(original));
+    EXPECT_EQ(Curve::FourQ::laneBackend(), original);
+}
+
+// 编译期标量运算：常量在编译期折叠，结果与运行期的 FourQlib 运算一致
+TEST_F(FourQTest, ScalarConstexpr) {
+    using Curve::FourQ::Scalar;
+    constexpr Scalar a(123456789), b(987654321);
+    constexpr Scalar sum = a + b, diff = a - b, prod = a * b;
+    static_assert(Scalar::kOrderMinusOne + Scalar::kOne == Scalar::kZero);
+    static_assert(Scalar::kTwo * Scalar::kOrderMinusOne == Scalar::negate(Scalar::kTwo));
+    static_assert(a - a == Scalar::getZero() && prod == b * a);
+    static_assert(Scalar::fromWords({5, 0, 0, 0}) == Scalar(5));
+
+    Scalar ra = a, rb = b; // 运行期路径
+    EXPECT_EQ(ra + rb, sum);
+    EXPECT_EQ(ra - rb, diff);
+    EXPECT_EQ(ra * rb, prod);
+    EXPECT_EQ(Scalar::negate(ra), Scalar::kZero - a);
+    EXPECT_EQ(Scalar::kOrderMinusOne + Scalar(1), Scalar()); // 表头的群阶与 FourQlib 一致
+    EXPECT_TRUE(Scalar(Curve::FourQ::Point::getOrder().getRaw()).isZero());
+
+    constexpr Scalar big = Scalar::fromWords({~0ull, ~0ull, ~0ull, ~0ull});
+    Curve::FourQ::EccDataType ff;
+    ff.fill(0xFF);
+    EXPECT_EQ(big, Scalar(ff));
+
+    // 随机值：detail::ct 与运行期运算逐一比较
+    for (int i = 0; i < 32; i++) {
+        const Scalar x = Scalar::random(), y = Scalar::random();
+        Curve::FourQ::fourq_scalar_t wx, wy;
+        const Curve::FourQ::EccDataType bx = x.getRaw(), by = y.getRaw();
+        std::memcpy(wx.data(), bx.data(), 32);
+        std::memcpy(wy.data(), by.data(), 32);
+        EXPECT_EQ(Scalar::fromWords(Curve::FourQ::detail::ct::mul_mod(wx, wy)), x * y);
+        EXPECT_EQ(Scalar::fromWords(Curve::FourQ::detail::ct::add_mod(wx, wy)), x + y);
+        EXPECT_EQ(Scalar::fromWords(Curve::FourQ::detail::ct::sub_mod(wx, wy)), x - y);
+        EXPECT_EQ(Scalar::fromWords(Curve::FourQ::detail::ct::reduce(wx)), x);
+    }
+}
+
+// MontScalar 常量可在编译期转换；生成元与单位元为常量，不再调用 eccset/point_setup
+TEST_F(FourQTest, CurveConstants) {
+    using Curve::FourQ::MontScalar;
+    using Curve::FourQ::Scalar;
+    constexpr MontScalar m3{Scalar(3)};
+    constexpr MontScalar m1 = MontScalar::one();
+    static_assert(m1 != MontScalar() && m3 != m1);
+    Scalar r3 = Scalar(3), r1 = Scalar::kOne;
+    EXPECT_EQ(m3, MontScalar(r3));
+    EXPECT_EQ(m1, MontScalar(r1));
+    EXPECT_EQ(m1.toScalar(), Scalar::kOne);
+    EXPECT_EQ((m3 * m3).toScalar(), Scalar(9));
+
+    constexpr Curve::FourQ::Point g = Curve::FourQ::Point::getBase();
+    constexpr Curve::FourQ::Point zero;
+    EXPECT_TRUE(g.isNormalized());
+    EXPECT_TRUE(zero.isZero());
+    EXPECT_EQ(Curve::FourQ::Point::getZero(), zero);
+    point_t G;
+    eccset(G);
+    point_extproj_t R;
+    point_setup(G, R);
+    EXPECT_EQ(std::memcmp(&g, R, sizeof(point_extproj)), 0);
+    EXPECT_EQ(g.getRaw(), Curve::FourQ::Point::mulBase(Scalar::kOne).getRaw());
+    EXPECT_EQ(g, p_base);
+}
+
+// 密钥库测试文件路径：每个进程带随机后缀，ctest -j 下 run_fourq_tests 与 .alt_endo 不会互相覆盖
+static std::string keyStoreTempPath(const char* name) {
+    static const std::string tag = [] {
+        std::array<uint8_t, 8> r{};
+        Curve::FourQ::randomBytes(r);
+        char hex[17];
+        for (size_t i = 0; i < r.size(); i++) {
+            std::snprintf(hex + 2 * i, 3, "%02x", r[i]);
+        }
+        return std::string(hex);
+    }();
+    return ::testing::TempDir() + "fastecc_keystore_" + tag + "_" + name + ".bin";
+}
+
+// 密钥库：三种格式写入后经 mmap 读回，跨越多个校验分块
+TEST_F(FourQTest, KeyStoreRoundTrip) {
+    using Curve::FourQ::KeyStore;
+    using Curve::FourQ::KeyStoreFormat;
+    using Curve::FourQ::KeyStoreVerify;
+    const size_t n = KeyStore::kChunkRecords + 37;
+    std::vector<Curve::FourQ::Point> points(n);
+    Curve::FourQ::Point acc = p_known;
+    for (size_t i = 0; i < n; i++) {
+        points[i] = acc; // 多数 Z != 1
+        acc += p_base;
+    }
+    points[0] = Curve::FourQ::Point(); // 单位元
+    std::vector<Curve::FourQ::EccDataType> raw(n);
+    Curve::FourQ::encodeAll(points, raw);
+
+    const std::string path = keyStoreTempPath("roundtrip");
+    for (KeyStoreFormat format : {KeyStoreFormat::Compressed, KeyStoreFormat::Affine, KeyStoreFormat::Precomputed}) {
+        SCOPED_TRACE((int)format);
+        KeyStore::write(path, points, format, 3);
+        for (KeyStoreVerify verify : {KeyStoreVerify::Header, KeyStoreVerify::Digest, KeyStoreVerify::Full}) {
+            KeyStore store(path, verify, 4);
+            ASSERT_EQ(store.size(), n);
+            EXPECT_EQ(store.format(), format);
+        }
+        KeyStore store(path);
+        for (size_t i : {(size_t)0, (size_t)1, (size_t)4095, (size_t)4096, n - 1}) {
+            const Curve::FourQ::PointView view = store[i];
+            EXPECT_EQ(view.bytes().size(), KeyStore::recordSize(format));
+            EXPECT_EQ(view.encoding(), raw[i]);
+            EXPECT_TRUE(view.point().isNormalized());
+            EXPECT_EQ(view.point(), points[i]);
+            Curve::FourQ::Point sum = p_base;
+            sum += view.addend();
+            EXPECT_EQ(sum, p_base + points[i]);
+        }
+        EXPECT_THROW(store.at(n), std::out_of_range);
+
+        const std::vector<Curve::FourQ::Point> loaded = store.loadAll(4);
+        ASSERT_EQ(loaded.size(), n);
+        std::vector<Curve::FourQ::EccDataType> reencoded(n);
+        Curve::FourQ::encodeAll(loaded, reencoded);
+        EXPECT_EQ(reencoded, raw);
+        std::vector<Curve::FourQ::Point> wrong(n - 1);
+        EXPECT_THROW(store.loadAll(wrong), std::invalid_argument);
+
+        KeyStore moved = std::move(store);
+        EXPECT_EQ(moved[5].encoding(), raw[5]);
+        EXPECT_EQ(store.size(), 0u);
+    }
+
+    // 空集合
+    KeyStore::write(path, std::span<const Curve::FourQ::Point>(), KeyStoreFormat::Affine);
+    KeyStore empty(path, KeyStoreVerify::Full);
+    EXPECT_EQ(empty.size(), 0u);
+    EXPECT_TRUE(empty.loadAll().empty());
+    std::remove(path.c_str());
+}
+
+// 完整性检查：截断、改动数据或头部、错误魔数都会在打开时被拒绝
+TEST_F(FourQTest, KeyStoreIntegrity) {
+    using Curve::FourQ::KeyStore;
+    using Curve::FourQ::KeyStoreFormat;
+    using Curve::FourQ::KeyStoreVerify;
+    std::vector<Curve::FourQ::Point> points;
+    Curve::FourQ::Point acc = p_base;
+    for (int i = 0; i < 100; i++) {
+        points.push_back(acc);
+        acc += p_known;
+    }
+    const std::string path = keyStoreTempPath("integrity");
+    const std::string bad = keyStoreTempPath("bad");
+    KeyStore::write(path, points, KeyStoreFormat::Affine);
+
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> good((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    auto write_bad = [&](const std::vector<char>& bytes) {
+        std::ofstream out(bad, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), (std::streamsize)bytes.size());
+    };
+
+    // 数据区翻转一位：头部校验通过，分块摘要失败
+    std::vector<char> bytes = good;
+    bytes[bytes.size() - 10] ^= 1;
+    write_bad(bytes);
+    EXPECT_NO_THROW(KeyStore(bad, KeyStoreVerify::Header));
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Digest), std::runtime_error);
+
+    // 头部字段被改动
+    bytes = good;
+    bytes[16] ^= 1; // count
+    write_bad(bytes);
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Header), std::runtime_error);
+    bytes = good;
+    bytes[100] ^= 1; // 保留字段
+    write_bad(bytes);
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Header), std::runtime_error);
+
+    // 截断与错误魔数
+    bytes = good;
+    bytes.resize(bytes.size() - 64);
+    write_bad(bytes);
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Header), std::runtime_error);
+    bytes.resize(100);
+    write_bad(bytes);
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Header), std::runtime_error);
+    bytes = good;
+    bytes[0] = 'X';
+    write_bad(bytes);
+    EXPECT_THROW(KeyStore(bad, KeyStoreVerify::Header), std::runtime_error);
+    EXPECT_THROW(KeyStore(keyStoreTempPath("missing")), std::runtime_error);
+
+    EXPECT_NO_THROW(KeyStore(path, KeyStoreVerify::Full));
+    std::remove(path.c_str());
+    std::remove(bad.c_str());
+}
+
+// 朴素参考实现：逐项标量乘再相加
+static Curve::FourQ::Point NaiveMultiMul(const Curve::FourQ::Scalars& ks, const Curve::FourQ::Points& ps) {
+    Curve::FourQ::Point acc;
+    for (size_t i = 0; i < ks.size(); ++i) {
+        acc += ks[i] * ps[i];
+    }
+    return acc;
+}
+
+TEST_F(FourQTest, PointMultiMul) {
+    // 覆盖 Straus（小规模）与 Pippenger（大规模）两条路径
+    for (size_t n : {size_t(0), size_t(1), size_t(2), size_t(7), size_t(40), size_t(130)}) {
+        Curve::FourQ::Scalars ks;
+        Curve::FourQ::Points ps;
+        for (size_t i = 0; i < n; ++i) {
+            Curve::FourQ::EccDataType raw;
+            ::random_bytes(raw.data(), 32);
+            ks.emplace_back(raw);
+            ps.push_back(Curve::FourQ::Point::mulBase(Curve::FourQ::Scalar(static_cast<uint32_t>(i * 7919 + 3))));
+        }
+        if (n >= 7) {
+            // 零标量、单位元、重复点、互为相反数的点、小标量
+            ks[1] = Curve::FourQ::Scalar::getZero();
+            ps[2] = Curve::FourQ::Point::getZero();
+            ps[3] = ps[4];
+            ps[5] = Curve::FourQ::Point::negate(ps[6]);
+            ks[5] = ks[6];
+            ks[4] = Curve::FourQ::Scalar(1);
+        }
+        Curve::FourQ::Point expected = NaiveMultiMul(ks, ps);
+        Curve::FourQ::Point actual = Curve::FourQ::Point::MultiMul(ks, ps);
+        EXPECT_EQ(actual.getRaw(), expected.getRaw()) << "n = " << n;
+    }
+
+    // 最大标量（order - 1）与负数系数
+    Curve::FourQ::Scalars ks = {Curve::FourQ::Scalar::negate(Curve::FourQ::Scalar(1)), Curve::FourQ::Scalar(2)};
+    Curve::FourQ::Points ps = {p_known, p_known};
+    EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, ps).getRaw(), p_known.getRaw());
+
+    EXPECT_THROW(Curve::FourQ::Point::MultiMul(ks, std::span(ps).first(1)), std::invalid_argument);
+}
+
+// 并行 Pippenger：结果与单线程一致，且不依赖任务的执行顺序与线程
+TEST_F(FourQTest, PointMultiMulParallel) {
+    // 自定义执行器：在调用线程上逆序执行，模拟外部调度器
+    Curve::FourQ::Executor reversed_;
+    reversed_.concurrency = 3;
+    reversed_.run = [](size_t n, const std::function<void(size_t)>& task) {
+        for (size_t i = n; i-- > 0;) {
+            task(i);
+        }
+    };
+    const Curve::FourQ::Executor& reversed = reversed_;
+    const Curve::FourQ::Executor pool = Curve::FourQ::Executor::threads(4);
+
+    const size_t n = Curve::FourQ::detail::kParallelMsmThreshold + 300;
+    Curve::FourQ::Scalars ks(n);
+    Curve::FourQ::Points ps(n);
+    Curve::FourQ::Point acc = p_known;
+    for (size_t i = 0; i < n; ++i) {
+        Curve::FourQ::EccDataType raw;
+        ::random_bytes(raw.data(), 32);
+        ks[i] = Curve::FourQ::Scalar(raw);
+        ps[i] = acc;
+        acc += p_base;
+    }
+    ks[1] = Curve::FourQ::Scalar::getZero();
+    ps[2] = Curve::FourQ::Point::getZero();
+    ks[3] = Curve::FourQ::Scalar::kOrderMinusOne;
+
+    auto as_words = [](std::span<const Curve::FourQ::Scalar> k) {
+        return std::span<const Curve::FourQ::fourq_scalar_t>(reinterpret_cast<const Curve::FourQ::fourq_scalar_t*>(k.data()), k.size());
+    };
+    auto as_points = [](std::span<const Curve::FourQ::Point> p) {
+        return std::span<const point_extproj>(reinterpret_cast<const point_extproj*>(p.data()), p.size());
+    };
+    for (size_t m : {size_t(0), size_t(1), size_t(5), size_t(200), size_t(2500)}) {
+        const std::span<const Curve::FourQ::Scalar> k = std::span(ks).first(m);
+        const std::span<const Curve::FourQ::Point> p = std::span(ps).first(m);
+        const Curve::FourQ::Point expected = Curve::FourQ::Point::MultiMul(k, p);
+        for (const Curve::FourQ::Executor* executor : {&reversed, &pool}) {
+            Curve::FourQ::Point actual;
+            Curve::FourQ::detail::multi_mul_parallel(as_words(k), as_points(p), reinterpret_cast<point_extproj*>(&actual), *executor);
+            EXPECT_EQ(actual, expected) << "m = " << m;
+        }
+    }
+
+    // 公共入口：超过阈值时走并行路径，单线程执行器退回串行路径
+    const Curve::FourQ::Point expected = Curve::FourQ::Point::MultiMul(ks, ps);
+    EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, ps, pool), expected);
+    EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, ps, reversed), expected);
+    EXPECT_EQ(Curve::FourQ::Point::MultiMul(ks, ps, Curve::FourQ::Executor{}), expected);
+    EXPECT_THROW(Curve::FourQ::Point::MultiMul(ks, std::span(ps).first(n - 1), pool), std::invalid_argument);
+
+    // 内置执行器：每个任务恰好执行一次，任务抛出的异常传回调用方
+    std::vector<std::atomic<int>> hits(1000);
+    pool.run(hits.size(), [&](size_t i) { hits[i]++; });
+    EXPECT_TRUE(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }));
+    EXPECT_THROW(pool.run(10, [](size_t i) {
+        if (i == 7) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+
+    // 常驻工作线程：多次 run（含副本）始终只用同一组线程（4 个，含调用线程），不为每次调用新建线程
+    const Curve::FourQ::Executor copy = pool;
+    std::mutex ids_mutex;
+    std::vector<std::thread::id> ids;
+    for (int round = 0; round < 20; round++) {
+        const Curve::FourQ::Executor& e = round % 2 == 0 ? pool : copy;
+        e.run(64, [&](size_t) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            std::lock_guard<std::mutex> lock(ids_mutex);
+            if (std::find(ids.begin(), ids.end(), std::this_thread::get_id()) == ids.end()) {
+                ids.push_back(std::this_thread::get_id());
+            }
+        });
+    }
+    EXPECT_LE(ids.size(), 4u);
+    EXPECT_EQ(pool.concurrency, 4u);
+
+    // 任务内嵌套 run 在当前线程内联执行；两个线程同时 run 依次进行，结果都完整
+    std::atomic<size_t> nested{0};
+    pool.run(8, [&](size_t) {
+        const std::thread::id self = std::this_thread::get_id();
+        pool.run(4, [&](size_t) {
+            EXPECT_EQ(std::this_thread::get_id(), self);
+            nested++;
+        });
+    });
+    EXPECT_EQ(nested, 32u);
+    std::atomic<size_t> total{0};
+    std::thread other([&] { copy.run(500, [&](size_t) { total++; }); });
+    pool.run(500, [&](size_t) { total++; });
+    other.join();
+    EXPECT_EQ(total, 1000u);
+}
+
+TEST_F(FourQTest, SchnorrQVerifyBatch) {
+    const size_t n = 16;
+    std::vector<Curve::FourQ::Point> pks;
+    std::vector<std::string> msgs;
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        Curve::FourQ::EccDataType skx;
+        ::random_bytes(skx.data(), 32);
+        Curve::FourQ::Scalar sk(skx);
+        pks.push_back(Curve::FourQ::Point::mulBase(sk));
+        msgs.push_back("batch message #" + std::to_string(i));
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(sk, msgs[i], sigs[i]));
+    }
+
+    std::vector<std::span<const uint8_t>> msg_spans;
+    for (const auto& m : msgs) {
+        msg_spans.emplace_back(reinterpret_cast<const uint8_t*>(m.data()), m.size());
+    }
+
+    std::vector<bool> results;
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(pks, msg_spans, sigs, results));
+    EXPECT_EQ(results, std::vector<bool>(n, true));
+
+    // 篡改一个 s、一个 R、一个格式非法的签名，以及交换两个公钥：批量失败并定位坏签名
+    auto bad_sigs = sigs;
+    bad_sigs[3][40] ^= 0x01;
+    bad_sigs[7][0] ^= 0x01;
+    bad_sigs[9][63] = 0x01;
+    auto bad_pks = pks;
+    std::swap(bad_pks[12], bad_pks[13]);
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerifyBatch(bad_pks, msg_spans, bad_sigs, results));
+    for (size_t i = 0; i < n; ++i) {
+        bool expected_ok = (i != 3 && i != 7 && i != 9 && i != 12 && i != 13);
+        EXPECT_EQ(results[i], expected_ok) << "index " << i;
+        EXPECT_EQ(results[i], Curve::FourQ::SchnorrQVerify(bad_pks[i], msgs[i], bad_sigs[i])) << "index " << i;
+    }
+
+    // 只有格式非法的签名时，其余签名仍通过批量校验
+    bad_sigs = sigs;
+    bad_sigs[5][63] = 0x01;
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerifyBatch(pks, msg_spans, bad_sigs, results));
+    EXPECT_FALSE(results[5]);
+    EXPECT_EQ(std::count(results.begin(), results.end(), true), static_cast<long>(n - 1));
+
+    // 单个签名与空批量
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch(std::span(pks).first(1), std::span(msg_spans).first(1), std::span(sigs).first(1)));
+    EXPECT_TRUE(Curve::FourQ::SchnorrQVerifyBatch({}, {}, {}));
+
+    // 长度不一致
+    EXPECT_THROW(Curve::FourQ::SchnorrQVerifyBatch(pks, std::span(msg_spans).first(n - 1), sigs), std::invalid_argument);
+}
+
+TEST_F(FourQTest, SchnorrQVerifyBatchTorsion) {
+    const Curve::FourQ::Point T = smallOrderPoint(7);
+    EXPECT_FALSE(T.isZero());
+    Curve::FourQ::EccDataType seven{};
+    seven[0] = 7;
+    EXPECT_TRUE(plainMul(T, seven).isZero());
+
+    const size_t n = 8;
+    std::vector<Curve::FourQ::Point> pks;
+    std::vector<std::string> msgs;
+    std::vector<std::array<uint8_t, 64>> sigs(n);
+    std::vector<Curve::FourQ::Scalar> keys;
+    for (size_t i = 0; i < n; ++i) {
+        Curve::FourQ::EccDataType skx;
+        ::random_bytes(skx.data(), 32);
+        keys.emplace_back(skx);
+        pks.push_back(Curve::FourQ::Point::mulBase(keys[i]));
+        msgs.push_back("torsion message #" + std::to_string(i));
+        ASSERT_TRUE(Curve::FourQ::SchnorrQSign(keys[i], msgs[i], sigs[i]));
+    }
+    std::vector<std::span<const uint8_t>> msg_spans;
+    for (const auto& m : msgs) {
+        msg_spans.emplace_back(reinterpret_cast<const uint8_t*>(m.data()), m.size());
+    }
+
+    // 批内只有一个带 7 阶分量的 R：z 模 7 可逆，组合校验每次都失败（此前约 1/7 的概率放行）
+    sigs[2] = torsionSignature(keys[2], T, msg_spans[2]);
+    EXPECT_FALSE(Curve::FourQ::SchnorrQVerify(pks[2], msgs[2], sigs[2]));
+    std::vector<bool> results;
+    for (int round = 0; round < 32; ++round) {
+        EXPECT_FALSE(Curve::FourQ::SchnorrQVerifyBatch(pks, msg_spans, sigs, results)) << "round " << round;
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(results[i], i != 2) << "round " << round << " index " << i;
+        }
+    }
+}
+
 // --- Main function for running tests ---
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
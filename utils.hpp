@@ -1,22 +1,81 @@
 #pragma once
 
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>   // For std::data, std::size
+#include <span>
 #include <string>
-#include <sstream>
-#include <iomanip>
-#include <charconv>
+#include <string_view>
 #include <stdexcept>
-#include <system_error>
+#include <vector>
 //#include <iostream> // DEBUG
 
+// --- Allocation-free hex codecs ---
+// Table-driven, lowercase output, either case accepted on input. With reversed = true the
+// bytes are taken (or stored) last to first, which is how Point::toString orders them.
+
+namespace hex_detail {
+
+constexpr char kDigits[] = "0123456789abcdef";
+
+constexpr std::array<int8_t, 256> make_decode_table() {
+    std::array<int8_t, 256> t{};
+    for (auto& v : t) {
+        v = -1;
+    }
+    for (int c = 0; c < 10; c++) {
+        t['0' + c] = (int8_t)c;
+    }
+    for (int c = 0; c < 6; c++) {
+        t['a' + c] = (int8_t)(10 + c);
+        t['A' + c] = (int8_t)(10 + c);
+    }
+    return t;
+}
+
+inline constexpr std::array<int8_t, 256> kDecode = make_decode_table();
+
+} // namespace hex_detail
+
+// Writes 2*in.size() hex digits to out (no terminator) and returns that count.
+// Throws std::invalid_argument if out is too short.
+inline size_t hex_encode(std::span<const uint8_t> in, std::span<char> out, bool reversed = false) {
+    const size_t n = in.size();
+    if (out.size() < 2 * n) {
+        throw std::invalid_argument("hex_encode: output buffer too small");
+    }
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t b = in[reversed ? n - 1 - i : i];
+        out[2 * i] = hex_detail::kDigits[b >> 4];
+        out[2 * i + 1] = hex_detail::kDigits[b & 0x0F];
+    }
+    return 2 * n;
+}
+
+// Parses exactly 2*out.size() hex digits into out. Returns false, with out unspecified,
+// if the length is wrong or a character is not a hex digit.
+inline bool hex_decode(std::string_view hex, std::span<uint8_t> out, bool reversed = false) {
+    const size_t n = out.size();
+    if (hex.size() != 2 * n) {
+        return false;
+    }
+    int bad = 0;
+    for (size_t i = 0; i < n; i++) {
+        const int hi = hex_detail::kDecode[(unsigned char)hex[2 * i]];
+        const int lo = hex_detail::kDecode[(unsigned char)hex[2 * i + 1]];
+        bad |= hi | lo; // Negative if either is invalid
+        out[reversed ? n - 1 - i : i] = (uint8_t)((hi << 4) | (lo & 0x0F));
+    }
+    return bad >= 0;
+}
+
 template<typename T>
 std::string bytes_to_hex_string(const T& bytes) {
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (auto b : bytes) {
-        oss << std::setw(2) << static_cast<int>(b);
-    }
-    return oss.str();
+    std::span<const uint8_t> in(reinterpret_cast<const uint8_t*>(std::data(bytes)), std::size(bytes));
+    std::string out(2 * in.size(), '\0');
+    hex_encode(in, out);
+    return out;
 }
 
 template<typename T>
@@ -25,24 +84,14 @@ size_t hex_string_to_bytes(const std::string& hex, T &out) {
         throw std::invalid_argument("Hex string must have an even number of characters");
     }
 
-    for (size_t i = 0; i < hex.length(); i += 2) {
-        uint8_t byte;
-        const char* first = hex.data() + i;
-        const char* last = hex.data() + i + 2;
-        auto result = std::from_chars(first, last, byte, 16);
-
-        if (result.ptr == first) {
-             throw std::invalid_argument("Invalid hex character encountered at beginning of pair at position " + std::to_string(i));
-        } else if (result.ec == std::errc::invalid_argument) {
-            throw std::invalid_argument("Invalid hex character reported by from_chars at position " + std::to_string(i));
-        } else if (result.ec != std::errc()) {
-            throw std::runtime_error("Unexpected error during hex conversion with error code " + std::to_string(static_cast<int>(result.ec)));
-        } else if (result.ptr != last) {
-            throw std::invalid_argument("Incomplete or invalid hex pair encountered at position " + std::to_string(i));
+    std::span<uint8_t> dst(reinterpret_cast<uint8_t*>(std::data(out)), hex.length() / 2);
+    if (!hex_decode(hex, dst)) {
+        // Slow path, only to report where the bad character is
+        size_t pos = 0;
+        while (pos < hex.length() && hex_detail::kDecode[(unsigned char)hex[pos]] >= 0) {
+            pos++;
         }
-
-        // If all checks pass, conversion of two chars was successful
-        out[i/2] = byte;
+        throw std::invalid_argument("Invalid hex character at position " + std::to_string(pos));
     }
     return hex.length() / 2;
 }